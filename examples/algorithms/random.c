@@ -29,4 +29,26 @@ int main(void)
     t = clock() - t;
     printf("biased 0-%d  \t: %f secs, %d, avg: %f\n",
            (int)range, (double)t/CLOCKS_PER_SEC, (int)N, (double)(sum/N));
+
+    printf("\nCompare speed of scalar and bulk generation...\n");
+    enum {BUF = 4096};
+    static uint64_t buf[BUF];
+    sum = 0;
+    t = clock();
+    for (c_range(N/BUF)) {
+        for (c_range(i, BUF))
+            buf[i] = crand64_uint_r(&rng, 1);
+        sum += (int32_t)buf[0];
+    }
+    t = clock() - t;
+    printf("crand64_uint_r\t\t: %f secs, %d\n", (double)t/CLOCKS_PER_SEC, (int)N);
+
+    t = clock();
+    for (c_range(N/BUF)) {
+        crand64_fill_r(&rng, 1, buf, BUF);
+        sum += (int32_t)buf[0];
+    }
+    t = clock() - t;
+    printf("crand64_fill_r\t\t: %f secs, %d\n", (double)t/CLOCKS_PER_SEC, (int)N);
+    (void)sum;
 }
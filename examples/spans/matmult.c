@@ -105,6 +105,18 @@ int main(void) {
 
     puts("checksum and time");
     printf("%.16g: %f ms\n", (double)sum, (double)t*1000.0/CLOCKS_PER_SEC);
+
+    // Packed, cache-blocked and SIMD multiply:
+    sum = 0.0;
+    t = clock();
+    for (c_range(i, N)) {
+        Mat b = cspan_submd3(&bvec, i);
+        cspan_matmul(&a, &b, &c);
+        sum += *cspan_at(&c, i+1, i+1);
+    }
+    t = clock() - t;
+    puts("cspan_matmul: checksum and time");
+    printf("%.16g: %f ms\n", (double)sum, (double)t*1000.0/CLOCKS_PER_SEC);
     Data_drop(&values);
     //Data_drop(&output);
 }
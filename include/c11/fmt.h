@@ -1,12 +1,22 @@
 #ifndef FMT_H_INCLUDED
 #define FMT_H_INCLUDED
 /*
-VER 2.3 API:
+VER 2.4 API:
 void        fmt_print(fmt, ...);
 void        fmt_println(fmt, ...);
 void        fmt_printd(dst, fmt, ...);
+void        fmt_cprint(fmt, ...);     // cached: fmt is translated once per call site.
+void        fmt_cprintln(fmt, ...);
+void        fmt_cprintd(dst, fmt, ...);
 const char* fmt_time(fmt, const struct tm* tm, char *buf, int len);
-void        fmt_close(fmt_stream* ss);
+fmt_buffer  fmt_buffer_file(FILE* fp, char* buf, intptr_t cap);
+fmt_buffer  fmt_buffer_fd(int fd, char* buf, intptr_t cap);
+fmt_buffer  fmt_buffer_sink(void (*write)(void* ctx, const char* s, intptr_t n), void* ctx,
+                            char* buf, intptr_t cap);
+void        fmt_flush(fmt_buffer* fb);
+void        fmt_close(fmt_stream* ss);  // or fmt_buffer* fb: flushes it.
+                                        // NB: fmt_close() is a _Generic macro, not a function:
+                                        // its address can no longer be taken.
 
   dst - destination, one of:
     FILE* fp        Write to a file
@@ -14,6 +24,15 @@ void        fmt_close(fmt_stream* ss);
     fmt_stream* ss  Write to a string-stream (auto allocated).
                     Set ss->overwrite=1 for overwrite-mode.
                     Call fmt_close(ss) after usage.
+    fmt_buffer* fb  Write to a fixed size buffer, which is flushed to a file, a file
+                    descriptor or a write function when full. buf may be NULL, and
+                    is then allocated with cap bytes (FMT_BUFSIZE if cap is 0). A
+                    caller-supplied buf requires cap > 0. Output is unbuffered
+                    if the allocation fails.
+                    Call fmt_close(fb) to flush and free it.
+
+  fmt_cprint*() translate the format string on the first call in each thread only,
+  so fmt must be the same string each time, e.g. a string literal.
 
   fmt - format string (const char*)
     {}              Auto-detected format. If :MOD is not specified,
@@ -58,6 +77,11 @@ int main(void) {
     fmt_print("{}, len={}, cap={}\n", ss->data, ss->len, ss->cap);
     fmt_close(ss);
 
+    fmt_buffer fb = fmt_buffer_file(stdout, NULL, 0);
+    for (int i = 0; i < 3; ++i)
+        fmt_cprintd(&fb, "Line {}: {:.3}\n", i, pi*i);
+    fmt_close(&fb);
+
     time_t now = time(NULL);
     struct tm t1 = *localtime(&now), t2 = t1;
     t2.tm_hour += 48;
@@ -84,6 +108,14 @@ typedef struct {
     _Bool overwrite;
 } fmt_stream;
 
+typedef struct {
+    char* data;
+    intptr_t cap, len;
+    void (*write)(void* ctx, const char* s, intptr_t n);
+    void* ctx;
+    _Bool owned;
+} fmt_buffer;
+
 #if defined FMT_STATIC || defined STC_STATIC || defined i_static
   #define FMT_API static
   #define FMT_DEF static
@@ -96,70 +128,86 @@ typedef struct {
 
 struct tm;
 FMT_API const char* fmt_time(const char *fmt, const struct tm* tm, char* buf, int len);
-FMT_API void        fmt_close(fmt_stream* ss);
+FMT_API fmt_buffer  fmt_buffer_file(FILE* fp, char* buf, intptr_t cap);
+FMT_API fmt_buffer  fmt_buffer_fd(int fd, char* buf, intptr_t cap);
+FMT_API fmt_buffer  fmt_buffer_sink(void (*write)(void* ctx, const char* s, intptr_t n), void* ctx,
+                                    char* buf, intptr_t cap);
+FMT_API void        fmt_flush(fmt_buffer* fb);
+FMT_API void       _fmt_close(fmt_stream* ss);
+FMT_API void       _fmt_close_buffer(fmt_buffer* fb);
 FMT_API int        _fmt_parse(char* p, int nargs, const char *fmt, ...);
 FMT_API void       _fmt_sprint(fmt_stream*, const char* fmt, ...);
+FMT_API void       _fmt_bprint(fmt_buffer*, const char* fmt, ...);
 
 #ifndef FMT_MAX
 #define FMT_MAX 128
 #endif
+#ifndef FMT_BUFSIZE
+#define FMT_BUFSIZE 8192
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  #define _fmt_thread_local __declspec(thread)
+#else
+  #define _fmt_thread_local _Thread_local
+#endif
 
 #define fmt_print(...) fmt_printd(stdout, __VA_ARGS__)
 #define fmt_println(...) fmt_printd((fmt_stream*)0, __VA_ARGS__)
-#define fmt_printd(...) c_MACRO_OVERLOAD(fmt_printd, __VA_ARGS__)
+#define fmt_printd(...) c_MACRO_OVERLOAD(_fmt_printd, 0, __VA_ARGS__)
+#define fmt_cprint(...) fmt_cprintd(stdout, __VA_ARGS__)
+#define fmt_cprintln(...) fmt_cprintd((fmt_stream*)0, __VA_ARGS__)
+#define fmt_cprintd(...) c_MACRO_OVERLOAD(_fmt_printd, 1, __VA_ARGS__)
+#define fmt_close(x) _Generic ((x), fmt_stream*: _fmt_close, fmt_buffer*: _fmt_close_buffer)(x)
 #define fmt_sv "{:.*s}"
 #define fmt_svarg(sv) (int)(sv).size, (sv).buf
 
-/* Primary function. */
-#define fmt_printd_2(to, fmt) \
+/* Primary function. The translated format is kept in a static per call site when cached. */
+#define _fmt_storage_0
+#define _fmt_storage_1 static _fmt_thread_local
+#define _fmt_printd(cached, to, fmt, nargs, types, ...) \
+    do { _fmt_storage_##cached char _fs[FMT_MAX]; \
+         if (!cached || !*_fs) { int _n = _fmt_parse(_fs, nargs, fmt, c_EXPAND types); fmt_OK(_n == nargs); } \
+         _fmt_fn(to)(to, _fs, __VA_ARGS__); } while (0)
+
+#define _fmt_printd_3(C, to, fmt) \
     do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 0, fmt); \
          fmt_OK(_n == 0); _fmt_fn(to)(to, fmt); } while (0)
-#define fmt_printd_3(to, fmt, c) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 1, fmt, _fc(c)); \
-         fmt_OK(_n == 1); _fmt_fn(to)(to, _fs, c); } while (0)
-#define fmt_printd_4(to, fmt, c, d) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 2, fmt, _fc(c), _fc(d)); \
-         fmt_OK(_n == 2); _fmt_fn(to)(to, _fs, c, d); } while (0)
-#define fmt_printd_5(to, fmt, c, d, e) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 3, fmt, _fc(c), _fc(d), _fc(e)); \
-         fmt_OK(_n == 3); _fmt_fn(to)(to, _fs, c, d, e); } while (0)
-#define fmt_printd_6(to, fmt, c, d, e, f) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 4, fmt, _fc(c), _fc(d), _fc(e), _fc(f)); \
-         fmt_OK(_n == 4); _fmt_fn(to)(to, _fs, c, d, e, f); } while (0)
-#define fmt_printd_7(to, fmt, c, d, e, f, g) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 5, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g)); \
-         fmt_OK(_n == 5); _fmt_fn(to)(to, _fs, c, d, e, f, g); } while (0)
-#define fmt_printd_8(to, fmt, c, d, e, f, g, h) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 6, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h)); \
-         fmt_OK(_n == 6); _fmt_fn(to)(to, _fs, c, d, e, f, g, h); } while (0)
-#define fmt_printd_9(to, fmt, c, d, e, f, g, h, i) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 7, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i)); \
-         fmt_OK(_n == 7); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i); } while (0)
-#define fmt_printd_10(to, fmt, c, d, e, f, g, h, i, j) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 8, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), \
-                                                                     _fc(i), _fc(j)); \
-         fmt_OK(_n == 8); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i, j); } while (0)
-#define fmt_printd_11(to, fmt, c, d, e, f, g, h, i, j, k) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 9, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), \
-                                                                     _fc(i), _fc(j), _fc(k)); \
-         fmt_OK(_n == 9); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i, j, k); } while (0)
-#define fmt_printd_12(to, fmt, c, d, e, f, g, h, i, j, k, m) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 10, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), \
-                                                                      _fc(i), _fc(j), _fc(k), _fc(m)); \
-         fmt_OK(_n == 10); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i, j, k, m); } while (0)
-#define fmt_printd_13(to, fmt, c, d, e, f, g, h, i, j, k, m, n) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 11, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), \
-                                                                      _fc(i), _fc(j), _fc(k), _fc(m), _fc(n)); \
-         fmt_OK(_n == 11); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i, j, k, m, n); } while (0)
-#define fmt_printd_14(to, fmt, c, d, e, f, g, h, i, j, k, m, n, o) \
-    do { char _fs[FMT_MAX]; int _n = _fmt_parse(_fs, 12, fmt, _fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), \
-                                                                      _fc(i), _fc(j), _fc(k), _fc(m), _fc(n), _fc(o)); \
-         fmt_OK(_n == 12); _fmt_fn(to)(to, _fs, c, d, e, f, g, h, i, j, k, m, n, o); } while (0)
-
+#define _fmt_printd_4(C, to, fmt, c) \
+    _fmt_printd(C, to, fmt, 1, (_fc(c)), c)
+#define _fmt_printd_5(C, to, fmt, c, d) \
+    _fmt_printd(C, to, fmt, 2, (_fc(c), _fc(d)), c, d)
+#define _fmt_printd_6(C, to, fmt, c, d, e) \
+    _fmt_printd(C, to, fmt, 3, (_fc(c), _fc(d), _fc(e)), c, d, e)
+#define _fmt_printd_7(C, to, fmt, c, d, e, f) \
+    _fmt_printd(C, to, fmt, 4, (_fc(c), _fc(d), _fc(e), _fc(f)), c, d, e, f)
+#define _fmt_printd_8(C, to, fmt, c, d, e, f, g) \
+    _fmt_printd(C, to, fmt, 5, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g)), c, d, e, f, g)
+#define _fmt_printd_9(C, to, fmt, c, d, e, f, g, h) \
+    _fmt_printd(C, to, fmt, 6, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h)), c, d, e, f, g, h)
+#define _fmt_printd_10(C, to, fmt, c, d, e, f, g, h, i) \
+    _fmt_printd(C, to, fmt, 7, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i)), \
+                c, d, e, f, g, h, i)
+#define _fmt_printd_11(C, to, fmt, c, d, e, f, g, h, i, j) \
+    _fmt_printd(C, to, fmt, 8, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i), _fc(j)), \
+                c, d, e, f, g, h, i, j)
+#define _fmt_printd_12(C, to, fmt, c, d, e, f, g, h, i, j, k) \
+    _fmt_printd(C, to, fmt, 9, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i), _fc(j), _fc(k)), \
+                c, d, e, f, g, h, i, j, k)
+#define _fmt_printd_13(C, to, fmt, c, d, e, f, g, h, i, j, k, m) \
+    _fmt_printd(C, to, fmt, 10, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i), _fc(j), _fc(k), \
+                                 _fc(m)), c, d, e, f, g, h, i, j, k, m)
+#define _fmt_printd_14(C, to, fmt, c, d, e, f, g, h, i, j, k, m, n) \
+    _fmt_printd(C, to, fmt, 11, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i), _fc(j), _fc(k), \
+                                 _fc(m), _fc(n)), c, d, e, f, g, h, i, j, k, m, n)
+#define _fmt_printd_15(C, to, fmt, c, d, e, f, g, h, i, j, k, m, n, o) \
+    _fmt_printd(C, to, fmt, 12, (_fc(c), _fc(d), _fc(e), _fc(f), _fc(g), _fc(h), _fc(i), _fc(j), _fc(k), \
+                                 _fc(m), _fc(n), _fc(o)), c, d, e, f, g, h, i, j, k, m, n, o)
 #define _fmt_fn(x) _Generic ((x), \
     FILE*: fprintf, \
     char*: sprintf, \
-    fmt_stream*: _fmt_sprint)
+    fmt_stream*: _fmt_sprint, \
+    fmt_buffer*: _fmt_bprint)
 
 #if defined(_MSC_VER) && !defined(__clang__)
   #define _signed_char_hhd
@@ -203,10 +251,57 @@ FMT_API void       _fmt_sprint(fmt_stream*, const char* fmt, ...);
 #include <string.h>
 #include <time.h>
 
-FMT_DEF FMT_UNUSED void fmt_close(fmt_stream* ss) {
+#if defined _WIN32
+  #include <io.h>
+  #define _fmt_write_fd _write
+#else
+  #include <unistd.h>
+  #define _fmt_write_fd write
+#endif
+
+FMT_DEF FMT_UNUSED void _fmt_close(fmt_stream* ss) {
     free(ss->data);
 }
 
+static void _fmt_write_file(void* fp, const char* s, intptr_t n)
+    { fwrite(s, 1, (size_t)n, (FILE*)fp); }
+
+static void _fmt_write_to_fd(void* fd, const char* s, intptr_t n) {
+    while (n > 0) {
+        const intptr_t k = (intptr_t)_fmt_write_fd((int)(intptr_t)fd, s, (unsigned)n);
+        if (k <= 0) break;
+        s += k, n -= k;
+    }
+}
+
+FMT_DEF FMT_UNUSED fmt_buffer fmt_buffer_sink(void (*write)(void* ctx, const char* s, intptr_t n),
+                                              void* ctx, char* buf, intptr_t cap) {
+    fmt_OK(buf == NULL || cap > 0); // the size of a caller-supplied buf must be given
+    if (buf == NULL && cap <= 0) cap = FMT_BUFSIZE;
+    fmt_buffer fb = {buf, cap, 0, write, ctx, buf == NULL};
+    if (fb.owned) fb.data = (char*)malloc((size_t)cap);
+    if (fb.data == NULL || cap <= 0) // unbuffered: each write goes straight to write()
+        fb.data = NULL, fb.cap = 0, fb.owned = 0;
+    return fb;
+}
+
+FMT_DEF FMT_UNUSED fmt_buffer fmt_buffer_file(FILE* fp, char* buf, intptr_t cap)
+    { return fmt_buffer_sink(_fmt_write_file, fp, buf, cap); }
+
+FMT_DEF FMT_UNUSED fmt_buffer fmt_buffer_fd(int fd, char* buf, intptr_t cap)
+    { return fmt_buffer_sink(_fmt_write_to_fd, (void*)(intptr_t)fd, buf, cap); }
+
+FMT_DEF void fmt_flush(fmt_buffer* fb) {
+    if (fb->len) fb->write(fb->ctx, fb->data, fb->len);
+    fb->len = 0;
+}
+
+FMT_DEF FMT_UNUSED void _fmt_close_buffer(fmt_buffer* fb) {
+    fmt_flush(fb);
+    if (fb->owned) free(fb->data);
+    fb->data = NULL, fb->cap = 0;
+}
+
 FMT_DEF FMT_UNUSED
 const char* fmt_time(const char *fmt, const struct tm* tm, char* buf, int len) {
     strftime(buf, (size_t)len, fmt, tm);
@@ -221,19 +316,185 @@ FMT_DEF void _fmt_sprint(fmt_stream* ss, const char* fmt, ...) {
         goto done1;
     }
     va_copy(args2, args);
-    const int n = vsnprintf(NULL, 0U, fmt, args);
-    if (n < 0) goto done2;
     const intptr_t pos = ss->overwrite ? 0 : ss->len;
-    ss->len = pos + n;
-    if (ss->len > ss->cap) {
-        ss->cap = ss->len + ss->cap/2;
+    const int n = ss->data ? vsnprintf(ss->data + pos, (size_t)(ss->cap - pos) + 1U, fmt, args)
+                           : vsnprintf(NULL, 0U, fmt, args);
+    if (n < 0) goto done2;
+    if (pos + n > ss->cap) { // did not fit: grow and format again
+        ss->cap = pos + n > ss->cap*2 ? pos + n : ss->cap*2;
         ss->data = (char*)realloc(ss->data, (size_t)ss->cap + 1U);
+        vsnprintf(ss->data + pos, (size_t)n+1, fmt, args2);
     }
-    vsnprintf(ss->data + pos, (size_t)n+1, fmt, args2);
+    ss->len = pos + n;
     done2: va_end(args2);
     done1: va_end(args);
 }
 
+static void _fmt_put(fmt_buffer* fb, const char* s, intptr_t n) {
+    if (fb->cap == 0) { if (n > 0) fb->write(fb->ctx, s, n); return; }
+    while (n > fb->cap - fb->len) {
+        const intptr_t k = fb->cap - fb->len;
+        memcpy(fb->data + fb->len, s, (size_t)k);
+        fb->len += k, s += k, n -= k;
+        fmt_flush(fb);
+    }
+    memcpy(fb->data + fb->len, s, (size_t)n);
+    fb->len += n;
+}
+
+#define _fmt_is_flag(c) ((c) == '-' || (c) == '+' || (c) == ' ' || (c) == '#' || (c) == '0')
+#define _fmt_is_length(c) ((c) == 'h' || (c) == 'l' || (c) == 'L' || (c) == 'j' || (c) == 'z' || (c) == 't')
+
+static void _fmt_pad(fmt_buffer* fb, char c, intptr_t n) {
+    char pad[32];
+    if (n > 0) memset(pad, c, sizeof pad);
+    for (; n > 0; n -= (intptr_t)sizeof pad)
+        _fmt_put(fb, pad, n < (intptr_t)sizeof pad ? n : (intptr_t)sizeof pad);
+}
+
+static void _fmt_put_aligned(fmt_buffer* fb, const char* s, intptr_t n, int width, _Bool left) {
+    if (width <= n) { _fmt_put(fb, s, n); return; }
+    if (!left) _fmt_pad(fb, ' ', width - n);
+    _fmt_put(fb, s, n);
+    if (left) _fmt_pad(fb, ' ', width - n);
+}
+
+/* Writes a printf() format string and its arguments to fb. Plain text, and the d i u x X c s
+ * conversions with only '-' or '0' flags, width, and precision for s, are formatted here.
+ * Other conversions are formatted one at a time by snprintf(). */
+FMT_DEF void _fmt_bprint(fmt_buffer* fb, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    for (;;) {
+        const char* p = fmt;
+        while (*p && *p != '%') ++p;
+        _fmt_put(fb, fmt, p - fmt);
+        if (*p == '\0') break;
+        if (p[1] == '%') {
+            _fmt_put(fb, "%", 1);
+            fmt = p + 2;
+            continue;
+        }
+        const char* spec = p++;
+        _Bool left = 0, zero = 0, plain = 1;
+        for (; _fmt_is_flag(*p); ++p) {
+            left |= *p == '-', zero |= *p == '0';
+            plain &= *p == '-' || *p == '0';
+        }
+        const char* flags_end = p;
+        int width = 0, prec = -1;
+        if (*p == '*') {
+            width = va_arg(args, int), ++p;
+            if (width < 0) left = 1, width = -width;
+        } else while (*p >= '0' && *p <= '9') width = width*10 + (*p++ - '0');
+        if (*p == '.') {
+            prec = 0;
+            if (*++p == '*') prec = va_arg(args, int), ++p;
+            else while (*p >= '0' && *p <= '9') prec = prec*10 + (*p++ - '0');
+        }
+        int len = 0, nlen = 0; // hh: -2, h: -1, l: 1, ll: 2, L: 3, j: 4, z: 5, t: 6
+        for (; _fmt_is_length(*p); ++p, ++nlen)
+            len = *p == 'h' ? len - 1 : *p == 'l' ? len + 1 : *p == 'L' ? 3 : *p == 'j' ? 4 : *p == 'z' ? 5 : 6;
+        const char conv = *p;
+        fmt = p + (conv != 0);
+        plain &= width <= 64 && len <= 2;
+
+        if (plain && (conv == 'd' || conv == 'i' || conv == 'u' || conv == 'x' || conv == 'X') && prec < 0) {
+            unsigned long long u;
+            _Bool neg = 0;
+            if (conv == 'd' || conv == 'i') {
+                long long v = len == 2 ? va_arg(args, long long) : len == 1 ? va_arg(args, long) : va_arg(args, int);
+                if (len == -1) v = (short)v; else if (len == -2) v = (signed char)v;
+                neg = v < 0, u = neg ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+            } else {
+                u = len == 2 ? va_arg(args, unsigned long long) : len == 1 ? va_arg(args, unsigned long)
+                                                                         : va_arg(args, unsigned);
+                if (len == -1) u = (unsigned short)u; else if (len == -2) u = (unsigned char)u;
+            }
+            char buf[24], *e = buf + sizeof buf, *d = e;
+            if (conv == 'x' || conv == 'X') {
+                const char* hex = conv == 'x' ? "0123456789abcdef" : "0123456789ABCDEF";
+                do *--d = hex[u & 15]; while (u >>= 4);
+            } else {
+                do *--d = (char)('0' + u % 10); while (u /= 10);
+            }
+            const intptr_t n = (e - d) + neg;
+            if (neg && (zero && !left)) _fmt_put(fb, "-", 1), _fmt_pad(fb, '0', width - n);
+            else if (neg) *--d = '-';
+            if (zero && !left && !neg) _fmt_pad(fb, '0', width - n);
+            _fmt_put_aligned(fb, d, e - d, zero && !left ? 0 : width, left);
+        } else if (plain && conv == 's' && len == 0 && !zero) {
+            const char* str = va_arg(args, const char*);
+            if (str == NULL) str = "(null)";
+            intptr_t n = 0;
+            if (prec < 0) n = (intptr_t)strlen(str);
+            else while (n < prec && str[n]) ++n;
+            _fmt_put_aligned(fb, str, n, width, left);
+        } else if (plain && conv == 'c' && len == 0 && !zero) {
+            const char c = (char)va_arg(args, int);
+            _fmt_put_aligned(fb, &c, 1, width, left);
+        } else { // format this conversion with snprintf()
+            char sub[48], tmp[128], *out = tmp;
+            int m = 1;
+            sub[0] = '%';
+            for (const char* f = "-+ #0"; *f; ++f) // each flag at most once: sub is bounded
+                if ((*f == '-' && left) || memchr(spec + 1, *f, (size_t)(flags_end - spec - 1)))
+                    sub[m++] = *f;
+            if (width > 0) m += sprintf(sub + m, "%d", width); // a 0 width would read as the '0' flag
+            if (prec >= 0) m += sprintf(sub + m, ".%d", prec);
+            if (nlen <= 2) { // length modifiers and conversion
+                memcpy(sub + m, p - nlen, (size_t)(fmt - (p - nlen)));
+                sub[m + (fmt - (p - nlen))] = '\0';
+            }
+
+            union { int i; long l; long long ll; intmax_t j; size_t z; ptrdiff_t t;
+                    double d; long double ld; void* p; } v;
+            int kind = 0; // 0: int-like, 1: double, 2: pointer, -1: none
+            switch (conv) {
+                case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                    switch (len) {
+                        case 1: v.l = va_arg(args, long); break;
+                        case 2: v.ll = va_arg(args, long long); break;
+                        case 4: v.j = va_arg(args, intmax_t); break;
+                        case 5: v.z = va_arg(args, size_t); break;
+                        case 6: v.t = va_arg(args, ptrdiff_t); break;
+                        default: v.i = va_arg(args, int);
+                    }
+                    break;
+                case 'c': v.i = va_arg(args, int); len = 0; break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                    kind = 1;
+                    if (len == 3) v.ld = va_arg(args, long double);
+                    else v.d = va_arg(args, double);
+                    break;
+                case 's': case 'p': kind = 2; v.p = va_arg(args, void*); break;
+                case 'n': (void)va_arg(args, void*); kind = -1; break; // not supported
+                default: kind = -1;
+            }
+            if (nlen > 2) kind = -1; // invalid length modifier
+            int n = 0;
+            for (size_t size = sizeof tmp; kind >= 0; size = (size_t)n + 1U) {
+                switch (kind*8 + len) {
+                    case 1: n = snprintf(out, size, sub, v.l); break;
+                    case 2: n = snprintf(out, size, sub, v.ll); break;
+                    case 4: n = snprintf(out, size, sub, v.j); break;
+                    case 5: n = snprintf(out, size, sub, v.z); break;
+                    case 6: n = snprintf(out, size, sub, v.t); break;
+                    case 8 + 3: n = snprintf(out, size, sub, v.ld); break;
+                    default: n = kind == 2 ? snprintf(out, size, sub, v.p)
+                               : kind == 1 ? snprintf(out, size, sub, v.d)
+                                           : snprintf(out, size, sub, v.i);
+                }
+                if (n < (int)size || out != tmp) break;
+                out = (char*)malloc((size_t)n + 1U);
+            }
+            if (n > 0) _fmt_put(fb, out, n);
+            if (out != tmp) free(out);
+        }
+    }
+    va_end(args);
+}
+
 FMT_DEF int _fmt_parse(char* p, int nargs, const char *fmt, ...) {
     char *arg, *p0, ch;
     int n = 0, empty;
@@ -0,0 +1,137 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+Compressed bitmap of 32-bit unsigned integers (roaring bitmap layout).
+
+The key space is split in 64K-chunks on the upper 16 bits. Each chunk is stored as
+a sorted array of the lower 16 bits (sparse), a 65536-bit cbits buffer (dense),
+or as run-length pairs (after cbitmap_run_optimize()).
+
+#include <stdio.h>
+#include "stc/cbitmap.h"
+
+int main(void) {
+    cbitmap a = cbitmap_init(), b = cbitmap_init();
+    for (c_range(i, 0, 1000000, 7)) cbitmap_add(&a, (uint32_t)i);
+    cbitmap_add_range(&b, 500000, 2000000);
+
+    cbitmap_intersect(&a, &b);
+    printf("%d:", (int)cbitmap_count(&a));
+    for (c_each_set_bit(i, cbitmap, a))
+        if (i.index < 500030) printf(" %d", (int)i.index);
+
+    c_drop(cbitmap, &a, &b);
+}
+*/
+// cbits.h resets the linkage options, so keep them for cbitmap.
+#if defined i_implement || defined i_import
+  #define _i_cbitmap_implement
+#endif
+#if defined i_static
+  #define _i_cbitmap_static
+#endif
+#include "cbits.h"
+
+#if defined _i_cbitmap_static
+  #define i_static
+  #undef _i_cbitmap_static
+#else
+  #define i_header // external linkage by default. override with i_static.
+#endif
+#include "priv/linkage.h"
+
+#ifndef STC_CBITMAP_H_INCLUDED
+#define STC_CBITMAP_H_INCLUDED
+
+typedef struct {
+    union { uint16_t* vals; uintptr_t* words; } u; // array/run: uint16 values; bitset: cbits words
+    int32_t card;       // number of members in chunk, 1..65536
+    int32_t n, cap;     // used/allocated uint16 slots (array: n=card, run: n=2*runs)
+    uint16_t key;       // upper 16 bits of members
+    uint8_t type;
+} _cbitmap_chunk;
+
+typedef struct {
+    _cbitmap_chunk* chunk;
+    int32_t size, cap;
+} cbitmap;
+
+typedef struct {
+    int64_t index;      // current member, -1 at end
+    const cbitmap* _bm;
+    int32_t _ci, _pos;
+    uintptr_t _word;
+} cbitmap_bit_iter;
+
+STC_INLINE cbitmap cbitmap_init(void) { cbitmap bm = {0}; return bm; }
+STC_INLINE bool cbitmap_is_empty(const cbitmap* self) { return self->size == 0; }
+
+STC_API void    cbitmap_drop(cbitmap* self);
+STC_API void    cbitmap_clear(cbitmap* self);
+STC_API cbitmap cbitmap_clone(cbitmap other);
+STC_API bool    cbitmap_add(cbitmap* self, uint32_t x);        // true if x was not a member
+STC_API void    cbitmap_add_range(cbitmap* self, uint32_t start, uint64_t end); // [start, end)
+STC_API bool    cbitmap_remove(cbitmap* self, uint32_t x);     // true if x was a member
+STC_API bool    cbitmap_contains(const cbitmap* self, uint32_t x);
+STC_API int64_t cbitmap_count(const cbitmap* self);
+
+STC_API void    cbitmap_union(cbitmap* self, const cbitmap* other);
+STC_API void    cbitmap_intersect(cbitmap* self, const cbitmap* other);
+STC_API void    cbitmap_difference(cbitmap* self, const cbitmap* other);
+STC_API int64_t cbitmap_and_count(const cbitmap* self, const cbitmap* other);
+STC_API bool    cbitmap_run_optimize(cbitmap* self);           // true if any chunk is run-length coded
+
+// Portable roaring serialization format, readable by CRoaring/RoaringBitmap implementations.
+STC_API isize   cbitmap_serialized_size(const cbitmap* self);
+STC_API isize   cbitmap_serialize(const cbitmap* self, char* buf); // returns bytes written
+STC_API bool    cbitmap_deserialize(cbitmap* self, const char* buf, isize len);
+
+STC_API cbitmap_bit_iter cbitmap_bit_begin(const cbitmap* self);
+STC_API void    cbitmap_bit_next(cbitmap_bit_iter* it);
+
+STC_INLINE cbitmap* cbitmap_take(cbitmap* self, cbitmap other) {
+    if (self->chunk != other.chunk) {
+        cbitmap_drop(self);
+        *self = other;
+    }
+    return self;
+}
+
+STC_INLINE cbitmap cbitmap_move(cbitmap* self) {
+    cbitmap tmp = *self;
+    self->chunk = NULL, self->size = self->cap = 0;
+    return tmp;
+}
+
+STC_INLINE void cbitmap_copy(cbitmap* self, const cbitmap* other) {
+    if (self->chunk != other->chunk)
+        cbitmap_take(self, cbitmap_clone(*other));
+}
+
+#endif // STC_CBITMAP_H_INCLUDED
+
+#if defined _i_cbitmap_implement || defined i_implement
+  #include "priv/cbitmap_prv.c"
+  #undef _i_cbitmap_implement
+#endif
+#include "priv/linkage2.h"
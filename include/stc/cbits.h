@@ -99,14 +99,286 @@ int main(void) {
         fputc(SetType##_test(_cb_set, _cb_i) ? '1' : '0', stream); \
 } while (0)
 
-STC_INLINE isize _cbits_count(const uintptr_t* set, const isize sz) {
-    const isize n = sz/_cbits_WB;
-    isize count = 0;
-    for (isize i = 0; i < n; ++i)
-        count += c_popcount(set[i]);
-    if (sz & (_cbits_WB - 1))
-        count += c_popcount(set[n] & (_cbits_bit(sz) - 1));
-    return count;
+#if defined _MSC_VER && INTPTR_MAX == INT64_MAX
+  STC_INLINE int _cbits_ctz(uintptr_t x) { unsigned long i; _BitScanForward64(&i, x); return (int)i; }
+#elif defined _MSC_VER
+  STC_INLINE int _cbits_ctz(uintptr_t x) { unsigned long i; _BitScanForward(&i, x); return (int)i; }
+#elif (defined __GNUC__ || defined __clang__) && INTPTR_MAX == INT64_MAX
+  STC_INLINE int _cbits_ctz(uintptr_t x) { return __builtin_ctzll(x); }
+#elif defined __GNUC__ || defined __clang__
+  STC_INLINE int _cbits_ctz(uintptr_t x) { return __builtin_ctz(x); }
+#else
+  STC_INLINE int _cbits_ctz(uintptr_t x) { return c_popcount((x & -x) - 1); }
+#endif
+
+// Bulk word operations: 256/128-bit vectors with AVX2/aarch64 NEON, else one word at a time.
+#define _cbits_and_w(x, y) ((x) & (y))
+#define _cbits_or_w(x, y) ((x) | (y))
+#define _cbits_xor_w(x, y) ((x) ^ (y))
+#define _cbits_andnot_w(x, y) ((x) & ~(y))
+#define _cbits_first_w(x, y) (x)
+
+#if defined __AVX2__
+  #include <immintrin.h>
+  #define _cbits_VN (32/_cbits_WS)
+  #define _cbits_vec __m256i
+  #define _cbits_vload(p) _mm256_loadu_si256((const __m256i*)(p))
+  #define _cbits_vstore(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+  #define _cbits_vzero() _mm256_setzero_si256()
+  #define _cbits_and_v(x, y) _mm256_and_si256(x, y)
+  #define _cbits_or_v(x, y) _mm256_or_si256(x, y)
+  #define _cbits_xor_v(x, y) _mm256_xor_si256(x, y)
+  #define _cbits_andnot_v(x, y) _mm256_andnot_si256(y, x)
+  #define _cbits_first_v(x, y) (x)
+
+  STC_INLINE __m256i _cbits_vpopc_add(__m256i acc, __m256i v) { // nibble lookup popcount
+    const __m256i lut = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                         0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i low4 = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low4));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4));
+    return _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+  STC_INLINE isize _cbits_vsum(__m256i acc) {
+    uint64_t s[4]; _mm256_storeu_si256((__m256i*)s, acc);
+    return (isize)(s[0] + s[1] + s[2] + s[3]);
+  }
+#elif defined __ARM_NEON && defined __aarch64__
+  #include <arm_neon.h>
+  #define _cbits_VN (16/_cbits_WS)
+  #define _cbits_vec uint64x2_t
+  #define _cbits_vload(p) vld1q_u64((const uint64_t*)(p))
+  #define _cbits_vstore(p, v) vst1q_u64((uint64_t*)(p), v)
+  #define _cbits_vzero() vdupq_n_u64(0)
+  #define _cbits_and_v(x, y) vandq_u64(x, y)
+  #define _cbits_or_v(x, y) vorrq_u64(x, y)
+  #define _cbits_xor_v(x, y) veorq_u64(x, y)
+  #define _cbits_andnot_v(x, y) vbicq_u64(x, y)
+  #define _cbits_first_v(x, y) (x)
+  #define _cbits_vpopc_add(acc, v) \
+    vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(v)))))
+  #define _cbits_vsum(acc) (isize)vaddvq_u64(acc)
+#endif
+
+#if defined _cbits_VN
+  #define _cbits_VOPR(op, set, other, i, n) \
+    for (const isize _nv = n - n % _cbits_VN; i < _nv; i += _cbits_VN) \
+        _cbits_vstore(set + i, _cbits_##op##_v(_cbits_vload(set + i), _cbits_vload(other + i)))
+  #define _cbits_VCOUNT(op, set, other, i, n, count) do { \
+    _cbits_vec _acc = _cbits_vzero(); \
+    for (const isize _nv = n - n % _cbits_VN; i < _nv; i += _cbits_VN) \
+        _acc = _cbits_vpopc_add(_acc, _cbits_##op##_v(_cbits_vload(set + i), _cbits_vload(other + i))); \
+    count += _cbits_vsum(_acc); \
+  } while (0)
+#else
+  #define _cbits_VOPR(op, set, other, i, n) (void)0
+  #define _cbits_VCOUNT(op, set, other, i, n, count) (void)0
+#endif
+
+// _cbits_OP(set, other, nwords): set = set OP other.
+// _cbits_OP_count(set, other, size): number of bits set in (set OP other).
+#define _cbits_DEF_BULK(op) \
+    STC_INLINE void _cbits_##op(uintptr_t* set, const uintptr_t* other, const isize nwords) { \
+        isize i = 0; \
+        _cbits_VOPR(op, set, other, i, nwords); \
+        for (; i < nwords; ++i) set[i] = _cbits_##op##_w(set[i], other[i]); \
+    } \
+    _cbits_DEF_COUNT(op)
+
+#define _cbits_DEF_COUNT(op) \
+    STC_INLINE isize _cbits_##op##_count(const uintptr_t* set, const uintptr_t* other, const isize sz) { \
+        const isize n = sz/_cbits_WB; \
+        isize i = 0, count = 0; \
+        (void)other; \
+        _cbits_VCOUNT(op, set, other, i, n, count); \
+        for (; i < n; ++i) count += c_popcount(_cbits_##op##_w(set[i], other[i])); \
+        if (sz & (_cbits_WB - 1)) \
+            count += c_popcount(_cbits_##op##_w(set[n], other[n]) & (_cbits_bit(sz) - 1)); \
+        return count; \
+    }
+
+_cbits_DEF_BULK(and)
+_cbits_DEF_BULK(or)
+_cbits_DEF_BULK(xor)
+_cbits_DEF_BULK(andnot)
+_cbits_DEF_COUNT(first)
+
+STC_INLINE isize _cbits_count(const uintptr_t* set, const isize sz)
+    { return _cbits_first_count(set, set, sz); }
+
+STC_INLINE isize _cbits_find_next(const uintptr_t* set, const isize sz, isize pos) {
+    if (pos >= sz) return c_NPOS;
+    if (pos < 0) pos = 0;
+    const isize nw = _cbits_words(sz);
+    isize w = pos/_cbits_WB;
+    uintptr_t word = set[w] & ~(_cbits_bit(pos) - 1);
+    while (word == 0) {
+        if (++w == nw) return c_NPOS;
+        word = set[w];
+    }
+    const isize i = w*_cbits_WB + _cbits_ctz(word);
+    return i < sz ? i : c_NPOS;
+}
+
+typedef struct { isize index; uintptr_t _word; const uintptr_t* _buf; isize _w, _nw, _size; } _cbits_bit_iter;
+
+STC_INLINE void _cbits_bit_next(_cbits_bit_iter* it) {
+    while (it->_word == 0) {
+        if (++it->_w >= it->_nw) { it->index = -1; return; }
+        it->_word = it->_buf[it->_w];
+    }
+    it->index = it->_w*_cbits_WB + _cbits_ctz(it->_word);
+    it->_word &= it->_word - 1; // clear lowest set bit
+    if (it->index >= it->_size) it->index = -1;
+}
+
+STC_INLINE _cbits_bit_iter _cbits_bit_begin(const uintptr_t* set, const isize sz) {
+    _cbits_bit_iter it = {0, 0, set, -1, _cbits_words(sz), sz};
+    _cbits_bit_next(&it);
+    return it;
+}
+
+// for (c_each_set_bit(it, cbits, set)) ...: it.index iterates the set bits in ascending order.
+// SetType must provide SetType_bit_iter, SetType_bit_begin() and SetType_bit_next(); index -1 is end.
+#define c_each_set_bit(...) c_MACRO_OVERLOAD(c_each_set_bit, __VA_ARGS__)
+#define c_each_set_bit_2(it, set) c_each_set_bit_3(it, cbits, set)
+#define c_each_set_bit_3(it, SetType, set) \
+    SetType##_bit_iter it = SetType##_bit_begin(&(set)); it.index >= 0; SetType##_bit_next(&it)
+
+// ------- cbits_index: rank/select directory (poppy layout) -------
+// Per 2048-bit block one 64-bit entry: 32-bit count of set bits since start of the
+// 2^32-bit superblock, and the counts of the first three 512-bit sub-blocks (10 bits each).
+// Every 8192th set bit samples its block number to narrow select(). Overhead is ~3.2%.
+
+typedef struct {
+    const uintptr_t* _bits;
+    uint64_t *_blocks, *_super;
+    uint32_t* _samples;
+    isize size, count;      // number of bits and of set bits
+    isize _nblocks, _nsamples, _scap;
+} cbits_index;
+
+enum { _cbits_BLOCK_SHIFT = 11, _cbits_SAMPLE_SHIFT = 13 };
+
+STC_INLINE uint64_t _cbits_word64(const uintptr_t* set, const isize nw, const isize k) {
+  #if INTPTR_MAX == INT64_MAX
+    (void)nw; return set[k];
+  #else
+    return set[2*k] | (2*k + 1 < nw ? (uint64_t)set[2*k + 1] << 32 : 0);
+  #endif
+}
+
+STC_INLINE int _cbits_popc64(uint64_t x) {
+  #if INTPTR_MAX == INT64_MAX
+    return c_popcount(x);
+  #else
+    return c_popcount((uintptr_t)x) + c_popcount((uintptr_t)(x >> 32));
+  #endif
+}
+
+// Position of the k'th (0-based) set bit in x; requires k < popcount(x).
+STC_INLINE int _cbits_select64(uint64_t x, int k) {
+  #if defined __BMI2__ && defined __AVX2__ && INTPTR_MAX == INT64_MAX
+    return _cbits_ctz(_pdep_u64((uint64_t)1 << k, x));
+  #else
+    const uint64_t ones = 0x0101010101010101u;
+    uint64_t s = x - ((x >> 1) & 0x5555555555555555u);
+    s = (s & 0x3333333333333333u) + ((s >> 2) & 0x3333333333333333u);
+    s = ((s + (s >> 4)) & 0x0f0f0f0f0f0f0f0fu)*ones; // inclusive byte prefix counts
+    int byte = 0;
+    while ((int)(s >> 8*byte & 0xff) <= k) ++byte;
+    if (byte) k -= (int)(s >> (8*byte - 8) & 0xff);
+    unsigned b = (unsigned)(x >> 8*byte & 0xff);
+    while (k--) b &= b - 1;
+    return 8*byte + c_popcount((uintptr_t)((b & -b) - 1));
+  #endif
+}
+
+STC_INLINE uint64_t _cbits_block_rank(const cbits_index* ix, const isize b)
+    { return ix->_super[(uint64_t)b >> (32 - _cbits_BLOCK_SHIFT)] + (uint32_t)ix->_blocks[b]; }
+
+STC_INLINE cbits_index _cbits_index_make(const uintptr_t* set, const isize sz) {
+    const isize nw = _cbits_words(sz), n64 = (sz + 63)/64;
+    const isize nblocks = (sz + 2047) >> _cbits_BLOCK_SHIFT;
+    cbits_index ix = {set, NULL, NULL, NULL, sz, 0, nblocks, 0, 8};
+    ix._blocks = (uint64_t*)c_malloc((nblocks + 1)*c_sizeof(uint64_t));
+    ix._super = (uint64_t*)c_malloc((isize)(((uint64_t)sz >> 32) + 1)*c_sizeof(uint64_t));
+    uint64_t total = 0, next_sample = 0;
+    ix._samples = (uint32_t*)c_malloc(ix._scap*c_sizeof(uint32_t));
+
+    for (isize b = 0; b <= nblocks; ++b) {
+        if ((b & ((1 << (32 - _cbits_BLOCK_SHIFT)) - 1)) == 0)
+            ix._super[(uint64_t)b >> (32 - _cbits_BLOCK_SHIFT)] = total;
+        uint64_t entry = total - ix._super[(uint64_t)b >> (32 - _cbits_BLOCK_SHIFT)], sum = 0;
+        for (int j = 0; j < 4 && b < nblocks; ++j) {
+            uint64_t cnt = 0;
+            for (isize k = b*32 + j*8, end = k + 8; k < end && k < n64; ++k) {
+                uint64_t w = _cbits_word64(set, nw, k);
+                if (k == n64 - 1 && (sz & 63)) w &= ((uint64_t)1 << (sz & 63)) - 1;
+                cnt += (uint64_t)_cbits_popc64(w);
+            }
+            if (j < 3) entry |= cnt << (32 + 10*j);
+            sum += cnt;
+        }
+        ix._blocks[b] = entry;
+        for (; next_sample < total + sum; next_sample += 1u << _cbits_SAMPLE_SHIFT) {
+            if (ix._nsamples == ix._scap)
+                ix._samples = (uint32_t*)c_realloc(ix._samples, ix._scap*c_sizeof(uint32_t),
+                                                   (ix._scap*2)*c_sizeof(uint32_t)), ix._scap *= 2;
+            ix._samples[ix._nsamples++] = (uint32_t)b;
+        }
+        total += sum;
+    }
+    ix.count = (isize)total;
+    return ix;
+}
+
+STC_INLINE void cbits_index_drop(cbits_index* self) {
+    c_free(self->_blocks, (self->_nblocks + 1)*c_sizeof(uint64_t));
+    c_free(self->_super, (isize)(((uint64_t)self->size >> 32) + 1)*c_sizeof(uint64_t));
+    c_free(self->_samples, self->_scap*c_sizeof(uint32_t));
+}
+
+// Number of set bits in [0, i), for 0 <= i <= size.
+STC_INLINE isize cbits_index_rank(const cbits_index* self, const isize i) {
+    const isize b = i >> _cbits_BLOCK_SHIFT, sub = (i >> 9) & 3, end = i >> 6;
+    const isize nw = _cbits_words(self->size);
+    const uint64_t e = self->_blocks[b];
+    uint64_t r = _cbits_block_rank(self, b);
+    for (isize j = 0; j < sub; ++j)
+        r += e >> (32 + 10*j) & 0x3ff;
+    for (isize k = b*32 + sub*8; k < end; ++k)
+        r += (uint64_t)_cbits_popc64(_cbits_word64(self->_bits, nw, k));
+    if (i & 63)
+        r += (uint64_t)_cbits_popc64(_cbits_word64(self->_bits, nw, end) & (((uint64_t)1 << (i & 63)) - 1));
+    return (isize)r;
+}
+
+// Position of the k'th (0-based) set bit, or c_NPOS if k >= count.
+STC_INLINE isize cbits_index_select(const cbits_index* self, isize k) {
+    if (k < 0 || k >= self->count) return c_NPOS;
+    const isize s = k >> _cbits_SAMPLE_SHIFT, nw = _cbits_words(self->size);
+    isize lo = self->_samples[s];
+    isize hi = s + 1 < self->_nsamples ? (isize)self->_samples[s + 1] : self->_nblocks - 1;
+    while (lo < hi) { // last block with rank <= k
+        const isize mid = (lo + hi + 1) >> 1;
+        if (_cbits_block_rank(self, mid) <= (uint64_t)k) lo = mid;
+        else hi = mid - 1;
+    }
+    k -= (isize)_cbits_block_rank(self, lo);
+    const uint64_t e = self->_blocks[lo];
+    isize w = lo*32;
+    for (int j = 0; j < 3; ++j, w += 8) {
+        const isize cnt = (isize)(e >> (32 + 10*j) & 0x3ff);
+        if (k < cnt) break;
+        k -= cnt;
+    }
+    for (;; ++w) {
+        const uint64_t x = _cbits_word64(self->_bits, nw, w);
+        const int cnt = _cbits_popc64(x);
+        if (k < cnt) return w*64 + _cbits_select64(x, (int)k);
+        k -= cnt;
+    }
 }
 
 STC_INLINE char* _cbits_to_str(const uintptr_t* set, const isize sz,
@@ -290,25 +562,61 @@ STC_INLINE Self _i_MEMB(_from)(const char* str) {
 /* Intersection */
 STC_INLINE void _i_MEMB(_intersect)(Self *self, const Self* other) {
     _i_assert(self->_size == other->_size);
-    isize n = _cbits_words(_i_MEMB(_size)(self));
-    while (n--) self->buffer[n] &= other->buffer[n];
+    _cbits_and(self->buffer, other->buffer, _cbits_words(_i_MEMB(_size)(self)));
 }
 /* Union */
 STC_INLINE void _i_MEMB(_union)(Self *self, const Self* other) {
     _i_assert(self->_size == other->_size);
-    isize n = _cbits_words(_i_MEMB(_size)(self));
-    while (n--) self->buffer[n] |= other->buffer[n];
+    _cbits_or(self->buffer, other->buffer, _cbits_words(_i_MEMB(_size)(self)));
 }
 /* Exclusive disjunction */
 STC_INLINE void _i_MEMB(_xor)(Self *self, const Self* other) {
     _i_assert(self->_size == other->_size);
-    isize n = _cbits_words(_i_MEMB(_size)(self));
-    while (n--) self->buffer[n] ^= other->buffer[n];
+    _cbits_xor(self->buffer, other->buffer, _cbits_words(_i_MEMB(_size)(self)));
+}
+/* Difference (and-not) */
+STC_INLINE void _i_MEMB(_difference)(Self *self, const Self* other) {
+    _i_assert(self->_size == other->_size);
+    _cbits_andnot(self->buffer, other->buffer, _cbits_words(_i_MEMB(_size)(self)));
 }
 
 STC_INLINE isize _i_MEMB(_count)(const Self* self)
     { return _cbits_count(self->buffer, _i_MEMB(_size)(self)); }
 
+/* Fused operation and count, without modifying the sets */
+STC_INLINE isize _i_MEMB(_and_count)(const Self* self, const Self* other) {
+    _i_assert(self->_size == other->_size);
+    return _cbits_and_count(self->buffer, other->buffer, _i_MEMB(_size)(self));
+}
+STC_INLINE isize _i_MEMB(_or_count)(const Self* self, const Self* other) {
+    _i_assert(self->_size == other->_size);
+    return _cbits_or_count(self->buffer, other->buffer, _i_MEMB(_size)(self));
+}
+STC_INLINE isize _i_MEMB(_xor_count)(const Self* self, const Self* other) {
+    _i_assert(self->_size == other->_size);
+    return _cbits_xor_count(self->buffer, other->buffer, _i_MEMB(_size)(self));
+}
+STC_INLINE isize _i_MEMB(_andnot_count)(const Self* self, const Self* other) {
+    _i_assert(self->_size == other->_size);
+    return _cbits_andnot_count(self->buffer, other->buffer, _i_MEMB(_size)(self));
+}
+
+/* Index of first set bit at or after pos (negative pos: from 0), or c_NPOS */
+STC_INLINE isize _i_MEMB(_find_next)(const Self* self, const isize pos)
+    { return _cbits_find_next(self->buffer, _i_MEMB(_size)(self), pos); }
+
+/* Rank/select directory over the current bits. Rebuild after the set is modified. */
+STC_INLINE cbits_index _i_MEMB(_build_index)(const Self* self)
+    { return _cbits_index_make(self->buffer, _i_MEMB(_size)(self)); }
+
+typedef _cbits_bit_iter _i_MEMB(_bit_iter);
+
+STC_INLINE _cbits_bit_iter _i_MEMB(_bit_begin)(const Self* self)
+    { return _cbits_bit_begin(self->buffer, _i_MEMB(_size)(self)); }
+
+STC_INLINE void _i_MEMB(_bit_next)(_cbits_bit_iter* it)
+    { _cbits_bit_next(it); }
+
 STC_INLINE char* _i_MEMB(_to_str)(const Self* self, char* out, isize start, isize stop)
     { return _cbits_to_str(self->buffer, _i_MEMB(_size)(self), out, start, stop); }
 
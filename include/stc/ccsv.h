@@ -0,0 +1,93 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+CSV reader (RFC 4180) over a csview. Fields are returned as views into the input, except
+fields with escaped quotes, which are unescaped into a buffer owned by the reader.
+
+#include <stdio.h>
+#include "stc/ccsv.h"
+
+int main(void) {
+    ccsv rd = ccsv_init(c_sv("name,comment\nAda,\"says \"\"hi\"\"\"\nBob,\"a,b\"\n"), ',');
+    csview f[4];
+    isize n;
+    while ((n = ccsv_read_row(&rd, f, 4)) >= 0) {
+        for (c_range(i, n)) printf("[" c_svfmt "]", c_svarg(f[i]));
+        puts("");
+    }
+    ccsv_drop(&rd);
+}
+*/
+// cstr.h resets the linkage options, so keep them for ccsv.
+#if defined i_implement || defined i_import
+  #define _i_ccsv_implement
+#endif
+#if defined i_static
+  #define _i_ccsv_static
+#endif
+#if !defined i_import
+  #undef i_implement // cstr is implemented in its own module
+#endif
+#include "cstr.h"
+#include "csview.h"
+
+#if defined _i_ccsv_static
+  #define i_static
+  #undef _i_ccsv_static
+#else
+  #define i_header // external linkage by default. override with i_static.
+#endif
+#include "priv/linkage.h"
+
+#ifndef STC_CCSV_H_INCLUDED
+#define STC_CCSV_H_INCLUDED
+
+typedef struct {
+    csview input;
+    isize pos;          // start of the next row in input
+    char delim, quote;  // quote = 0: no quoted fields
+    cstr _unquoted;     // unescaped fields of the last row
+} ccsv;
+
+STC_INLINE ccsv ccsv_init(csview input, char delim) {
+    ccsv rd = {.input = input, .delim = delim, .quote = '"'};
+    return rd;
+}
+
+STC_INLINE void ccsv_drop(ccsv* self)
+    { cstr_drop(&self->_unquoted); }
+
+STC_INLINE bool ccsv_at_end(const ccsv* self)
+    { return self->pos >= self->input.size; }
+
+// Reads the next row into fields[0, cap). Returns the number of fields in the row, which may be
+// larger than cap, 0 for an empty line, or -1 at end of input. Fields are valid until the next call.
+STC_API isize ccsv_read_row(ccsv* self, csview fields[], isize cap);
+
+#endif // STC_CCSV_H_INCLUDED
+
+#if defined _i_ccsv_implement || defined i_implement
+  #include "priv/ccsv_prv.c"
+  #undef _i_ccsv_implement
+#endif
+#include "priv/linkage2.h"
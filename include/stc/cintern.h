@@ -0,0 +1,119 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+String interning pool. Maps strings to stable 32-bit atoms and back, so that equal strings
+compare and hash as integers, and each distinct string is stored once.
+
+#include <stdio.h>
+#include "stc/cintern.h"
+
+#define i_type Counts, catom, int
+#include "stc/hmap.h"
+
+int main(void) {
+    cintern pool = cintern_init();
+    Counts counts = {0};
+    const char* hosts[] = {"a.example.com", "b.example.com", "a.example.com"};
+
+    for (c_range(i, c_arraylen(hosts)))
+        ++Counts_insert(&counts, cintern_intern(&pool, c_sv(hosts[i], c_strlen(hosts[i]))), 0).ref->second;
+
+    for (c_each_kv(atom, n, Counts, counts))
+        printf("%u %s: %d\n", *atom, cintern_str(&pool, *atom), *n);
+
+    Counts_drop(&counts);
+    cintern_drop(&pool);
+}
+*/
+#define i_header // external linkage by default. override with i_static.
+#include "priv/linkage.h"
+
+#ifndef STC_CINTERN_H_INCLUDED
+#define STC_CINTERN_H_INCLUDED
+
+#include <stdlib.h>
+#include "common.h"
+#include "types.h"
+
+// Lookups and atom access are lock-free and may run concurrently with cintern_intern().
+// This requires the GCC/Clang atomic builtins; with other compilers, synchronize externally.
+#if defined __GNUC__ || defined __clang__
+  #define _cintern_load(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+  #define _cintern_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+  #define _cintern_trylock(p) !__atomic_exchange_n(p, 1, __ATOMIC_ACQUIRE)
+  #define _cintern_unlock(p) __atomic_store_n(p, 0, __ATOMIC_RELEASE)
+#else
+  #define _cintern_load(p) (*(p))
+  #define _cintern_store(p, v) (void)(*(p) = (v))
+  #define _cintern_trylock(p) (*(p) = 1)
+  #define _cintern_unlock(p) (void)(*(p) = 0)
+#endif
+
+typedef uint32_t catom; // 0 is no atom
+
+typedef struct {
+    const char* str;    // zero terminated, stored in the pool arena
+    isize size;
+    size_t hash;        // c_hash_n() of the string
+} _cintern_entry;
+
+typedef struct {
+    _cintern_entry* entry;  // indexed by atom
+    uint32_t* table;        // [0]: log2 of slot count, then slots of atoms, 0 is empty
+    uint32_t size, cap;     // size includes the reserved atom 0
+    char *bump, *bump_end;  // free space in the current arena block
+    struct _cintern_block *arena, *store; // string blocks; entry arrays, tables and large strings
+    int lock;
+} cintern;
+
+STC_API catom   cintern_intern(cintern* self, csview sv);          // insert if new, thread-safe
+STC_API catom   cintern_find(const cintern* self, csview sv);      // 0 if not interned, lock-free
+STC_API void    cintern_drop(cintern* self);
+
+STC_INLINE cintern cintern_init(void) { cintern pool = {0}; return pool; }
+
+STC_INLINE isize cintern_size(const cintern* self) { // number of atoms
+    const uint32_t n = _cintern_load(&self->size);
+    return n ? n - 1 : 0;
+}
+
+STC_INLINE const _cintern_entry* _cintern_at(const cintern* self, catom atom) {
+    c_assert(atom != 0 && atom < _cintern_load(&self->size));
+    return &_cintern_load(&self->entry)[atom];
+}
+
+STC_INLINE csview cintern_sv(const cintern* self, catom atom)
+    { const _cintern_entry* e = _cintern_at(self, atom); return c_sv(e->str, e->size); }
+
+STC_INLINE const char* cintern_str(const cintern* self, catom atom)
+    { return _cintern_at(self, atom)->str; }
+
+STC_INLINE size_t cintern_hash(const cintern* self, catom atom)
+    { return _cintern_at(self, atom)->hash; }
+
+#endif // STC_CINTERN_H_INCLUDED
+
+#if defined i_implement
+  #include "priv/cintern_prv.c"
+#endif
+#include "priv/linkage2.h"
@@ -0,0 +1,86 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+Read-only view of a whole file as a csview. Regular files are memory mapped (POSIX),
+other files, e.g. pipes and character devices, are read into a heap buffer.
+
+#include <stdio.h>
+#include "stc/cmapfile.h"
+#include "stc/csview.h"
+
+int main(int argc, char* argv[]) {
+    cmapfile file = cmapfile_open(argc > 1 ? argv[1] : "/dev/stdin", cmapfile_SEQUENTIAL);
+    if (!cmapfile_is_open(&file)) return 1;
+    isize n = 0;
+    for (c_each_line(i, file.sv))
+        n += csview_starts_with(i.line, "ERROR");
+    printf("%d errors\n", (int)n);
+    cmapfile_drop(&file);
+}
+*/
+#if (defined i_implement || defined STC_IMPLEMENT) && defined __unix__ && !defined _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE // O_CLOEXEC, MAP_POPULATE, posix_madvise(): must precede system headers
+#endif
+#define i_header // external linkage by default. override with i_static.
+#include "priv/linkage.h"
+
+#ifndef STC_CMAPFILE_H_INCLUDED
+#define STC_CMAPFILE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common.h"
+#include "types.h"
+
+enum {
+    cmapfile_SEQUENTIAL = 1<<0, // access hint: read ahead aggressively
+    cmapfile_RANDOM = 1<<1,     // access hint: no read ahead
+    cmapfile_POPULATE = 1<<2,   // prefault all pages at open (Linux)
+};
+
+typedef struct {
+    csview sv;          // the file content, sv.buf is NULL if open failed
+    void* _base;
+    isize _size;
+    int8_t _mapped;     // 1: memory mapped, 0: heap buffer
+} cmapfile;
+
+STC_API cmapfile cmapfile_open(const char* path, int flags);
+STC_API cmapfile cmapfile_from_stream(FILE* fp);    // read remaining stream into a buffer
+STC_API void     cmapfile_drop(cmapfile* self);
+
+STC_INLINE bool cmapfile_is_open(const cmapfile* self)
+    { return self->sv.buf != NULL; }
+
+STC_INLINE bool cmapfile_is_mapped(const cmapfile* self)
+    { return self->_mapped != 0; }
+
+STC_INLINE csview cmapfile_sv(const cmapfile* self)
+    { return self->sv; }
+
+#endif // STC_CMAPFILE_H_INCLUDED
+
+#if defined i_implement
+  #include "priv/cmapfile_prv.c"
+#endif
+#include "priv/linkage2.h"
@@ -0,0 +1,119 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+Aho-Corasick multi-pattern search. Build once from a list of needles, then find or replace
+all of them in a single pass over the input.
+
+#include <stdio.h>
+#include "stc/cmultisearcher.h"
+
+int main(void) {
+    csview terms[] = {c_sv("password"), c_sv("secret"), c_sv("token")};
+    cmultisearcher ms = cmultisearcher_make(terms, c_arraylen(terms), cmultisearcher_ICASE);
+    cstr out = cmultisearcher_replace_all(&ms, c_sv("user=bob Password=x1 TOKEN=abc"), &c_sv("***"), 1);
+    printf("%s\n", cstr_str(&out)); // user=bob ***=x1 ***=abc
+    cstr_drop(&out);
+    cmultisearcher_drop(&ms);
+}
+*/
+// cstr.h resets the linkage options, so keep them for cmultisearcher.
+#if defined i_implement || defined i_import
+  #define _i_cmultisearcher_implement
+#endif
+#if defined i_static
+  #define _i_cmultisearcher_static
+#endif
+#if !defined i_import
+  #undef i_implement // cstr is implemented in its own module
+#endif
+#include "cstr.h"
+
+#if defined _i_cmultisearcher_static
+  #define i_static
+  #undef _i_cmultisearcher_static
+#else
+  #define i_header // external linkage by default. override with i_static.
+#endif
+#include "priv/linkage.h"
+
+#ifndef STC_CMULTISEARCHER_H_INCLUDED
+#define STC_CMULTISEARCHER_H_INCLUDED
+
+enum { cmultisearcher_ICASE = 1<<0 }; // ASCII case-insensitive matching
+
+typedef struct {
+    int32_t* delta;     // dense: transitions [nstates][nclasses]. sparse: root row only
+    int32_t* fail;      // sparse: failure links
+    int32_t* child;     // sparse: first child, 0 if none
+    int32_t* sibling;   // sparse: next sibling, 0 if none
+    uint16_t* label;    // sparse: byte class of the edge into a state
+    int32_t* match;     // longest pattern which is a suffix of the state, or -1
+    int32_t* depth;     // length of the state prefix
+    int32_t* patlen;
+    int32_t nstates, nclasses, npatterns;
+    bool dense;
+    uint16_t classes[256];  // byte -> class. 0: byte is in no pattern
+} cmultisearcher;
+
+typedef struct {
+    isize pos, len;     // byte position and length of the match in the input
+    int32_t pattern;    // index of the matched needle
+} cmultisearcher_match;
+
+typedef struct {
+    const cmultisearcher* searcher;
+    int32_t state;
+    isize offset, pos;  // bytes consumed before the current chunk, and position in it
+} cmultisearcher_stream;
+
+STC_API cmultisearcher cmultisearcher_make(const csview needles[], isize n, int flags);
+STC_API void    cmultisearcher_drop(cmultisearcher* self);
+
+// Leftmost-longest, non-overlapping matches.
+STC_API bool    cmultisearcher_find(const cmultisearcher* self, csview input, isize start,
+                                    cmultisearcher_match* m);
+STC_API isize   cmultisearcher_find_all(const cmultisearcher* self, csview input,
+                                        cmultisearcher_match out[], isize maxcount);
+STC_API cstr    cmultisearcher_replace_all(const cmultisearcher* self, csview input,
+                                           const csview repl[], isize nrepl); // nrepl: 1 or npatterns
+
+// Streaming over chunked input: reports the longest needle ending at each position, with
+// positions counted from the start of the stream. Call with the same chunk until it returns false.
+STC_API bool    cmultisearcher_stream_next(cmultisearcher_stream* st, csview chunk,
+                                           cmultisearcher_match* m);
+
+STC_INLINE cmultisearcher_stream cmultisearcher_stream_init(const cmultisearcher* self) {
+    cmultisearcher_stream st = {.searcher = self};
+    return st;
+}
+
+STC_INLINE isize cmultisearcher_size(const cmultisearcher* self)
+    { return self->npatterns; }
+
+#endif // STC_CMULTISEARCHER_H_INCLUDED
+
+#if defined _i_cmultisearcher_implement || defined i_implement
+  #include "priv/cmultisearcher_prv.c"
+  #undef _i_cmultisearcher_implement
+#endif
+#include "priv/linkage2.h"
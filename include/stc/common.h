@@ -302,15 +302,16 @@ STC_INLINE isize c_next_pow2(isize n) {
     return n + 1;
 }
 
+// memchr for the first byte, then check the last byte before comparing. See also csearcher.
 STC_INLINE char* c_strnstrn(const char *str, isize slen, const char *needle, isize nlen) {
     if (nlen == 0) return (char *)str;
     if (nlen > slen) return NULL;
-    slen -= nlen;
-    do {
-        if (*str == *needle && !c_memcmp(str, needle, nlen))
+    const char *end = str + (slen - nlen) + 1;
+    while ((str = (const char *)memchr(str, *needle, (size_t)(end - str))) != NULL) {
+        if (str[nlen - 1] == needle[nlen - 1] && !c_memcmp(str, needle, nlen))
             return (char *)str;
-        ++str;
-    } while (slen--);
+        if (++str == end) break;
+    }
     return NULL;
 }
 #endif // STC_COMMON_H_INCLUDED
@@ -181,6 +181,10 @@ typedef struct cco_fiber {
     int recover_state, awaitbits, result;
     int error, error_line;
     cco_state cco;
+    #ifdef STC_CCO_PROFILE
+    struct cco_task* parked_task;
+    int64_t parked_ns;
+    #endif
 } cco_fiber, cco_runtime; /* cco_runtime [deprecated] */
 
 /* Define a Task struct */
@@ -239,8 +243,13 @@ static inline int _cco_cancel_task(cco_task* task, cco_fiber* fiber)
 /*
  * cco_run_fiber()/cco_run_task(): Run fibers/tasks in parallel
  */
+#ifdef STC_CCO_PROFILE
+#define cco_new_task(Task, ...) \
+    _cco_profile_name((cco_task*)c_new(struct Task, {{.func=Task}, __VA_ARGS__}), #Task)
+#else
 #define cco_new_task(Task, ...) \
     ((cco_task*)c_new(struct Task, {{.func=Task}, __VA_ARGS__}))
+#endif
 
 #define cco_new_fiber(...) c_MACRO_OVERLOAD(cco_new_fiber, __VA_ARGS__)
 #define cco_new_fiber_1(task) cco_new_fiber_2(task, NULL)
@@ -269,16 +278,74 @@ extern cco_fiber* _cco_spawn(cco_task* task, cco_fiber* fb, void* env);
 extern cco_fiber* cco_resume_next(cco_fiber* prev);
 extern int        cco_resume_current(cco_fiber* co); /* coroutine */
 
+/*
+ * Profiling: define STC_CCO_PROFILE globally, i.e. both when building the library and
+ * the application. Statistics are collected per task function by the fiber runtime,
+ * in a table per thread. The dump at exit only sees the table of the exiting thread.
+ */
+#ifdef STC_CCO_PROFILE
+#include <stdio.h>
+#ifndef STC_CCO_PROFILE_MAX
+    #define STC_CCO_PROFILE_MAX 128 /* max distinct task functions, power of 2 */
+#endif
+
+typedef struct {
+    int (*func)(struct cco_task*, cco_fiber*);
+    const char* name;
+    int64_t resumes, awaits;
+    int64_t total_ns, max_ns, parked_ns;
+} cco_profile_entry;
+
+#define cco_profile_name(TaskFunc, name) \
+    _cco_profile_entry((int (*)(struct cco_task*, cco_fiber*))(TaskFunc), name)
+
+extern int64_t    cco_profile_clock_ns(void); /* monotonic clock */
+extern const cco_profile_entry* cco_profile_table(int* count);
+extern void       cco_profile_reset(void);
+extern void       cco_profile_dump(FILE* fp);
+extern void       cco_profile_dump_atexit(const char* filename); /* NULL => stderr, exiting thread only */
+extern cco_profile_entry* _cco_profile_entry(int (*func)(struct cco_task*, cco_fiber*), const char* name);
+
+static inline cco_task* _cco_profile_name(cco_task* task, const char* name)
+    { _cco_profile_entry(task->cco.func, name); return task; }
+#endif
+
 /* -------------------------- IMPLEMENTATION ------------------------- */
 #if defined i_implement || defined STC_IMPLEMENT
 #include <stdio.h>
 
+#ifdef STC_CCO_PROFILE
+static int _cco_profiled_resume(cco_fiber* fb) {
+    cco_task* task = fb->task;
+    cco_profile_entry* e = _cco_profile_entry(task->cco.func, NULL);
+    int64_t start = cco_profile_clock_ns(), elapsed;
+    if (fb->parked_task == task) {
+        e->parked_ns += start - fb->parked_ns;
+        fb->parked_task = NULL;
+    }
+    int res = cco_resume_task(task, fb);
+    elapsed = cco_profile_clock_ns() - start;
+    e->resumes += 1;
+    e->total_ns += elapsed;
+    if (elapsed > e->max_ns) e->max_ns = elapsed;
+    if (res == CCO_AWAIT) {
+        e->awaits += 1;
+        fb->parked_task = task;
+        fb->parked_ns = start + elapsed;
+    }
+    return res;
+}
+#define _cco_resume_task_profiled(fb) _cco_profiled_resume(fb)
+#else
+#define _cco_resume_task_profiled(fb) cco_resume_task((fb)->task, fb)
+#endif
+
 int cco_resume_current(cco_fiber* fb) {
     cco_routine (fb) {
         while (1) {
             fb->parent_task = fb->task->cco.parent_task;
             fb->awaitbits = fb->task->cco.awaitbits;
-            fb->result = cco_resume_task(fb->task, fb);
+            fb->result = _cco_resume_task_profiled(fb);
             if (fb->error) {
                 fb->task = fb->parent_task;
                 if (fb->task == NULL)
@@ -325,6 +392,128 @@ cco_fiber* _cco_spawn(cco_task* _task, cco_fiber* fb, void* env) {
     return (fb->next = new_fb);
 }
 
+#ifdef STC_CCO_PROFILE
+#include <time.h>
+#ifdef _WIN32
+    #ifdef __cplusplus
+      extern "C" __declspec(dllimport) int QueryPerformanceCounter(long long*);
+      extern "C" __declspec(dllimport) int QueryPerformanceFrequency(long long*);
+    #else
+      __declspec(dllimport) int QueryPerformanceCounter(long long*);
+      __declspec(dllimport) int QueryPerformanceFrequency(long long*);
+    #endif
+#endif
+
+#if defined _MSC_VER
+    #define _cco_thread_local __declspec(thread)
+#elif defined __cplusplus
+    #define _cco_thread_local thread_local
+#else
+    #define _cco_thread_local _Thread_local
+#endif
+
+/* one table per thread: fibers are resumed by the thread which runs them */
+static _cco_thread_local struct {
+    cco_profile_entry table[STC_CCO_PROFILE_MAX];
+    cco_profile_entry other; /* task functions which did not fit in the table */
+    int count;
+} _cco_profile;
+static const char* _cco_profile_filename;
+
+int64_t cco_profile_clock_ns(void) {
+  #if defined _WIN32
+    static long long freq;
+    long long ticks;
+    if (freq == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&ticks);
+    return (int64_t)(ticks/freq*1000000000 + ticks%freq*1000000000/freq);
+  #elif defined CLOCK_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+  #else /* requires _POSIX_C_SOURCE for CLOCK_MONOTONIC; fall back to C11 wall clock */
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (int64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+  #endif
+}
+
+cco_profile_entry* _cco_profile_entry(int (*func)(struct cco_task*, cco_fiber*), const char* name) {
+    size_t mask = STC_CCO_PROFILE_MAX - 1;
+    size_t i = (size_t)(c_hash_n(&func, sizeof func) & mask);
+    cco_profile_entry* e;
+
+    while ((e = &_cco_profile.table[i])->func != func) {
+        if (e->func == NULL) {
+            if (_cco_profile.count == STC_CCO_PROFILE_MAX - 1) { // table full: count in "(other)"
+                _cco_profile.other.name = "(other)";
+                return &_cco_profile.other;
+            }
+            ++_cco_profile.count;
+            e->func = func;
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    if (name != NULL) e->name = name;
+    return e;
+}
+
+const cco_profile_entry* cco_profile_table(int* count) {
+    static _cco_thread_local cco_profile_entry result[STC_CCO_PROFILE_MAX];
+    int n = 0;
+    for (int i = 0; i < STC_CCO_PROFILE_MAX; ++i)
+        if (_cco_profile.table[i].func != NULL)
+            result[n++] = _cco_profile.table[i];
+    if (_cco_profile.other.resumes) // at most STC_CCO_PROFILE_MAX - 1 entries above
+        result[n++] = _cco_profile.other;
+    *count = n;
+    return result;
+}
+
+void cco_profile_reset(void) {
+    for (int i = 0; i <= STC_CCO_PROFILE_MAX; ++i) {
+        cco_profile_entry* e = i < STC_CCO_PROFILE_MAX ? &_cco_profile.table[i] : &_cco_profile.other;
+        e->resumes = e->awaits = 0;
+        e->total_ns = e->max_ns = e->parked_ns = 0;
+    }
+}
+
+void cco_profile_dump(FILE* fp) {
+    int n;
+    const cco_profile_entry* tab = cco_profile_table(&n);
+    fprintf(fp, "%-24s %12s %14s %12s %12s %10s %14s\n",
+                "task", "resumes", "total_ms", "avg_us", "max_us", "awaits", "parked_ms");
+    for (int i = 0; i < n; ++i) {
+        const cco_profile_entry* e = &tab[i];
+        char addr[32];
+        if (e->name == NULL) {
+            uintptr_t a = 0;
+            memcpy(&a, &e->func, sizeof a < sizeof e->func ? sizeof a : sizeof e->func);
+            snprintf(addr, sizeof addr, "0x%" PRIxPTR, a);
+        }
+        fprintf(fp, "%-24s %12" PRId64 " %14.3f %12.3f %12.3f %10" PRId64 " %14.3f\n",
+                    e->name ? e->name : addr, e->resumes, (double)e->total_ns*1e-6,
+                    e->resumes ? (double)e->total_ns*1e-3/(double)e->resumes : 0.0,
+                    (double)e->max_ns*1e-3, e->awaits, (double)e->parked_ns*1e-6);
+    }
+}
+
+static void _cco_profile_atexit(void) {
+    FILE* fp = _cco_profile_filename ? fopen(_cco_profile_filename, "w") : stderr;
+    if (fp == NULL) return;
+    cco_profile_dump(fp);
+    if (fp != stderr) fclose(fp);
+}
+
+void cco_profile_dump_atexit(const char* filename) {
+    static bool registered;
+    if (!registered) atexit(_cco_profile_atexit);
+    registered = true;
+    _cco_profile_filename = filename;
+}
+#endif // STC_CCO_PROFILE
+
 #undef i_implement
 #endif
 
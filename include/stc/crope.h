@@ -0,0 +1,145 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+Rope: a string stored as a balanced tree of chunks, for large texts with many edits.
+Insert, erase and positional lookup are O(log n), instead of moving the tail of the string.
+
+#include <stdio.h>
+#include "stc/crope.h"
+
+int main(void) {
+    crope r = crope_from("Hello world!");
+    crope_insert(&r, 5, ",");
+    crope_replace_sv(&r, 7, 5, c_sv("wørld"));
+    crope_push_sv(&r, c_sv(" Bye."));
+
+    for (c_each(i, crope, r)) // chunks as csviews
+        printf(c_svfmt, c_svarg(*i.ref));
+    printf("\n%d bytes, %d codepoints\n", (int)crope_size(&r), (int)crope_u8_size(&r));
+    crope_drop(&r);
+}
+*/
+// cstr.h resets the linkage options, so keep them for crope.
+#if defined i_implement || defined i_import
+  #define _i_crope_implement
+#endif
+#if defined i_static
+  #define _i_crope_static
+#endif
+#if !defined i_import
+  #undef i_implement // cstr is implemented in its own module
+#endif
+#include "cstr.h"
+
+#if defined _i_crope_static
+  #define i_static
+  #undef _i_crope_static
+#else
+  #define i_header // external linkage by default. override with i_static.
+#endif
+#include "priv/linkage.h"
+
+#ifndef STC_CROPE_H_INCLUDED
+#define STC_CROPE_H_INCLUDED
+
+enum { crope_CHUNK = 1024 }; // max bytes per chunk
+
+typedef struct _crope_node {
+    struct _crope_node *left, *right, *parent;
+    csview sv;          // the chunk: points to data
+    isize u8len;        // codepoints in the chunk
+    isize size, u8size; // bytes and codepoints in the subtree
+    uint64_t prio;      // treap priority: max at the root
+    char data[crope_CHUNK];
+} _crope_node;
+
+typedef struct {
+    _crope_node* root;
+    uint64_t seed;
+} crope;
+
+typedef struct {
+    const csview* ref;  // current chunk, NULL at end
+    const _crope_node* _node;
+} crope_iter;
+
+STC_API crope   crope_from_sv(csview sv);
+STC_API crope   crope_clone(crope r);
+STC_API void    crope_drop(const crope* self);
+STC_API void    crope_clear(crope* self);
+
+STC_API void    crope_insert_sv(crope* self, isize pos, csview sv);
+STC_API void    crope_erase(crope* self, isize pos, isize len);
+STC_API char    crope_at(const crope* self, isize pos);
+STC_API cstr    crope_substr(const crope* self, isize pos, isize len);  // copy of bytes [pos, pos + len)
+STC_API isize   crope_u8_to_pos(const crope* self, isize u8pos);        // byte position of a codepoint
+
+STC_API crope_iter crope_begin(const crope* self);
+STC_API void    crope_next(crope_iter* it);
+STC_API crope_iter crope_find_chunk(const crope* self, isize pos, isize* offset); // chunk containing pos
+
+STC_INLINE crope crope_init(void) { crope r = {0}; return r; }
+STC_INLINE crope crope_from(const char* str) { return crope_from_sv(c_sv(str, c_strlen(str))); }
+STC_INLINE isize crope_size(const crope* self) { return self->root ? self->root->size : 0; }
+STC_INLINE isize crope_u8_size(const crope* self) { return self->root ? self->root->u8size : 0; }
+STC_INLINE bool crope_is_empty(const crope* self) { return self->root == NULL; }
+
+STC_INLINE void crope_insert(crope* self, isize pos, const char* str)
+    { crope_insert_sv(self, pos, c_sv(str, c_strlen(str))); }
+
+STC_INLINE void crope_push_sv(crope* self, csview sv)
+    { crope_insert_sv(self, crope_size(self), sv); }
+
+STC_INLINE void crope_replace_sv(crope* self, isize pos, isize len, csview repl)
+    { crope_erase(self, pos, len); crope_insert_sv(self, pos, repl); }
+
+STC_INLINE cstr crope_to_cstr(const crope* self)
+    { return crope_substr(self, 0, crope_size(self)); }
+
+STC_INLINE cstr crope_u8_substr(const crope* self, isize u8pos, isize u8len) {
+    const isize u8end = u8len < crope_u8_size(self) - u8pos ? u8pos + u8len : crope_u8_size(self);
+    const isize pos = crope_u8_to_pos(self, u8pos);
+    return crope_substr(self, pos, crope_u8_to_pos(self, u8end) - pos);
+}
+
+STC_INLINE crope* crope_take(crope* self, crope other) {
+    if (self->root != other.root) {
+        crope_drop(self);
+        *self = other;
+    }
+    return self;
+}
+
+STC_INLINE crope crope_move(crope* self) {
+    crope tmp = *self;
+    self->root = NULL;
+    return tmp;
+}
+
+#endif // STC_CROPE_H_INCLUDED
+
+#if defined _i_crope_implement || defined i_implement
+  #include "priv/crope_prv.c"
+  #undef _i_crope_implement
+#endif
+#include "priv/linkage2.h"
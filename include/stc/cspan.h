@@ -62,6 +62,7 @@ int demo2() {
 #ifndef STC_CSPAN_H_INCLUDED
 #define STC_CSPAN_H_INCLUDED
 #include "common.h"
+#include <stdio.h>
 typedef int32_t cspan_istride, _istride;
 typedef isize _isize_triple[3];
 
@@ -114,7 +115,9 @@ typedef isize _isize_triple[3];
     } \
     STC_INLINE void Self##_next(Self##_iter* it) { \
         int done; \
-        it->ref += _cspan_next##RANK(it->pos, it->_s->shape, it->_s->stride.d, RANK, &done); \
+        if (++it->pos[RANK - 1] < it->_s->shape[RANK - 1]) \
+            { it->ref += it->_s->stride.d[RANK - 1]; return; } \
+        it->ref += _cspan_carry(it->pos, it->_s->shape, it->_s->stride.d, RANK, &done); \
         if (done) it->ref = NULL; \
     } \
     STC_INLINE isize Self##_size(const Self* self) \
@@ -221,10 +224,54 @@ typedef enum {c_ROWMAJOR, c_COLMAJOR, c_STRIDED} cspan_layout;
 #define cspan_swap_axes(self, ax1, ax2) \
     _cspan_swap_axes((self)->shape, (self)->stride.d, ax1, ax2, cspan_rank(self))
 
-// Set all span elements to value.
-#define cspan_set_all(Span, self, value) do { \
-    Span##_value _v = value; \
-    for (c_each_3(_it, Span, *(self))) *_it.ref = _v; \
+// Iterate the inner runs of a span. Trailing dimensions which are laid out contiguously
+// after each other are collapsed into a single run: it.ref points to it.size elements
+// spaced it.stride apart. A fully row-major span is visited as one run with stride 1.
+#define cspan_each_block(it, Span, span) \
+    struct {Span##_value *ref, *_data; isize size; _istride stride; _cspan_runs _r;} \
+    it = {._data=(span).data, ._r=_cspan_runs_init((span).shape, (span).stride.d, \
+                                                   (span).stride.d, (int)c_arraylen((span).shape))} \
+    ; !it._r.done && (it.ref = it._data + it._r.off[0], \
+                      it.size = it._r.size, it.stride = it._r.step[0], 1) \
+    ; _cspan_runs_next(&it._r)
+
+// Elementwise operations. Inner runs with stride 1 are written as plain
+// loops over contiguous memory, so that they may be auto-vectorized.
+#define cspan_fill(Span, self, val) do { \
+    const Span##_value _v = val; \
+    for (cspan_each_block(_b, Span, *(self))) { \
+        Span##_value* _p = _b.ref; \
+        if (_b.stride == 1) for (isize _i = 0; _i < _b.size; ++_i) _p[_i] = _v; \
+        else for (isize _i = 0; _i < _b.size; ++_i) _p[_i*_b.stride] = _v; \
+    } \
+} while (0)
+
+#define cspan_set_all(Span, self, value) cspan_fill(Span, self, value)
+
+// Apply expression/statement to each element; `value` is a pointer to the element.
+#define cspan_apply(Span, self, ...) do { \
+    for (cspan_each_block(_b, Span, *(self))) { \
+        Span##_value *value = _b.ref, *_e; \
+        if (_b.stride == 1) \
+            for (_e = value + _b.size; value != _e; ++value) { __VA_ARGS__; } \
+        else \
+            for (_e = value + _b.size*_b.stride; value != _e; value += _b.stride) { __VA_ARGS__; } \
+    } \
+} while (0)
+
+// Copy elements between two spans of equal shape but possibly different layouts.
+#define cspan_copy(Span, dst, src) do { \
+    const Span* _s = src; Span* _d = dst; \
+    c_assert(memcmp(_d->shape, _s->shape, sizeof _d->shape) == 0); \
+    for (_cspan_runs _r = _cspan_runs_init(_d->shape, _d->stride.d, _s->stride.d, (int)cspan_rank(_d)); \
+         !_r.done; _cspan_runs_next(&_r)) { \
+        Span##_value* _dp = _d->data + _r.off[0]; \
+        const Span##_value* _sp = _s->data + _r.off[1]; \
+        if ((_r.step[0] == 1) & (_r.step[1] == 1)) \
+            for (isize _i = 0; _i < _r.size; ++_i) _dp[_i] = _sp[_i]; \
+        else for (isize _i = 0; _i < _r.size; ++_i) \
+            _dp[_i*_r.step[0]] = _sp[_i*_r.step[1]]; \
+    } \
 } while (0)
 
 // General slicing function.
@@ -273,6 +320,88 @@ typedef enum {c_ROWMAJOR, c_COLMAJOR, c_STRIDED} cspan_layout;
      .shape={(self)->shape[3]}, \
      .stride=c_literal(cspan_tuple1){.d={(self)->stride.d[3]}}}
 
+// Matrix multiplication of 2-d spans with float, double or int elements: C = A*B, or C += A*B.
+// Any layout/strides are accepted, e.g. transposed or sliced views.
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L
+#define cspan_matmul(A, B, C) _cspan_matmul(A, B, C, false)
+#define cspan_matmul_add(A, B, C) _cspan_matmul(A, B, C, true)
+#define _cspan_matmul(A, B, C, add) \
+    _Generic(*(C)->data, float: _cspan_matmul_float, double: _cspan_matmul_double, \
+                         int: _cspan_matmul_int) \
+    ((A)->data, (A)->shape, (A)->stride.d, (B)->data, (B)->shape, (B)->stride.d, \
+     (C)->data, (C)->shape, (C)->stride.d + c_static_assert(cspan_rank(A) == 2 && \
+                            cspan_rank(B) == 2 && cspan_rank(C) == 2), add)
+#endif
+
+// Reduce along one axis into an output span of rank one less: cspan_reduce(Span3, &in, 1, &out2, cspan_op_sum)
+// OP(a, b) is an associative binary macro or function. Contiguous axes are reduced with
+// independent partial accumulators (vectorizable), other axes row-by-row over the output.
+#define cspan_reduce(Span, in, axis, out, OP) \
+    _cspan_axis_apply(Span, in, axis, out, 0, _cspan_reduce_line, OP)
+
+// Inclusive scan along one axis into an output span of equal shape (may be the input span).
+#define cspan_scan(Span, in, axis, out, OP) \
+    _cspan_axis_apply(Span, in, axis, out, 1, _cspan_scan_line, OP)
+
+// Index of max/min element (first occurrence) along an axis into an integer span of rank one less.
+#define cspan_argmax(Span, in, axis, out) \
+    _cspan_axis_apply(Span, in, axis, out, 0, _cspan_arg_line, _cspan_op_gt)
+#define cspan_argmin(Span, in, axis, out) \
+    _cspan_axis_apply(Span, in, axis, out, 0, _cspan_arg_line, _cspan_op_lt)
+
+#define cspan_op_sum(a, b) ((a) + (b))
+#define cspan_op_prod(a, b) ((a) * (b))
+#define cspan_op_min(a, b) ((b) < (a) ? (b) : (a))
+#define cspan_op_max(a, b) ((a) < (b) ? (b) : (a))
+
+// NumPy .npy file I/O (C11). Element types: bool, integer and floating point types.
+typedef struct {
+    void* data;                 // element data, mapped or allocated
+    isize size;                 // number of elements
+    int rank;
+    bool fortran_order;         // true: c_COLMAJOR layout
+    char descr[8];              // numpy dtype, e.g. "<f4"
+    _istride shape[8];
+    struct { void* base; isize len; bool mapped; } _mem;
+} cspan_npy;
+
+typedef struct {
+    FILE* fp;
+    char kind;
+    isize elemsize, remaining;
+} cspan_npy_writer;
+
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L
+// Make a span over the elements of a loaded .npy file. Returns false if element type or rank mismatch.
+#define cspan_npy_get(npy, span) \
+    (((span)->data = _cspan_npy_get(npy, _cspan_npy_kind(*(span)->data), c_sizeof *(span)->data, \
+                                    (span)->shape, (span)->stride.d, (int)cspan_rank(span))) != NULL)
+
+// Save any span; strided spans are written in C order, column-major spans as fortran order.
+#define cspan_npy_save(path, span) \
+    _cspan_npy_save(path, (span)->data, _cspan_npy_kind(*(span)->data), c_sizeof *(span)->data, \
+                    (span)->shape, (span)->stride.d, (int)cspan_rank(span))
+
+// Streaming writer: declare element type and full shape, then append spans in C order.
+#define cspan_npy_writer_open(w, path, T, ...) \
+    _cspan_npy_writer_open(w, path, _cspan_npy_kind((T){0}), c_sizeof(T), \
+                           c_make_array(isize, {__VA_ARGS__}), c_NUMARGS(__VA_ARGS__))
+#define cspan_npy_write(w, span) \
+    _cspan_npy_write(w, (span)->data, _cspan_npy_kind(*(span)->data), c_sizeof *(span)->data, \
+                     (span)->shape, (span)->stride.d, (int)cspan_rank(span))
+
+#define _cspan_npy_kind(x) _Generic((x), \
+    float: 'f', double: 'f', bool: 'b', char: ((char)-1 < 0 ? 'i' : 'u'), \
+    signed char: 'i', short: 'i', int: 'i', long: 'i', long long: 'i', \
+    unsigned char: 'u', unsigned short: 'u', unsigned: 'u', unsigned long: 'u', \
+    unsigned long long: 'u')
+#endif
+
+STC_API bool cspan_npy_load(cspan_npy* npy, const char* path);
+STC_API bool cspan_npy_mmap(cspan_npy* npy, const char* path); // zero-copy, copy-on-write
+STC_API void cspan_npy_drop(cspan_npy* npy);
+STC_API bool cspan_npy_writer_close(cspan_npy_writer* w);
+
 #define cspan_print(...) c_MACRO_OVERLOAD(cspan_print, __VA_ARGS__)
 #if 0
 #define cspan_print_2(Span, span) /* c11 */ \
@@ -311,6 +440,109 @@ typedef enum {c_ROWMAJOR, c_COLMAJOR, c_STRIDED} cspan_layout;
 
 /* ----- PRIVATE ----- */
 
+#if defined _OPENMP
+  #define _cspan_OMP(x) _Pragma(#x)
+#else
+  #define _cspan_OMP(x)
+#endif
+enum { _cspan_LINE_MAX = 512, _cspan_PAR_MIN = 1<<18 };
+#define _cspan_op_gt(a, b) ((a) > (b))
+#define _cspan_op_lt(a, b) ((a) < (b))
+
+// Iterate all lines of the output (other dims than axis), optionally in parallel chunks.
+#define _cspan_axis_apply(Span, in, axis, out, keep, LINE, OP) do { \
+    const Span* _in = in; \
+    const int _ax = axis; \
+    const _istride* _ostri = (out)->stride.d + c_static_assert(cspan_rank(out) + 1 - keep == cspan_rank(in)); \
+    const _cspan_runs _r0 = _cspan_axis_runs(_in->shape, _in->stride.d, (out)->shape, _ostri, \
+                                             (int)cspan_rank(_in), _ax, keep); \
+    const isize _n = _in->shape[_ax], _sa = _in->stride.d[_ax], _oa = keep ? _ostri[_ax] : 0; \
+    const isize _total = _n > 0 ? _cspan_runs_count(&_r0) : 0; /* empty axis: out untouched */ \
+    isize _nchunks = _total*_n/_cspan_PAR_MIN + 1; \
+    (void)_oa; \
+    if (_nchunks > _total) _nchunks = _total; \
+    _cspan_OMP(omp parallel for if (_nchunks > 1) schedule(dynamic)) \
+    for (isize _c = 0; _c < _nchunks; ++_c) { \
+        _cspan_runs _r = _r0; \
+        isize _p = _c*_total/_nchunks, _pend = (_c + 1)*_total/_nchunks; \
+        isize _t = _cspan_runs_seek(&_r, _p), _len; \
+        for (; _p < _pend; _p += _len) { \
+            _len = _r.size - _t; \
+            if (_len > _pend - _p) _len = _pend - _p; \
+            if (_len > _cspan_LINE_MAX) _len = _cspan_LINE_MAX; \
+            LINE(Span, (_in->data + _r.off[1] + _t*_r.step[1]), _r.step[1], \
+                 ((out)->data + _r.off[0] + _t*_r.step[0]), _r.step[0], _len, _n, _sa, _oa, OP); \
+            if ((_t += _len) == _r.size) { _t = 0; _cspan_runs_next(&_r); } \
+        } \
+    } \
+} while (0)
+
+#define _cspan_reduce_line(Span, ip, is, dp, ds, len, n, sa, oa, OP) do { \
+    if (sa == 1) for (isize _i = 0; _i < len; ++_i) { \
+        const Span##_value* _x = ip + _i*is; \
+        Span##_value _acc = _x[0]; \
+        isize _k = 1; \
+        if (n >= 8) { /* independent partial accumulators */ \
+            Span##_value _a[4] = {_x[0], _x[1], _x[2], _x[3]}; \
+            for (_k = 4; _k + 4 <= n; _k += 4) { \
+                _a[0] = OP(_a[0], _x[_k]); _a[1] = OP(_a[1], _x[_k + 1]); \
+                _a[2] = OP(_a[2], _x[_k + 2]); _a[3] = OP(_a[3], _x[_k + 3]); \
+            } \
+            _acc = OP(OP(_a[0], _a[1]), OP(_a[2], _a[3])); \
+        } \
+        for (; _k < n; ++_k) _acc = OP(_acc, _x[_k]); \
+        dp[_i*ds] = _acc; \
+    } else { /* accumulate whole rows along the axis */ \
+        for (isize _i = 0; _i < len; ++_i) dp[_i*ds] = ip[_i*is]; \
+        for (isize _k = 1; _k < n; ++_k) { \
+            const Span##_value* _x = ip + _k*sa; \
+            if ((is == 1) & (ds == 1)) \
+                for (isize _i = 0; _i < len; ++_i) dp[_i] = OP(dp[_i], _x[_i]); \
+            else for (isize _i = 0; _i < len; ++_i) \
+                dp[_i*ds] = OP(dp[_i*ds], _x[_i*is]); \
+        } \
+    } \
+} while (0)
+
+#define _cspan_scan_line(Span, ip, is, dp, ds, len, n, sa, oa, OP) do { \
+    if (sa == 1) for (isize _i = 0; _i < len; ++_i) { \
+        const Span##_value* _x = ip + _i*is; \
+        Span##_value* _y = dp + _i*ds, _acc = _x[0]; \
+        _y[0] = _acc; \
+        for (isize _k = 1; _k < n; ++_k) _y[_k*oa] = _acc = OP(_acc, _x[_k]); \
+    } else { \
+        for (isize _i = 0; _i < len; ++_i) dp[_i*ds] = ip[_i*is]; \
+        for (isize _k = 1; _k < n; ++_k) { \
+            const Span##_value* _x = ip + _k*sa; \
+            const Span##_value* _yp = dp + (_k - 1)*oa; \
+            Span##_value* _y = dp + _k*oa; \
+            if ((is == 1) & (ds == 1)) \
+                for (isize _i = 0; _i < len; ++_i) _y[_i] = OP(_yp[_i], _x[_i]); \
+            else for (isize _i = 0; _i < len; ++_i) \
+                _y[_i*ds] = OP(_yp[_i*ds], _x[_i*is]); \
+        } \
+    } \
+} while (0)
+
+#define _cspan_arg_line(Span, ip, is, dp, ds, len, n, sa, oa, BETTER) do { \
+    if (sa == 1) for (isize _i = 0; _i < len; ++_i) { \
+        const Span##_value* _x = ip + _i*is; \
+        Span##_value _best = _x[0]; \
+        _istride _bi = 0; \
+        for (_istride _k = 1; _k < n; ++_k) \
+            if (BETTER(_x[_k], _best)) _best = _x[_k], _bi = _k; \
+        dp[_i*ds] = _bi; \
+    } else { \
+        Span##_value _best[_cspan_LINE_MAX]; \
+        for (isize _i = 0; _i < len; ++_i) _best[_i] = ip[_i*is], dp[_i*ds] = 0; \
+        for (_istride _k = 1; _k < n; ++_k) { \
+            const Span##_value* _x = ip + _k*sa; \
+            for (isize _i = 0; _i < len; ++_i) \
+                if (BETTER(_x[_i*is], _best[_i])) _best[_i] = _x[_i*is], dp[_i*ds] = _k; \
+        } \
+    } \
+} while (0)
+
 STC_INLINE isize _cspan_size(const _istride shape[], int rank) {
     isize size = shape[0];
     while (--rank) size *= shape[rank];
@@ -347,6 +579,29 @@ STC_API void _cspan_print_assist(_istride pos[], const _istride shape[], const i
 
 STC_API isize _cspan_next2(_istride pos[], const _istride shape[], const _istride stride[],
                            int rank, int* done);
+STC_API isize _cspan_carry(_istride pos[], const _istride shape[], const _istride stride[],
+                           int rank, int* done);
+
+typedef struct {
+    isize off[2], size;         // run offsets for up to two spans; run length
+    _istride step[2];           // element stride within the run
+    int rank, done;             // collapsed outer rank
+    isize pos[8], shape[8], stride[2][8];
+} _cspan_runs;
+
+STC_API _cspan_runs _cspan_runs_init(const _istride shape[], const _istride stride_a[],
+                                     const _istride stride_b[], int rank);
+STC_API void _cspan_runs_next(_cspan_runs* r);
+STC_API isize _cspan_runs_seek(_cspan_runs* r, isize idx);
+STC_API _cspan_runs _cspan_axis_runs(const _istride shape[], const _istride stride[],
+                                     const _istride oshape[], const _istride ostride[],
+                                     int rank, int axis, int keep_axis);
+
+STC_INLINE isize _cspan_runs_count(const _cspan_runs* r) {
+    isize n = r->size;
+    for (int i = 0; i < r->rank; ++i) n *= r->shape[i];
+    return r->done ? 0 : n;
+}
 #define _cspan_next1(pos, shape, stride, rank, done) (*done = (++pos[0] == shape[0]), stride[0])
 #define _cspan_next3 _cspan_next2
 #define _cspan_next4 _cspan_next2
@@ -360,6 +615,23 @@ STC_API isize _cspan_slice(_istride oshape[], _istride ostride[], int* orank,
                            const isize args[][3], int rank);
 STC_API _istride* _cspan_shape2stride(cspan_layout layout, _istride shape[], int rank);
 STC_API bool _cspan_is_layout(cspan_layout layout, const _istride shape[], const _istride strides[], int rank);
+
+#define _cspan_DECL_MATMUL(T) \
+    STC_API void _cspan_matmul_##T(const T* a, const _istride ash[2], const _istride ast[2], \
+                                   const T* b, const _istride bsh[2], const _istride bst[2], \
+                                   T* c, const _istride csh[2], const _istride cst[2], bool add)
+_cspan_DECL_MATMUL(float);
+_cspan_DECL_MATMUL(double);
+_cspan_DECL_MATMUL(int);
+
+STC_API void* _cspan_npy_get(const cspan_npy* npy, char kind, isize elemsize,
+                             _istride shape[], _istride stride[], int rank);
+STC_API bool _cspan_npy_save(const char* path, const void* data, char kind, isize elemsize,
+                             const _istride shape[], const _istride stride[], int rank);
+STC_API bool _cspan_npy_writer_open(cspan_npy_writer* w, const char* path, char kind, isize elemsize,
+                                    const isize shape[], int rank);
+STC_API bool _cspan_npy_write(cspan_npy_writer* w, const void* data, char kind, isize elemsize,
+                              const _istride shape[], const _istride stride[], int rank);
 #endif // STC_CSPAN_H_INCLUDED
 
 /* --------------------- IMPLEMENTATION --------------------- */
@@ -390,8 +662,13 @@ STC_DEF void _cspan_print_assist(_istride pos[], const _istride shape[], const i
 
 STC_DEF isize _cspan_next2(_istride pos[], const _istride shape[], const _istride stride[],
                            int rank, int* done) {
+    ++pos[rank - 1];
+    return _cspan_carry(pos, shape, stride, rank, done);
+}
+
+STC_DEF isize _cspan_carry(_istride pos[], const _istride shape[], const _istride stride[],
+                           int rank, int* done) {
     isize off = stride[--rank];
-    ++pos[rank];
 
     for (; rank && pos[rank] == shape[rank]; --rank) {
         pos[rank] = 0; ++pos[rank - 1];
@@ -401,6 +678,85 @@ STC_DEF isize _cspan_next2(_istride pos[], const _istride shape[], const _istrid
     return off;
 }
 
+STC_DEF _cspan_runs _cspan_runs_init(const _istride shape[], const _istride stride_a[],
+                                     const _istride stride_b[], int rank) {
+    _cspan_runs r = {0};
+    int k = 8; // collapsed dims are stored at the back, innermost last
+
+    while (rank--) { // merge dims laid out contiguously after each other; skip unit dims
+        if (shape[rank] == 1) continue;
+        r.done |= (shape[rank] == 0);
+        if (k < 8 && stride_a[rank] == r.shape[k]*r.stride[0][k]
+                  && stride_b[rank] == r.shape[k]*r.stride[1][k]) {
+            r.shape[k] *= shape[rank];
+            continue;
+        }
+        --k;
+        r.shape[k] = shape[rank];
+        r.stride[0][k] = stride_a[rank];
+        r.stride[1][k] = stride_b[rank];
+    }
+    if (k == 8) { // single element
+        --k;
+        r.shape[k] = 1;
+    }
+    r.size = r.shape[7];
+    r.step[0] = (_istride)r.stride[0][7];
+    r.step[1] = (_istride)r.stride[1][7];
+    r.rank = 7 - k;
+    for (int i = 0; i < r.rank; ++i) { // move outer dims to front
+        r.shape[i] = r.shape[k + i];
+        r.stride[0][i] = r.stride[0][k + i];
+        r.stride[1][i] = r.stride[1][k + i];
+    }
+    return r;
+}
+
+STC_DEF void _cspan_runs_next(_cspan_runs* r) {
+    int i = r->rank;
+    while (i--) {
+        r->off[0] += r->stride[0][i];
+        r->off[1] += r->stride[1][i];
+        if (++r->pos[i] < r->shape[i]) return;
+        r->off[0] -= r->shape[i]*r->stride[0][i];
+        r->off[1] -= r->shape[i]*r->stride[1][i];
+        r->pos[i] = 0;
+    }
+    r->done = 1;
+}
+
+STC_DEF isize _cspan_runs_seek(_cspan_runs* r, isize idx) {
+    isize q = idx/r->size;
+    r->off[0] = r->off[1] = 0;
+    for (int i = r->rank; i--; ) {
+        r->pos[i] = q % r->shape[i];
+        q /= r->shape[i];
+        r->off[0] += r->pos[i]*r->stride[0][i];
+        r->off[1] += r->pos[i]*r->stride[1][i];
+    }
+    r->done |= (q > 0);
+    return idx % r->size;
+}
+
+STC_DEF _cspan_runs _cspan_axis_runs(const _istride shape[], const _istride stride[],
+                                     const _istride oshape[], const _istride ostride[],
+                                     int rank, int axis, int keep_axis) {
+    _istride sh[8] = {1}, is[8] = {0}, os[8] = {0};
+    int n = 0;
+    (void)oshape;
+    c_assert(c_uless(axis, rank));
+    for (int i = 0, j = 0; i < rank; ++i, ++j) {
+        if (i == axis) {
+            if (!keep_axis) --j;
+            else c_assert(oshape[j] == shape[i]);
+            continue;
+        }
+        c_assert(oshape[j] == shape[i]);
+        sh[n] = shape[i], is[n] = stride[i], os[n] = ostride[j], ++n;
+    }
+    return _cspan_runs_init(sh, os, is, n ? n : 1);
+}
+
 STC_DEF _istride* _cspan_shape2stride(cspan_layout layout, _istride shpstri[], int rank) {
     int i, inc;
     if (layout == c_COLMAJOR) i = 0, inc = 1;
@@ -442,5 +798,6 @@ STC_DEF isize _cspan_slice(_istride oshape[], _istride ostride[], int* orank,
     *orank = oi;
     return off;
 }
+#include "priv/cspan_prv.c"
 #endif // IMPLEMENT
 #include "priv/linkage2.h"
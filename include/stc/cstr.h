@@ -33,6 +33,7 @@
 #include "common.h"
 #include "types.h"
 #include "priv/utf8_prv.h"
+#include "priv/csearcher_prv.h"
 #include "priv/cstr_prv.h"
 
 #endif // STC_CSTR_H_INCLUDED
@@ -44,6 +45,10 @@
   #include "priv/cstr_prv.c"
 #endif // i_implement
 
+#if defined i_implement || defined STC_CSTR_CORE
+  #include "priv/csearcher_prv.c"
+#endif
+
 #if defined i_import || defined STC_CSTR_UTF8
   #include "priv/utf8_prv.c"
 #endif
@@ -0,0 +1,176 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/*
+Packed string vector: all strings are stored back to back in one character buffer, and the
+vector holds one offset per string. No allocation per string, and 8 bytes overhead per element
+plus a length prefix and a zero terminator in the buffer.
+
+#include <stdio.h>
+#include "stc/cstrvec.h"
+
+int main(void) {
+    cstrvec v = cstrvec_init();
+    const char* words[] = {"pear", "apple", "fig", "banana"};
+    for (c_range(i, c_arraylen(words)))
+        cstrvec_emplace(&v, words[i]);
+
+    cstrvec_sort(&v);
+    for (c_range(i, cstrvec_size(&v)))
+        printf(" %s", cstrvec_str(&v, i));
+    printf("\nfig at %d\n", (int)cstrvec_binary_search(&v, c_sv("fig")));
+    cstrvec_drop(&v);
+}
+*/
+// cstr.h resets the linkage options, so keep them for cstrvec.
+#if defined i_implement || defined i_import
+  #define _i_cstrvec_implement
+#endif
+#if defined i_static
+  #define _i_cstrvec_static
+#endif
+#if !defined i_import
+  #undef i_implement // cstr is implemented in its own module
+#endif
+#include "cstr.h"
+
+#if defined _i_cstrvec_static
+  #define i_static
+  #undef _i_cstrvec_static
+#else
+  #define i_header // external linkage by default. override with i_static.
+#endif
+#if defined _i_cstrvec_implement
+  #define i_implement
+#endif
+#include "priv/linkage.h"
+
+#ifndef STC_CSTRVEC_H_INCLUDED
+#define STC_CSTRVEC_H_INCLUDED
+
+// Each string is stored as a LEB128 length, the bytes, and a zero terminator.
+typedef struct {
+    isize* offset;      // record start in chars, per element
+    isize size, capacity;
+    char* chars;
+    isize chars_size, chars_capacity;
+} cstrvec;
+
+STC_INLINE csview _cstrvec_record(const char* rec) {
+    const uint8_t* p = (const uint8_t*)rec;
+    size_t n = *p++;
+    if (n & 0x80) {
+        n &= 0x7f;
+        for (int shift = 7; ; shift += 7) {
+            const uint8_t b = *p++;
+            n |= (size_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+        }
+    }
+    return c_sv((const char*)p, (isize)n);
+}
+
+STC_INLINE cstrvec cstrvec_init(void) { cstrvec v = {0}; return v; }
+STC_INLINE isize cstrvec_size(const cstrvec* self) { return self->size; }
+STC_INLINE bool cstrvec_is_empty(const cstrvec* self) { return self->size == 0; }
+
+STC_INLINE csview cstrvec_at(const cstrvec* self, isize idx) {
+    c_assert(c_uless(idx, self->size));
+    return _cstrvec_record(self->chars + self->offset[idx]);
+}
+
+STC_INLINE const char* cstrvec_str(const cstrvec* self, isize idx) // zero terminated
+    { return cstrvec_at(self, idx).buf; }
+
+STC_INLINE csview cstrvec_front(const cstrvec* self) { return cstrvec_at(self, 0); }
+STC_INLINE csview cstrvec_back(const cstrvec* self) { return cstrvec_at(self, self->size - 1); }
+
+STC_API cstrvec cstrvec_with_capacity(isize n, isize nchars);
+STC_API cstrvec cstrvec_clone(cstrvec v);   // packed, in element order
+STC_API void    cstrvec_drop(const cstrvec* self);
+STC_API void    cstrvec_clear(cstrvec* self);
+STC_API bool    cstrvec_reserve(cstrvec* self, isize n, isize nchars);
+STC_API csview  cstrvec_push(cstrvec* self, csview sv);     // returns the stored string
+STC_API void    cstrvec_pop(cstrvec* self);
+STC_API void    cstrvec_erase_n(cstrvec* self, isize idx, isize n);
+STC_API void    cstrvec_compact(cstrvec* self); // repack chars in element order, drop erased strings
+
+// Ordered by csview_cmp(). Sorting permutes the offsets, the chars are not moved.
+STC_API void    cstrvec_sort(cstrvec* self);
+STC_API isize   cstrvec_lower_bound(const cstrvec* self, csview key);    // c_NPOS if all are less
+STC_API isize   cstrvec_binary_search(const cstrvec* self, csview key);  // c_NPOS if not found
+
+// Build from / dump to files without allocation per string. Lines exclude the delimiter.
+STC_API isize   cstrvec_append_lines(cstrvec* self, FILE* fp, int delim); // returns number of lines read
+STC_API bool    cstrvec_write_lines(const cstrvec* self, FILE* fp, int delim);
+STC_API bool    cstrvec_save(const cstrvec* self, FILE* fp);  // binary: header + packed records
+STC_API bool    cstrvec_load(cstrvec* self, FILE* fp);        // replaces content; false and unchanged if invalid
+
+STC_INLINE csview cstrvec_emplace(cstrvec* self, const char* str)
+    { return cstrvec_push(self, c_sv(str, c_strlen(str))); }
+
+STC_INLINE csview cstrvec_push_cstr(cstrvec* self, const cstr* s)
+    { return cstrvec_push(self, cstr_sv(s)); }
+
+STC_INLINE cstr cstrvec_cstr_at(const cstrvec* self, isize idx)
+    { csview sv = cstrvec_at(self, idx); return cstr_from_sv(sv); }
+
+STC_INLINE void cstrvec_erase_at(cstrvec* self, isize idx)
+    { cstrvec_erase_n(self, idx, 1); }
+
+STC_INLINE cstrvec* cstrvec_take(cstrvec* self, cstrvec other) {
+    if (self->offset != other.offset) {
+        cstrvec_drop(self);
+        *self = other;
+    }
+    return self;
+}
+
+STC_INLINE cstrvec cstrvec_move(cstrvec* self) {
+    cstrvec tmp = *self;
+    *self = cstrvec_init();
+    return tmp;
+}
+
+// Same ordering as csview_cmp(), and as cstr_cmp() for strings without zero bytes.
+STC_INLINE int _cstrvec_cmp(const csview* x, const csview* y) {
+    int c = c_memcmp(x->buf, y->buf, x->size < y->size ? x->size : y->size);
+    return c ? c : (x->size > y->size) - (x->size < y->size);
+}
+
+STC_INLINE int cstrvec_cmp_at(const cstrvec* self, isize i, isize j) {
+    csview x = cstrvec_at(self, i), y = cstrvec_at(self, j);
+    return _cstrvec_cmp(&x, &y);
+}
+
+STC_INLINE bool cstrvec_eq_at(const cstrvec* self, isize idx, csview sv) {
+    csview x = cstrvec_at(self, idx);
+    return x.size == sv.size && !c_memcmp(x.buf, sv.buf, sv.size);
+}
+
+#endif // STC_CSTRVEC_H_INCLUDED
+
+#if defined i_implement
+  #include "priv/cstrvec_prv.c"
+#endif
+#undef _i_cstrvec_implement
+#include "priv/linkage2.h"
@@ -25,10 +25,17 @@
 #ifndef STC_CSVIEW_H_INCLUDED
 #define STC_CSVIEW_H_INCLUDED
 
+#include <errno.h> /* csview_parse_result.ec */
 #include "common.h"
 #include "types.h"
 #include "priv/utf8_prv.h"
 
+// result of csview_parse_*(): number of bytes parsed, and 0, EINVAL or ERANGE like std::from_chars()
+typedef struct { isize size; int ec; } csview_parse_result;
+
+// 256-bit lookup table of bytes, for splitting on any of a set of delimiters
+typedef struct { uint8_t bits[32]; } csview_byteset;
+
 #define             csview_init() c_sv_1("")
 #define             csview_drop(p) c_default_drop(p)
 #define             csview_clone(sv) c_default_clone(sv)
@@ -36,9 +43,13 @@
 csview_iter         csview_advance(csview_iter it, isize u8pos);
 csview              csview_subview_pro(csview sv, isize pos, isize n);
 csview              csview_token(csview sv, const char* sep, isize* pos);
+csview              csview_token_any(csview sv, const csview_byteset* set, isize* pos);
 csview              csview_u8_subview(csview sv, isize u8pos, isize u8len);
 csview              csview_u8_tail(csview sv, isize u8len);
 csview_iter         csview_u8_at(csview sv, isize u8pos);
+csview_parse_result csview_parse_i64(csview sv, int64_t* out);
+csview_parse_result csview_parse_u64(csview sv, uint64_t* out);
+csview_parse_result csview_parse_double(csview sv, double* out);
 
 STC_INLINE csview   csview_from(const char* str)
     { return c_literal(csview){str, c_strlen(str)}; }
@@ -130,6 +141,21 @@ STC_INLINE isize csview_u8_size(csview sv)
 STC_INLINE bool csview_u8_valid(csview sv) // requires linking with utf8 symbols
     { return utf8_valid_n(sv.buf, sv.size); }
 
+/* positional access using an index built by utf8_index_from(sv). requires linking with utf8 symbols */
+STC_INLINE csview csview_u8_subview_ix(csview sv, const utf8_index* ix, isize u8pos, isize u8len) {
+    const char* s = utf8_index_at(ix, sv.buf, u8pos);
+    sv.size = utf8_index_at(ix, sv.buf, u8pos + u8len) - s;
+    sv.buf = s; return sv;
+}
+
+STC_INLINE csview_iter csview_u8_at_ix(csview sv, const utf8_index* ix, isize u8pos) {
+    const char *end = &sv.buf[sv.size];
+    sv.buf = utf8_index_at(ix, sv.buf, u8pos);
+    sv.size = utf8_chr_size(sv.buf);
+    c_assert(sv.buf != end);
+    return c_literal(csview_iter){.u8 = {sv, end}};
+}
+
 #define c_fortoken(...) for (c_token(__VA_ARGS__)) // [deprecated]
 
 #define c_token_sv(it, separator, sv) \
@@ -140,6 +166,42 @@ STC_INLINE bool csview_u8_valid(csview sv) // requires linking with utf8 symbols
 #define c_token(it, separator, str) \
     c_token_sv(it, separator, csview_from(str))
 
+STC_INLINE csview_byteset csview_byteset_from(const char* chars) {
+    csview_byteset set = {{0}};
+    for (const uint8_t* c = (const uint8_t*)chars; *c; ++c)
+        set.bits[*c >> 3] |= (uint8_t)(1U << (*c & 7));
+    return set;
+}
+
+STC_INLINE bool csview_byteset_contains(const csview_byteset* set, char c)
+    { return (set->bits[(uint8_t)c >> 3] >> (c & 7)) & 1; }
+
+/* like c_token_sv, but tokens are split at any single byte in the delimiters string */
+#define c_token_any_sv(it, delimiters, sv) \
+    struct { csview input, token; csview_byteset set; isize pos; } \
+    it = {.input=sv, .set=csview_byteset_from(delimiters)} ; \
+    it.pos <= it.input.size && (it.token = csview_token_any(it.input, &it.set, &it.pos)).buf ;
+
+#define c_token_any(it, delimiters, str) \
+    c_token_any_sv(it, delimiters, csview_from(str))
+
+/* next delim-terminated record from *pos. The final record need not be terminated. */
+STC_INLINE csview csview_record(csview sv, char delim, isize* pos) {
+    const char* b = sv.buf + *pos;
+    const char* p = (const char*)memchr(b, delim, (size_t)(sv.size - *pos));
+    csview rec = {b, p ? p - b : sv.size - *pos};
+    *pos += rec.size + 1;
+    return rec;
+}
+
+#define c_each_record(it, delimiter, sv) \
+    struct { csview input, line; isize pos; char delim; } \
+    it = {.input=sv, .delim=delimiter} ; \
+    it.pos < it.input.size && (it.line = csview_record(it.input, it.delim, &it.pos), 1) ;
+
+#define c_each_line(it, sv) \
+    c_each_record(it, '\n', sv)
+
 /* ---- Container helper functions ---- */
 
 STC_INLINE int csview_cmp(const csview* x, const csview* y) {
@@ -165,14 +227,12 @@ STC_INLINE bool csview_ieq(const csview* x, const csview* y)
 STC_INLINE int csview_icmp(const csview* x, const csview* y)
     { return utf8_icompare(*x, *y); }
 
-STC_INLINE bool csview_istarts_with(csview sv, const char* str) {
-    isize n = c_strlen(str);
-    return n <= sv.size && !utf8_icompare(sv, c_sv(str, n));
-}
+STC_INLINE bool csview_istarts_with(csview sv, const char* str)
+    { return _utf8_istarts_with(sv, c_sv(str, c_strlen(str))); }
 
 STC_INLINE bool csview_iends_with(csview sv, const char* str) {
     isize n = c_strlen(str);
-    return n <= sv.size && !utf8_icmp(sv.buf + sv.size - n, str);
+    return n <= sv.size && !utf8_icompare(c_sv(sv.buf + sv.size - n, n), c_sv(str, n));
 }
 
 #endif // STC_CSVIEW_H_INCLUDED
@@ -212,6 +272,15 @@ csview csview_token(csview sv, const char* sep, isize* pos) {
     return tok;
 }
 
+csview csview_token_any(csview sv, const csview_byteset* set, isize* pos) {
+    const uint8_t *b = (const uint8_t*)sv.buf + *pos, *p = b, *end = (const uint8_t*)sv.buf + sv.size;
+    while (p != end && !((set->bits[*p >> 3] >> (*p & 7)) & 1))
+        ++p;
+    csview tok = {(const char*)b, p - b};
+    *pos += tok.size + 1;
+    return tok;
+}
+
 csview csview_u8_subview(csview sv, isize u8pos, isize u8len) {
     const char* s, *end = &sv.buf[sv.size];
     while ((u8pos > 0) & (sv.buf != end))
@@ -238,6 +307,129 @@ csview_iter csview_u8_at(csview sv, isize u8pos) {
     c_assert(sv.buf != end);
     return c_literal(csview_iter){.u8 = {sv, end}};
 }
+
+/* Numbers are parsed from the start of sv, with no whitespace skipping, locale or zero terminator
+ * needed. On error, *out is unchanged. */
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+
+static const char* _csview_parse_digits(const char* p, const char* end, uint64_t* out, bool* overflow) {
+    uint64_t val = 0;
+    for (; p != end && (unsigned)(*p - '0') < 10; ++p) {
+        const unsigned d = (unsigned)(*p - '0');
+        *overflow |= val > (UINT64_MAX - d)/10;
+        val = val*10 + d;
+    }
+    *out = val;
+    return p;
+}
+
+static bool _csview_parse_word(const char* p, const char* end, const char* lower) { // ascii case-insensitive
+    for (; *lower; ++p, ++lower)
+        if (p == end || (*p | 0x20) != *lower) return false;
+    return true;
+}
+
+csview_parse_result csview_parse_u64(csview sv, uint64_t* out) {
+    const char *end = sv.buf + sv.size, *p = sv.buf + (sv.size && *sv.buf == '+');
+    uint64_t val;
+    bool overflow = false;
+    const char* q = _csview_parse_digits(p, end, &val, &overflow);
+    if (q == p) return c_literal(csview_parse_result){0, EINVAL};
+    if (!overflow) *out = val;
+    return c_literal(csview_parse_result){q - sv.buf, overflow ? ERANGE : 0};
+}
+
+csview_parse_result csview_parse_i64(csview sv, int64_t* out) {
+    const char *end = sv.buf + sv.size, *p = sv.buf;
+    const bool neg = p != end && *p == '-';
+    p += p != end && (*p == '-' || *p == '+');
+    uint64_t val;
+    bool overflow = false;
+    const char* q = _csview_parse_digits(p, end, &val, &overflow);
+    if (q == p) return c_literal(csview_parse_result){0, EINVAL};
+    overflow |= val > (uint64_t)INT64_MAX + neg;
+    if (!overflow) *out = neg ? (int64_t)(0 - val) : (int64_t)val;
+    return c_literal(csview_parse_result){q - sv.buf, overflow ? ERANGE : 0};
+}
+
+/* Up to 19 significant digits are collected in an integer. When it is at most 2^53 and the
+ * power of ten is exact in a double, the result is one correctly rounded multiply or divide.
+ * Other numbers are converted by strtod() on a copy with the locale's decimal point. */
+csview_parse_result csview_parse_double(csview sv, double* out) {
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *end = sv.buf + sv.size, *p = sv.buf;
+    const bool neg = p != end && *p == '-';
+    p += p != end && (*p == '-' || *p == '+');
+    if (_csview_parse_word(p, end, "inf") || _csview_parse_word(p, end, "nan")) {
+        const bool nan = (*p | 0x20) == 'n';
+        p += _csview_parse_word(p, end, "infinity") ? 8 : 3;
+        *out = nan ? (neg ? -NAN : NAN) : (neg ? -HUGE_VAL : HUGE_VAL);
+        return c_literal(csview_parse_result){p - sv.buf, 0};
+    }
+    uint64_t mant = 0;
+    int ndigits = 0, exp10 = 0;
+    bool truncated = false;
+    const char* num = p;
+    for (; p != end && (unsigned)(*p - '0') < 10; ++p) {
+        if (ndigits < 19) mant = mant*10 + (unsigned)(*p - '0'), ndigits += mant != 0;
+        else ++exp10, truncated |= *p != '0';
+    }
+    isize nd = p - num;
+    if (p != end && *p == '.') {
+        const char* frac = ++p;
+        for (; p != end && (unsigned)(*p - '0') < 10; ++p) {
+            if (ndigits < 19) mant = mant*10 + (unsigned)(*p - '0'), ndigits += mant != 0, --exp10;
+            else truncated |= *p != '0';
+        }
+        nd += p - frac;
+    }
+    if (nd == 0) return c_literal(csview_parse_result){0, EINVAL};
+    if (p != end && (*p | 0x20) == 'e') { // exponent is only parsed if it has digits
+        const char* q = p + 1;
+        const bool eneg = q != end && *q == '-';
+        q += q != end && (*q == '-' || *q == '+');
+        if (q != end && (unsigned)(*q - '0') < 10) {
+            int e = 0;
+            for (; q != end && (unsigned)(*q - '0') < 10; ++q)
+                if (e < 100000) e = e*10 + (*q - '0');
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+    const isize size = p - sv.buf;
+    bool exact = !truncated && mant <= (uint64_t)1 << 53 && exp10 >= -22 && exp10 <= 22 + 15;
+    if (exact)
+        for (; exp10 > 22 && (exact = mant <= ((uint64_t)1 << 53)/10); --exp10)
+            mant *= 10; // e.g. 1e30
+    double val;
+    if (mant == 0) {
+        val = 0.0;
+    } else if (exact) {
+        val = exp10 < 0 ? (double)mant / pow10[-exp10] : (double)mant * pow10[exp10];
+    } else {
+        // strtod() expects the locale's decimal point, which may be several bytes
+        const char* dp = localeconv()->decimal_point;
+        const char* dot = (const char*)memchr(sv.buf, '.', (size_t)size);
+        const isize k = dot ? dot - sv.buf : size, dplen = dot ? c_strlen(dp) : 1;
+        const isize len = size - 1 + dplen;
+        char stack[128], *buf = len < c_sizeof stack ? stack : (char*)c_malloc(len + 1);
+        c_memcpy(buf, sv.buf, k);
+        if (dot) {
+            c_memcpy(buf + k, dp, dplen);
+            c_memcpy(buf + k + dplen, dot + 1, size - k - 1);
+        }
+        buf[len] = 0;
+        val = fabs(strtod(buf, NULL));
+        if (buf != stack) c_free(buf, len + 1);
+        if (val == HUGE_VAL || val == 0.0)
+            return c_literal(csview_parse_result){size, ERANGE};
+    }
+    *out = neg ? -val : val;
+    return c_literal(csview_parse_result){size, 0};
+}
 #endif // STC_CSVIEW_C_INCLUDED
 #endif // i_implement
 
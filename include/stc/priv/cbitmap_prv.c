@@ -0,0 +1,735 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CBITMAP_PRV_C_INCLUDED
+#define STC_CBITMAP_PRV_C_INCLUDED
+
+enum { _cbm_ARRAY, _cbm_BITSET, _cbm_RUN };
+enum { _cbm_ARRAY_MAX = 4096,               // max members of array chunks
+       _cbm_BITS = 65536,
+       _cbm_WORDS = _cbm_BITS/_cbits_WB,
+       _cbm_BITSET_BYTES = _cbm_BITS/8 };
+
+#define _cbm_key(x) (uint16_t)((x) >> 16)
+#define _cbm_low(x) (uint16_t)((x) & 0xffff)
+
+// ----------------------- chunk level -----------------------
+
+static void _cbm_chunk_drop(_cbitmap_chunk* c) {
+    if (c->type == _cbm_BITSET) i_free(c->u.words, _cbm_BITSET_BYTES);
+    else i_free(c->u.vals, c->cap*c_sizeof(uint16_t));
+}
+
+static _cbitmap_chunk _cbm_chunk_clone(const _cbitmap_chunk* c) {
+    _cbitmap_chunk d = *c;
+    if (c->type == _cbm_BITSET) {
+        d.u.words = (uintptr_t*)c_memcpy(i_malloc(_cbm_BITSET_BYTES), c->u.words, _cbm_BITSET_BYTES);
+    } else {
+        d.cap = c->n;
+        d.u.vals = (uint16_t*)c_memcpy(i_malloc(c->n*c_sizeof(uint16_t)), c->u.vals, c->n*c_sizeof(uint16_t));
+    }
+    return d;
+}
+
+static void _cbm_reserve(_cbitmap_chunk* c, int32_t cap) {
+    if (cap > c->cap) {
+        if (cap < c->cap*3/2) cap = c->cap*3/2;
+        if (cap < 8) cap = 8;
+        c->u.vals = (uint16_t*)i_realloc(c->u.vals, c->cap*c_sizeof(uint16_t), cap*c_sizeof(uint16_t));
+        c->cap = cap;
+    }
+}
+
+// Index of x in sorted a[], or -(insert position) - 1.
+static int32_t _cbm_bsearch(const uint16_t* a, int32_t n, uint16_t x) {
+    int32_t lo = 0, hi = n - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (a[mid] < x) lo = mid + 1;
+        else if (a[mid] > x) hi = mid - 1;
+        else return mid;
+    }
+    return -lo - 1;
+}
+
+// Index of the last run with start <= x, or -1. Runs are pairs (start, length - 1).
+static int32_t _cbm_run_find(const _cbitmap_chunk* c, uint16_t x) {
+    int32_t lo = 0, hi = c->n/2 - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (c->u.vals[2*mid] <= x) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return hi;
+}
+
+static bool _cbm_chunk_contains(const _cbitmap_chunk* c, uint16_t x) {
+    switch (c->type) {
+        case _cbm_ARRAY: return _cbm_bsearch(c->u.vals, c->n, x) >= 0;
+        case _cbm_BITSET: return (c->u.words[x/_cbits_WB] & _cbits_bit(x)) != 0;
+    }
+    int32_t r = _cbm_run_find(c, x);
+    return r >= 0 && x - c->u.vals[2*r] <= c->u.vals[2*r + 1];
+}
+
+// Set or reset bits [lo, hi) in a bitset.
+static void _cbm_set_range(uintptr_t* w, int32_t lo, int32_t hi, bool value) {
+    if (lo >= hi) return;
+    int32_t a = lo/_cbits_WB, b = (hi - 1)/_cbits_WB;
+    uintptr_t ma = ~(_cbits_bit(lo) - 1), mb = ~(uintptr_t)0 >> (_cbits_WB - 1 - (hi - 1) % _cbits_WB);
+    if (a == b) ma &= mb, mb = ma;
+    if (value) {
+        w[a] |= ma;
+        for (int32_t i = a + 1; i < b; ++i) w[i] = ~(uintptr_t)0;
+        w[b] |= mb;
+    } else {
+        w[a] &= ~ma;
+        for (int32_t i = a + 1; i < b; ++i) w[i] = 0;
+        w[b] &= ~mb;
+    }
+}
+
+// Number of set bits in [lo, hi).
+static int32_t _cbm_range_count(const uintptr_t* w, int32_t lo, int32_t hi) {
+    int32_t a = lo/_cbits_WB, b = (hi - 1)/_cbits_WB, count = 0;
+    uintptr_t ma = ~(_cbits_bit(lo) - 1), mb = ~(uintptr_t)0 >> (_cbits_WB - 1 - (hi - 1) % _cbits_WB);
+    if (a == b) return c_popcount(w[a] & ma & mb);
+    count = c_popcount(w[a] & ma) + c_popcount(w[b] & mb);
+    for (int32_t i = a + 1; i < b; ++i) count += c_popcount(w[i]);
+    return count;
+}
+
+static void _cbm_to_bitset(_cbitmap_chunk* c) {
+    uintptr_t* w = (uintptr_t*)i_calloc(1, _cbm_BITSET_BYTES);
+    if (c->type == _cbm_ARRAY) {
+        for (int32_t i = 0; i < c->n; ++i)
+            w[c->u.vals[i]/_cbits_WB] |= _cbits_bit(c->u.vals[i]);
+    } else {
+        for (int32_t i = 0; i < c->n; i += 2)
+            _cbm_set_range(w, c->u.vals[i], c->u.vals[i] + c->u.vals[i + 1] + 1, true);
+    }
+    _cbm_chunk_drop(c);
+    c->u.words = w;
+    c->n = c->cap = 0;
+    c->type = _cbm_BITSET;
+}
+
+static void _cbm_to_array(_cbitmap_chunk* c) {
+    uint16_t* a = (uint16_t*)i_malloc(c->card*c_sizeof(uint16_t));
+    int32_t n = 0;
+    if (c->type == _cbm_BITSET) {
+        for (int32_t i = 0; i < _cbm_WORDS; ++i)
+            for (uintptr_t w = c->u.words[i]; w; w &= w - 1)
+                a[n++] = (uint16_t)(i*_cbits_WB + _cbits_ctz(w));
+    } else {
+        for (int32_t i = 0; i < c->n; i += 2)
+            for (int32_t v = c->u.vals[i], end = v + c->u.vals[i + 1]; v <= end; ++v)
+                a[n++] = (uint16_t)v;
+    }
+    _cbm_chunk_drop(c);
+    c->u.vals = a;
+    c->n = c->cap = n;
+    c->type = _cbm_ARRAY;
+}
+
+// Convert run chunks, and bitsets/arrays with the wrong cardinality, to the array/bitset representation.
+static void _cbm_normalize(_cbitmap_chunk* c) {
+    if (c->type == _cbm_RUN) {
+        if (c->card <= _cbm_ARRAY_MAX) _cbm_to_array(c);
+        else _cbm_to_bitset(c);
+    } else if (c->type == _cbm_BITSET) {
+        if (c->card <= _cbm_ARRAY_MAX) _cbm_to_array(c);
+    } else if (c->card > _cbm_ARRAY_MAX) {
+        _cbm_to_bitset(c);
+    }
+}
+
+static int32_t _cbm_count_runs(const _cbitmap_chunk* c) {
+    int32_t runs = 0;
+    if (c->type == _cbm_ARRAY) {
+        for (int32_t i = 0; i < c->n; ++i)
+            runs += (i == 0 || c->u.vals[i] != c->u.vals[i - 1] + 1);
+    } else if (c->type == _cbm_BITSET) {
+        uintptr_t carry = 0;
+        for (int32_t i = 0; i < _cbm_WORDS; ++i) { // count run starts
+            uintptr_t w = c->u.words[i];
+            runs += c_popcount(w & ~((w << 1) | carry));
+            carry = w >> (_cbits_WB - 1);
+        }
+    } else {
+        runs = c->n/2;
+    }
+    return runs;
+}
+
+static void _cbm_to_runs(_cbitmap_chunk* c, int32_t runs) {
+    uint16_t* r = (uint16_t*)i_malloc(2*runs*c_sizeof(uint16_t));
+    int32_t n = 0, start = -1, prev = -2;
+    cbitmap_bit_iter it = {0};
+    cbitmap bm = {c, 1, 1};
+    for (it = cbitmap_bit_begin(&bm); it.index >= 0; cbitmap_bit_next(&it)) {
+        int32_t v = (int32_t)(it.index & 0xffff);
+        if (v != prev + 1) {
+            if (start >= 0) r[n++] = (uint16_t)start, r[n++] = (uint16_t)(prev - start);
+            start = v;
+        }
+        prev = v;
+    }
+    r[n++] = (uint16_t)start, r[n++] = (uint16_t)(prev - start);
+    _cbm_chunk_drop(c);
+    c->u.vals = r;
+    c->n = c->cap = n;
+    c->type = _cbm_RUN;
+}
+
+static void _cbm_chunk_union(_cbitmap_chunk* a, const _cbitmap_chunk* b) {
+    if (a->type == _cbm_RUN) _cbm_normalize(a);
+    if (a->type == _cbm_ARRAY && b->type == _cbm_ARRAY && a->n + b->n <= _cbm_ARRAY_MAX) {
+        uint16_t* m = (uint16_t*)i_malloc((a->n + b->n)*c_sizeof(uint16_t));
+        int32_t i = 0, j = 0, n = 0;
+        while (i < a->n && j < b->n) {
+            uint16_t x = a->u.vals[i], y = b->u.vals[j];
+            m[n++] = x <= y ? x : y;
+            i += (x <= y), j += (y <= x);
+        }
+        while (i < a->n) m[n++] = a->u.vals[i++];
+        while (j < b->n) m[n++] = b->u.vals[j++];
+        _cbm_chunk_drop(a);
+        a->u.vals = m, a->cap = a->n + b->n;
+        a->n = a->card = n;
+        return;
+    }
+    if (a->type == _cbm_ARRAY) _cbm_to_bitset(a);
+    uintptr_t* w = a->u.words;
+    if (b->type == _cbm_ARRAY) {
+        for (int32_t i = 0; i < b->n; ++i)
+            w[b->u.vals[i]/_cbits_WB] |= _cbits_bit(b->u.vals[i]);
+    } else if (b->type == _cbm_BITSET) {
+        _cbits_or(w, b->u.words, _cbm_WORDS);
+    } else {
+        for (int32_t i = 0; i < b->n; i += 2)
+            _cbm_set_range(w, b->u.vals[i], b->u.vals[i] + b->u.vals[i + 1] + 1, true);
+    }
+    a->card = (int32_t)_cbits_count(w, _cbm_BITS);
+    _cbm_normalize(a);
+}
+
+// Keep members of array chunk a for which contains(b) == keep.
+static void _cbm_array_filter(_cbitmap_chunk* a, const _cbitmap_chunk* b, bool keep) {
+    int32_t n = 0;
+    for (int32_t i = 0; i < a->n; ++i)
+        if (_cbm_chunk_contains(b, a->u.vals[i]) == keep)
+            a->u.vals[n++] = a->u.vals[i];
+    a->n = a->card = n;
+}
+
+static void _cbm_chunk_intersect(_cbitmap_chunk* a, const _cbitmap_chunk* b) {
+    if (a->type == _cbm_RUN) _cbm_normalize(a);
+    if (a->type == _cbm_ARRAY) {
+        _cbm_array_filter(a, b, true);
+        return;
+    }
+    if (b->type == _cbm_ARRAY) { // result is a subset of b
+        _cbitmap_chunk r = _cbm_chunk_clone(b);
+        _cbm_array_filter(&r, a, true);
+        _cbm_chunk_drop(a);
+        *a = r;
+        return;
+    }
+    uintptr_t* w = a->u.words;
+    if (b->type == _cbm_BITSET) {
+        _cbits_and(w, b->u.words, _cbm_WORDS);
+    } else { // clear gaps between runs
+        int32_t lo = 0;
+        for (int32_t i = 0; i < b->n; i += 2) {
+            _cbm_set_range(w, lo, b->u.vals[i], false);
+            lo = b->u.vals[i] + b->u.vals[i + 1] + 1;
+        }
+        _cbm_set_range(w, lo, _cbm_BITS, false);
+    }
+    a->card = (int32_t)_cbits_count(w, _cbm_BITS);
+    _cbm_normalize(a);
+}
+
+static void _cbm_chunk_difference(_cbitmap_chunk* a, const _cbitmap_chunk* b) {
+    if (a->type == _cbm_RUN) _cbm_normalize(a);
+    if (a->type == _cbm_ARRAY) {
+        _cbm_array_filter(a, b, false);
+        return;
+    }
+    uintptr_t* w = a->u.words;
+    if (b->type == _cbm_ARRAY) {
+        for (int32_t i = 0; i < b->n; ++i)
+            w[b->u.vals[i]/_cbits_WB] &= ~_cbits_bit(b->u.vals[i]);
+    } else if (b->type == _cbm_BITSET) {
+        _cbits_andnot(w, b->u.words, _cbm_WORDS);
+    } else {
+        for (int32_t i = 0; i < b->n; i += 2)
+            _cbm_set_range(w, b->u.vals[i], b->u.vals[i] + b->u.vals[i + 1] + 1, false);
+    }
+    a->card = (int32_t)_cbits_count(w, _cbm_BITS);
+    _cbm_normalize(a);
+}
+
+static int32_t _cbm_chunk_and_count(const _cbitmap_chunk* a, const _cbitmap_chunk* b) {
+    int32_t count = 0;
+    if (a->type == _cbm_RUN && b->type != _cbm_RUN) c_swap(&a, &b);
+    if (a->type == _cbm_ARRAY || b->type == _cbm_ARRAY) {
+        if (b->type == _cbm_ARRAY) c_swap(&a, &b);
+        for (int32_t i = 0; i < a->n; ++i)
+            count += _cbm_chunk_contains(b, a->u.vals[i]);
+    } else if (a->type == _cbm_BITSET && b->type == _cbm_BITSET) {
+        count = (int32_t)_cbits_and_count(a->u.words, b->u.words, _cbm_BITS);
+    } else if (a->type == _cbm_BITSET) {
+        for (int32_t i = 0; i < b->n; i += 2)
+            count += _cbm_range_count(a->u.words, b->u.vals[i], b->u.vals[i] + b->u.vals[i + 1] + 1);
+    } else { // overlap of two run lists
+        int32_t i = 0, j = 0;
+        while (i < a->n && j < b->n) {
+            int32_t a0 = a->u.vals[i], a1 = a0 + a->u.vals[i + 1];
+            int32_t b0 = b->u.vals[j], b1 = b0 + b->u.vals[j + 1];
+            int32_t lo = a0 > b0 ? a0 : b0, hi = a1 < b1 ? a1 : b1;
+            if (lo <= hi) count += hi - lo + 1;
+            if (a1 < b1) i += 2; else j += 2;
+        }
+    }
+    return count;
+}
+
+// ----------------------- bitmap level -----------------------
+
+// Index of chunk with key, or -(insert position) - 1.
+static int32_t _cbm_find(const cbitmap* self, uint16_t key) {
+    int32_t lo = 0, hi = self->size - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (self->chunk[mid].key < key) lo = mid + 1;
+        else if (self->chunk[mid].key > key) hi = mid - 1;
+        else return mid;
+    }
+    return -lo - 1;
+}
+
+static void _cbm_reserve_chunks(cbitmap* self, int32_t cap) {
+    if (cap > self->cap) {
+        if (cap < self->cap*3/2) cap = self->cap*3/2;
+        if (cap < 4) cap = 4;
+        self->chunk = (_cbitmap_chunk*)i_realloc(self->chunk, self->cap*c_sizeof(_cbitmap_chunk),
+                                                 cap*c_sizeof(_cbitmap_chunk));
+        self->cap = cap;
+    }
+}
+
+static _cbitmap_chunk* _cbm_insert_chunk(cbitmap* self, int32_t idx, uint16_t key, uint8_t type) {
+    _cbm_reserve_chunks(self, self->size + 1);
+    _cbitmap_chunk* c = self->chunk + idx;
+    c_memmove(c + 1, c, (self->size - idx)*c_sizeof *c);
+    ++self->size;
+    memset(c, 0, sizeof *c);
+    c->key = key;
+    c->type = type;
+    if (type == _cbm_BITSET)
+        c->u.words = (uintptr_t*)i_calloc(1, _cbm_BITSET_BYTES);
+    return c;
+}
+
+static void _cbm_erase_chunk(cbitmap* self, int32_t idx) {
+    _cbm_chunk_drop(&self->chunk[idx]);
+    c_memmove(self->chunk + idx, self->chunk + idx + 1, (self->size - idx - 1)*c_sizeof(_cbitmap_chunk));
+    --self->size;
+}
+
+STC_DEF void cbitmap_drop(cbitmap* self) {
+    cbitmap_clear(self);
+    i_free(self->chunk, self->cap*c_sizeof(_cbitmap_chunk));
+}
+
+STC_DEF void cbitmap_clear(cbitmap* self) {
+    for (int32_t i = 0; i < self->size; ++i)
+        _cbm_chunk_drop(&self->chunk[i]);
+    self->size = 0;
+}
+
+STC_DEF cbitmap cbitmap_clone(cbitmap other) {
+    cbitmap bm = {0};
+    _cbm_reserve_chunks(&bm, other.size);
+    for (int32_t i = 0; i < other.size; ++i)
+        bm.chunk[i] = _cbm_chunk_clone(&other.chunk[i]);
+    bm.size = other.size;
+    return bm;
+}
+
+STC_DEF bool cbitmap_contains(const cbitmap* self, uint32_t x) {
+    int32_t i = _cbm_find(self, _cbm_key(x));
+    return i >= 0 && _cbm_chunk_contains(&self->chunk[i], _cbm_low(x));
+}
+
+STC_DEF bool cbitmap_add(cbitmap* self, uint32_t x) {
+    const uint16_t low = _cbm_low(x);
+    int32_t i = _cbm_find(self, _cbm_key(x));
+    _cbitmap_chunk* c = i >= 0 ? &self->chunk[i]
+                               : _cbm_insert_chunk(self, -i - 1, _cbm_key(x), _cbm_ARRAY);
+    if (c->type == _cbm_RUN) {
+        if (_cbm_chunk_contains(c, low)) return false;
+        _cbm_normalize(c);
+    }
+    if (c->type == _cbm_BITSET) {
+        uintptr_t* w = &c->u.words[low/_cbits_WB];
+        if (*w & _cbits_bit(low)) return false;
+        *w |= _cbits_bit(low);
+        ++c->card;
+        return true;
+    }
+    int32_t j = _cbm_bsearch(c->u.vals, c->n, low);
+    if (j >= 0) return false;
+    j = -j - 1;
+    _cbm_reserve(c, c->n + 1);
+    c_memmove(c->u.vals + j + 1, c->u.vals + j, (c->n - j)*c_sizeof(uint16_t));
+    c->u.vals[j] = low;
+    c->card = ++c->n;
+    if (c->card > _cbm_ARRAY_MAX) _cbm_to_bitset(c);
+    return true;
+}
+
+STC_DEF void cbitmap_add_range(cbitmap* self, uint32_t start, uint64_t end) {
+    if (end > (uint64_t)UINT32_MAX + 1) end = (uint64_t)UINT32_MAX + 1;
+    for (uint64_t lo = start; lo < end; ) {
+        const uint16_t key = (uint16_t)(lo >> 16);
+        const uint64_t hi = end < ((uint64_t)key + 1) << 16 ? end : ((uint64_t)key + 1) << 16;
+        const int32_t a = (int32_t)(lo & 0xffff), b = (int32_t)(hi - ((uint64_t)key << 16));
+        int32_t i = _cbm_find(self, key);
+        _cbitmap_chunk* c;
+        if (i < 0) { // new chunk: a single run
+            c = _cbm_insert_chunk(self, -i - 1, key, _cbm_RUN);
+            _cbm_reserve(c, 2);
+            c->u.vals[0] = (uint16_t)a, c->u.vals[1] = (uint16_t)(b - a - 1);
+            c->n = 2, c->card = b - a;
+        } else {
+            c = &self->chunk[i];
+            if (c->type != _cbm_BITSET) _cbm_to_bitset(c);
+            _cbm_set_range(c->u.words, a, b, true);
+            c->card = (int32_t)_cbits_count(c->u.words, _cbm_BITS);
+            _cbm_normalize(c);
+        }
+        lo = hi;
+    }
+}
+
+STC_DEF bool cbitmap_remove(cbitmap* self, uint32_t x) {
+    const uint16_t low = _cbm_low(x);
+    int32_t i = _cbm_find(self, _cbm_key(x));
+    if (i < 0 || !_cbm_chunk_contains(&self->chunk[i], low))
+        return false;
+    _cbitmap_chunk* c = &self->chunk[i];
+    if (c->type == _cbm_RUN) _cbm_normalize(c);
+    if (c->type == _cbm_BITSET) {
+        c->u.words[low/_cbits_WB] &= ~_cbits_bit(low);
+        if (--c->card <= _cbm_ARRAY_MAX) _cbm_to_array(c);
+    } else {
+        int32_t j = _cbm_bsearch(c->u.vals, c->n, low);
+        c_memmove(c->u.vals + j, c->u.vals + j + 1, (c->n - j - 1)*c_sizeof(uint16_t));
+        c->card = --c->n;
+    }
+    if (c->card == 0) _cbm_erase_chunk(self, i);
+    return true;
+}
+
+STC_DEF int64_t cbitmap_count(const cbitmap* self) {
+    int64_t count = 0;
+    for (int32_t i = 0; i < self->size; ++i)
+        count += self->chunk[i].card;
+    return count;
+}
+
+STC_DEF void cbitmap_union(cbitmap* self, const cbitmap* other) {
+    if (other->size == 0 || self->chunk == other->chunk) return;
+    cbitmap out = {0};
+    int32_t i = 0, j = 0;
+    _cbm_reserve_chunks(&out, self->size + other->size);
+    while (i < self->size || j < other->size) {
+        if (j == other->size || (i < self->size && self->chunk[i].key < other->chunk[j].key)) {
+            out.chunk[out.size++] = self->chunk[i++];
+        } else if (i == self->size || other->chunk[j].key < self->chunk[i].key) {
+            out.chunk[out.size++] = _cbm_chunk_clone(&other->chunk[j++]);
+        } else {
+            _cbm_chunk_union(&self->chunk[i], &other->chunk[j++]);
+            out.chunk[out.size++] = self->chunk[i++];
+        }
+    }
+    i_free(self->chunk, self->cap*c_sizeof(_cbitmap_chunk));
+    *self = out;
+}
+
+STC_DEF void cbitmap_intersect(cbitmap* self, const cbitmap* other) {
+    if (self->chunk == other->chunk) return;
+    int32_t i = 0, j = 0, n = 0;
+    for (; i < self->size; ++i) {
+        _cbitmap_chunk* c = &self->chunk[i];
+        while (j < other->size && other->chunk[j].key < c->key) ++j;
+        if (j < other->size && other->chunk[j].key == c->key)
+            _cbm_chunk_intersect(c, &other->chunk[j]);
+        else
+            c->card = 0;
+        if (c->card == 0) _cbm_chunk_drop(c);
+        else self->chunk[n++] = *c;
+    }
+    self->size = n;
+}
+
+STC_DEF void cbitmap_difference(cbitmap* self, const cbitmap* other) {
+    if (self->chunk == other->chunk) { cbitmap_clear(self); return; }
+    int32_t i = 0, j = 0, n = 0;
+    for (; i < self->size; ++i) {
+        _cbitmap_chunk* c = &self->chunk[i];
+        while (j < other->size && other->chunk[j].key < c->key) ++j;
+        if (j < other->size && other->chunk[j].key == c->key)
+            _cbm_chunk_difference(c, &other->chunk[j]);
+        if (c->card == 0) _cbm_chunk_drop(c);
+        else self->chunk[n++] = *c;
+    }
+    self->size = n;
+}
+
+STC_DEF int64_t cbitmap_and_count(const cbitmap* self, const cbitmap* other) {
+    int64_t count = 0;
+    int32_t i = 0, j = 0;
+    while (i < self->size && j < other->size) {
+        const uint16_t ki = self->chunk[i].key, kj = other->chunk[j].key;
+        if (ki == kj) count += _cbm_chunk_and_count(&self->chunk[i], &other->chunk[j]);
+        i += (ki <= kj), j += (kj <= ki);
+    }
+    return count;
+}
+
+STC_DEF bool cbitmap_run_optimize(cbitmap* self) {
+    bool has_runs = false;
+    for (int32_t i = 0; i < self->size; ++i) {
+        _cbitmap_chunk* c = &self->chunk[i];
+        const int32_t runs = _cbm_count_runs(c);
+        const isize run_bytes = 2 + 4*(isize)runs;
+        const isize bytes = c->card <= _cbm_ARRAY_MAX ? 2*(isize)c->card : _cbm_BITSET_BYTES;
+        if (run_bytes < bytes) {
+            if (c->type != _cbm_RUN) _cbm_to_runs(c, runs);
+            has_runs = true;
+        } else if (c->type == _cbm_RUN) {
+            _cbm_normalize(c);
+        }
+    }
+    return has_runs;
+}
+
+// ----------------------- iteration -----------------------
+
+static void _cbm_iter_chunk(cbitmap_bit_iter* it) {
+    it->_pos = it->_ci < it->_bm->size && it->_bm->chunk[it->_ci].type == _cbm_BITSET ? -1 : 0;
+    it->_word = 0;
+}
+
+STC_DEF cbitmap_bit_iter cbitmap_bit_begin(const cbitmap* self) {
+    cbitmap_bit_iter it = {0, self, 0, 0, 0};
+    _cbm_iter_chunk(&it);
+    cbitmap_bit_next(&it);
+    return it;
+}
+
+STC_DEF void cbitmap_bit_next(cbitmap_bit_iter* it) {
+    const cbitmap* bm = it->_bm;
+    for (; it->_ci < bm->size; ++it->_ci, _cbm_iter_chunk(it)) {
+        const _cbitmap_chunk* c = &bm->chunk[it->_ci];
+        const int64_t base = (int64_t)c->key << 16;
+        if (c->type == _cbm_ARRAY) {
+            if (it->_pos < c->n) {
+                it->index = base + c->u.vals[it->_pos++];
+                return;
+            }
+        } else if (c->type == _cbm_BITSET) {
+            while (it->_word == 0 && ++it->_pos < _cbm_WORDS)
+                it->_word = c->u.words[it->_pos];
+            if (it->_word) {
+                it->index = base + it->_pos*_cbits_WB + _cbits_ctz(it->_word);
+                it->_word &= it->_word - 1;
+                return;
+            }
+        } else if (it->_pos < c->n) { // _word: offset within current run
+            it->index = base + c->u.vals[it->_pos] + (int64_t)it->_word;
+            if (it->_word++ == c->u.vals[it->_pos + 1]) {
+                it->_word = 0;
+                it->_pos += 2;
+            }
+            return;
+        }
+    }
+    it->index = -1;
+}
+
+// ----------------------- serialization -----------------------
+
+enum { _cbm_COOKIE_NO_RUNS = 12346, _cbm_COOKIE = 12347, _cbm_NO_OFFSET_THRESHOLD = 4 };
+
+static char* _cbm_put16(char* p, uint32_t v)
+    { p[0] = (char)(v & 0xff), p[1] = (char)(v >> 8 & 0xff); return p + 2; }
+static char* _cbm_put32(char* p, uint32_t v)
+    { return _cbm_put16(_cbm_put16(p, v & 0xffff), v >> 16); }
+static uint32_t _cbm_get16(const char* p)
+    { return (uint32_t)(uint8_t)p[0] | (uint32_t)(uint8_t)p[1] << 8; }
+static uint32_t _cbm_get32(const char* p)
+    { return _cbm_get16(p) | _cbm_get16(p + 2) << 16; }
+
+static isize _cbm_chunk_bytes(const _cbitmap_chunk* c) {
+    switch (c->type) {
+        case _cbm_ARRAY: return 2*(isize)c->n;
+        case _cbm_BITSET: return _cbm_BITSET_BYTES;
+    }
+    return 2 + 2*(isize)c->n;
+}
+
+static bool _cbm_has_runs(const cbitmap* self) {
+    for (int32_t i = 0; i < self->size; ++i)
+        if (self->chunk[i].type == _cbm_RUN) return true;
+    return false;
+}
+
+static isize _cbm_header_bytes(const cbitmap* self, bool has_runs) {
+    const isize n = self->size;
+    if (has_runs)
+        return 4 + (n + 7)/8 + 4*n + (n >= _cbm_NO_OFFSET_THRESHOLD ? 4*n : 0);
+    return 8 + 4*n + 4*n;
+}
+
+STC_DEF isize cbitmap_serialized_size(const cbitmap* self) {
+    isize bytes = _cbm_header_bytes(self, _cbm_has_runs(self));
+    for (int32_t i = 0; i < self->size; ++i)
+        bytes += _cbm_chunk_bytes(&self->chunk[i]);
+    return bytes;
+}
+
+STC_DEF isize cbitmap_serialize(const cbitmap* self, char* buf) {
+    const bool has_runs = _cbm_has_runs(self);
+    const int32_t n = self->size;
+    uint32_t offset = (uint32_t)_cbm_header_bytes(self, has_runs);
+    char* p = buf;
+
+    if (has_runs) {
+        p = _cbm_put32(p, _cbm_COOKIE | (uint32_t)(n - 1) << 16);
+        memset(p, 0, (size_t)(n + 7)/8);
+        for (int32_t i = 0; i < n; ++i)
+            if (self->chunk[i].type == _cbm_RUN) p[i/8] = (char)(p[i/8] | 1 << (i % 8));
+        p += (n + 7)/8;
+    } else {
+        p = _cbm_put32(_cbm_put32(p, _cbm_COOKIE_NO_RUNS), (uint32_t)n);
+    }
+    for (int32_t i = 0; i < n; ++i)
+        p = _cbm_put16(_cbm_put16(p, self->chunk[i].key), (uint32_t)(self->chunk[i].card - 1));
+    if (!has_runs || n >= _cbm_NO_OFFSET_THRESHOLD) {
+        for (int32_t i = 0; i < n; ++i) {
+            p = _cbm_put32(p, offset);
+            offset += (uint32_t)_cbm_chunk_bytes(&self->chunk[i]);
+        }
+    }
+    for (int32_t i = 0; i < n; ++i) {
+        const _cbitmap_chunk* c = &self->chunk[i];
+        if (c->type == _cbm_BITSET) {
+            for (int32_t k = 0; k < _cbm_BITSET_BYTES; ++k)  // little endian 64-bit words
+                *p++ = (char)(c->u.words[k/_cbits_WS] >> 8*(k % _cbits_WS) & 0xff);
+            continue;
+        }
+        if (c->type == _cbm_RUN)
+            p = _cbm_put16(p, (uint32_t)(c->n/2));
+        for (int32_t k = 0; k < c->n; ++k)
+            p = _cbm_put16(p, c->u.vals[k]);
+    }
+    return p - buf;
+}
+
+STC_DEF bool cbitmap_deserialize(cbitmap* self, const char* buf, isize len) {
+    const char* p = buf, *end = buf + len, *runflags = NULL;
+    cbitmap bm = {0};
+    int32_t n;
+    if (len < 4) return false;
+    const uint32_t cookie = _cbm_get32(p);
+    p += 4;
+    if ((cookie & 0xffff) == _cbm_COOKIE) {
+        n = (int32_t)(cookie >> 16) + 1;
+        runflags = p;
+        p += (n + 7)/8;
+    } else if (cookie == _cbm_COOKIE_NO_RUNS && len >= 8) {
+        n = (int32_t)_cbm_get32(p);
+        p += 4;
+    } else {
+        return false;
+    }
+    if (n > 65536 || end - p < 4*(isize)n) return false;
+    const char* desc = p;
+    p += 4*n;
+    if (!runflags || n >= _cbm_NO_OFFSET_THRESHOLD)
+        p += 4*n; // skip offsets
+    _cbm_reserve_chunks(&bm, n);
+
+    for (int32_t i = 0; i < n; ++i) {
+        _cbitmap_chunk c = {0};
+        c.key = (uint16_t)_cbm_get16(desc + 4*i);
+        c.card = (int32_t)_cbm_get16(desc + 4*i + 2) + 1;
+        if ((i > 0 && c.key <= bm.chunk[i - 1].key) || p > end) goto fail;
+        if (runflags && (runflags[i/8] >> (i % 8) & 1)) {
+            if (end - p < 2) goto fail;
+            c.type = _cbm_RUN;
+            c.n = c.cap = 2*(int32_t)_cbm_get16(p);
+            p += 2;
+        } else {
+            c.type = c.card <= _cbm_ARRAY_MAX ? _cbm_ARRAY : _cbm_BITSET;
+            c.n = c.cap = c.type == _cbm_ARRAY ? c.card : 0;
+        }
+        if (end - p < _cbm_chunk_bytes(&c) - (c.type == _cbm_RUN ? 2 : 0)) goto fail;
+
+        if (c.type == _cbm_BITSET) {
+            c.u.words = (uintptr_t*)i_calloc(1, _cbm_BITSET_BYTES);
+            for (int32_t k = 0; k < _cbm_BITSET_BYTES; ++k)
+                c.u.words[k/_cbits_WS] |= (uintptr_t)(uint8_t)*p++ << 8*(k % _cbits_WS);
+        } else {
+            c.u.vals = (uint16_t*)i_malloc(c.n*c_sizeof(uint16_t));
+            for (int32_t k = 0; k < c.n; ++k, p += 2)
+                c.u.vals[k] = (uint16_t)_cbm_get16(p);
+        }
+        bm.chunk[bm.size++] = c;
+        if (c.type == _cbm_RUN) { // runs must be sorted and non-overlapping
+            int32_t card = 0;
+            for (int32_t k = 0; k < c.n; k += 2) {
+                if (c.u.vals[k] + c.u.vals[k + 1] > 0xffff) goto fail;
+                if (k > 0 && c.u.vals[k] <= c.u.vals[k - 2] + c.u.vals[k - 1]) goto fail;
+                card += c.u.vals[k + 1] + 1;
+            }
+            if (card != c.card) goto fail; // also rejects an empty chunk
+        } else if (c.type == _cbm_ARRAY) { // values must be sorted and unique
+            for (int32_t k = 1; k < c.n; ++k)
+                if (c.u.vals[k] <= c.u.vals[k - 1]) goto fail;
+        } else if (_cbits_count(c.u.words, _cbm_BITS) != c.card) {
+            goto fail; // a bitset must hold more than _cbm_ARRAY_MAX values
+        }
+    }
+    cbitmap_take(self, bm);
+    return true;
+
+    fail: cbitmap_drop(&bm);
+    return false;
+}
+
+#endif // STC_CBITMAP_PRV_C_INCLUDED
@@ -0,0 +1,112 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CCSV_PRV_C_INCLUDED
+#define STC_CCSV_PRV_C_INCLUDED
+
+#if defined __SSE2__ && defined __GNUC__
+  #include <emmintrin.h>
+  #define _ccsv_SSE2
+#endif
+
+// end of an unquoted field: the first delimiter, '\r' or '\n' from p, or end.
+static const char* _ccsv_scan(const char* p, const char* end, char delim) {
+  #if defined _ccsv_SSE2
+    const __m128i vd = _mm_set1_epi8(delim), vr = _mm_set1_epi8('\r'), vn = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)p);
+        const unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, vd),
+                                  _mm_or_si128(_mm_cmpeq_epi8(v, vr), _mm_cmpeq_epi8(v, vn))));
+        if (mask) return p + __builtin_ctz(mask);
+    }
+  #endif
+    while (p != end && *p != delim && *p != '\n' && *p != '\r')
+        ++p;
+    return p;
+}
+
+// quoted field from p, after the opening quote. Returns the position after the field.
+// A field which must be unescaped is appended to the row buffer, and gets a NULL buf.
+static const char* _ccsv_quoted(ccsv* self, const char* p, const char* end, csview* field) {
+    const char* q = (const char*)memchr(p, self->quote, (size_t)(end - p));
+    const char* r = q ? q + 1 : end;
+    if (q && (r == end || *r == self->delim || *r == '\n' || *r == '\r')) {
+        *field = c_sv(p, q - p); // no escaped quotes: a view into the input
+        return r;
+    }
+    const isize start = cstr_size(&self->_unquoted);
+    for (;;) {
+        if (q == NULL) { // unterminated: the rest of the input
+            cstr_append_n(&self->_unquoted, p, end - p);
+            p = end;
+            break;
+        }
+        cstr_append_n(&self->_unquoted, p, q - p);
+        if (q + 1 != end && q[1] == self->quote) { // "" is an escaped quote
+            cstr_append_n(&self->_unquoted, q, 1);
+            p = q + 2;
+            q = (const char*)memchr(p, self->quote, (size_t)(end - p));
+        } else { // text after the closing quote is kept as is
+            const char* e = _ccsv_scan(q + 1, end, self->delim);
+            cstr_append_n(&self->_unquoted, q + 1, e - q - 1);
+            p = e;
+            break;
+        }
+    }
+    *field = c_sv(NULL, cstr_size(&self->_unquoted) - start);
+    return p;
+}
+
+isize ccsv_read_row(ccsv* self, csview fields[], isize cap) {
+    const char *p = self->input.buf + self->pos, *end = self->input.buf + self->input.size;
+    if (p >= end) return -1;
+    cstr_clear(&self->_unquoted);
+    isize n = 0;
+    bool unescaped = false;
+    if (*p != '\n' && *p != '\r') for (;;) {
+        csview f;
+        if (p != end && *p == self->quote && self->quote) {
+            p = _ccsv_quoted(self, p + 1, end, &f);
+            unescaped |= f.buf == NULL;
+        } else {
+            const char* e = _ccsv_scan(p, end, self->delim);
+            f = c_sv(p, e - p);
+            p = e;
+        }
+        if (n < cap) fields[n] = f;
+        ++n;
+        if (p == end || *p != self->delim) break;
+        ++p;
+    }
+    if (p != end) // \n, \r\n or \r
+        p += (*p == '\r' && p + 1 != end && p[1] == '\n') + 1;
+    self->pos = p - self->input.buf;
+
+    if (unescaped) { // the row buffer may have moved while it grew, so set the pointers last
+        const char* s = cstr_str(&self->_unquoted);
+        for (isize i = 0; i < n && i < cap; ++i)
+            if (fields[i].buf == NULL) fields[i].buf = s, s += fields[i].size;
+    }
+    return n;
+}
+
+#endif // STC_CCSV_PRV_C_INCLUDED
@@ -0,0 +1,149 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CINTERN_PRV_C_INCLUDED
+#define STC_CINTERN_PRV_C_INCLUDED
+
+// Entry arrays and hash tables are replaced when they grow, but the old ones are kept until
+// cintern_drop(), so that lock-free readers never see freed memory. This costs at most the
+// size of the current ones.
+struct _cintern_block {
+    struct _cintern_block* next;
+    isize size;
+    size_t data[];
+};
+
+enum { _cintern_ARENA_MIN = 1 << 12, _cintern_ARENA_MAX = 1 << 20 };
+
+static void* _cintern_alloc(struct _cintern_block** list, isize size) {
+    struct _cintern_block* b = (struct _cintern_block*)i_malloc(c_sizeof(struct _cintern_block) + size);
+    b->next = *list, b->size = size;
+    *list = b;
+    return b->data;
+}
+
+static void _cintern_free(struct _cintern_block* b) {
+    while (b) {
+        struct _cintern_block* next = b->next;
+        i_free(b, c_sizeof(struct _cintern_block) + b->size);
+        b = next;
+    }
+}
+
+static size_t _cintern_slot(size_t hash, unsigned bits) // fibonacci hashing: use the high bits
+    { return (size_t)(((uint64_t)hash*0x9E3779B97F4A7C15u) >> (64 - bits)); }
+
+static catom _cintern_lookup(const cintern* self, csview sv, size_t hash) {
+    const uint32_t* table = _cintern_load(&self->table);
+    if (table == NULL)
+        return 0;
+    const size_t mask = ((size_t)1 << table[0]) - 1;
+    for (size_t i = _cintern_slot(hash, table[0]); ; i = (i + 1) & mask) {
+        const catom atom = _cintern_load(&table[1 + i]);
+        if (atom == 0)
+            return 0;
+        const _cintern_entry* e = &_cintern_load(&self->entry)[atom];
+        if (e->hash == hash && e->size == sv.size && !c_memcmp(e->str, sv.buf, sv.size))
+            return atom;
+    }
+}
+
+static char* _cintern_strdup(cintern* self, csview sv) {
+    char* str;
+    if (sv.size + 1 > self->bump_end - self->bump) {
+        isize block = self->arena ? self->arena->size*2 : _cintern_ARENA_MIN;
+        if (block > _cintern_ARENA_MAX) block = _cintern_ARENA_MAX;
+        if (sv.size + 1 > block/4) { // large string: own block, keep the current one
+            str = (char*)_cintern_alloc(&self->store, sv.size + 1);
+            goto copy;
+        }
+        self->bump = (char*)_cintern_alloc(&self->arena, block);
+        self->bump_end = self->bump + block;
+    }
+    str = self->bump;
+    self->bump += sv.size + 1;
+    copy:
+    c_memcpy(str, sv.buf, sv.size);
+    str[sv.size] = '\0';
+    return str;
+}
+
+static catom _cintern_insert(cintern* self, csview sv, size_t hash) {
+    const uint32_t n = self->size ? self->size : 1; // new atom
+    if (n == UINT32_MAX)
+        return 0;
+    if (n >= self->cap) {
+        const uint32_t cap = self->cap == 0 ? 64 : self->cap > UINT32_MAX/2 ? UINT32_MAX : self->cap*2;
+        _cintern_entry* entry = (_cintern_entry*)_cintern_alloc(&self->store, cap*c_sizeof(_cintern_entry));
+        if (self->entry) c_memcpy(entry, self->entry, n*c_sizeof(_cintern_entry));
+        else entry[0] = c_literal(_cintern_entry){"", 0, 0};
+        _cintern_store(&self->entry, entry);
+        self->cap = cap;
+    }
+    unsigned bits = self->table ? self->table[0] : 0;
+    if ((uint64_t)n*2 > ((uint64_t)1 << bits)) { // keep the load factor <= 1/2
+        bits = bits ? bits + 1 : 8;
+        const size_t nslots = (size_t)1 << bits, mask = nslots - 1;
+        uint32_t* table = (uint32_t*)_cintern_alloc(&self->store, (isize)(nslots + 1)*c_sizeof(uint32_t));
+        c_memset(table + 1, 0, (isize)nslots*c_sizeof(uint32_t));
+        table[0] = bits;
+        for (uint32_t a = 1; a < n; ++a) {
+            size_t i = _cintern_slot(self->entry[a].hash, bits);
+            while (table[1 + i]) i = (i + 1) & mask;
+            table[1 + i] = a;
+        }
+        _cintern_store(&self->table, table);
+    }
+
+    self->entry[n] = c_literal(_cintern_entry){_cintern_strdup(self, sv), sv.size, hash};
+    _cintern_store(&self->size, n + 1);
+    const size_t mask = ((size_t)1 << bits) - 1;
+    size_t i = _cintern_slot(hash, bits);
+    while (self->table[1 + i]) i = (i + 1) & mask;
+    _cintern_store(&self->table[1 + i], n); // publishes the atom to lock-free lookups
+    return n;
+}
+
+STC_DEF catom cintern_find(const cintern* self, csview sv)
+    { return _cintern_lookup(self, sv, c_hash_n(sv.buf, sv.size)); }
+
+STC_DEF catom cintern_intern(cintern* self, csview sv) {
+    const size_t hash = c_hash_n(sv.buf, sv.size);
+    catom atom = _cintern_lookup(self, sv, hash);
+    if (atom)
+        return atom;
+    while (!_cintern_trylock(&self->lock))
+        while (_cintern_load(&self->lock)) {}
+    atom = _cintern_lookup(self, sv, hash); // inserted by another thread meanwhile?
+    if (atom == 0)
+        atom = _cintern_insert(self, sv, hash);
+    _cintern_unlock(&self->lock);
+    return atom;
+}
+
+STC_DEF void cintern_drop(cintern* self) {
+    _cintern_free(self->arena);
+    _cintern_free(self->store);
+    *self = cintern_init();
+}
+
+#endif // STC_CINTERN_PRV_C_INCLUDED
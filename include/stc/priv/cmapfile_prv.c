@@ -0,0 +1,156 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CMAPFILE_PRV_C_INCLUDED
+#define STC_CMAPFILE_PRV_C_INCLUDED
+
+#if defined __unix__ || defined __APPLE__
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #define _cmapfile_POSIX
+#endif
+
+enum { _cmapfile_BLOCK = 1 << 16 };
+
+static cmapfile _cmapfile_empty(void) {
+    cmapfile f = {.sv = {"", 0}};
+    return f;
+}
+
+#if defined _cmapfile_POSIX
+/* read until end of file from fd into a growing heap buffer */
+static cmapfile _cmapfile_read_fd(int fd, isize hint) {
+    cmapfile f = _cmapfile_empty();
+    isize cap = hint > 0 ? hint + 1 : _cmapfile_BLOCK, len = 0;
+    char* buf = (char*)i_malloc(cap);
+    for (ssize_t n; buf != NULL; len += n) {
+        if (len == cap) {
+            char* nbuf = (char*)i_realloc(buf, cap, cap*2);
+            if (nbuf == NULL) { i_free(buf, cap); buf = NULL; break; }
+            buf = nbuf, cap *= 2;
+        }
+        while ((n = read(fd, buf + len, (size_t)(cap - len))) < 0 && errno == EINTR) ;
+        if (n <= 0) {
+            if (n < 0) { i_free(buf, cap); buf = NULL; }
+            break;
+        }
+    }
+    if (buf == NULL) { f.sv.buf = NULL; return f; }
+    f._base = buf, f._size = cap;
+    f.sv = c_sv(buf, len);
+    return f;
+}
+#endif
+
+STC_DEF cmapfile cmapfile_from_stream(FILE* fp) {
+    cmapfile f = _cmapfile_empty();
+    isize cap = _cmapfile_BLOCK, len = 0;
+    char* buf = (char*)i_malloc(cap);
+    while (buf != NULL) {
+        len += (isize)fread(buf + len, 1, (size_t)(cap - len), fp);
+        if (len < cap) break;
+        char* nbuf = (char*)i_realloc(buf, cap, cap*2);
+        if (nbuf == NULL) { i_free(buf, cap); buf = NULL; break; }
+        buf = nbuf, cap *= 2;
+    }
+    if (buf == NULL || ferror(fp)) {
+        if (buf) i_free(buf, cap);
+        f.sv.buf = NULL;
+        return f;
+    }
+    f._base = buf, f._size = cap;
+    f.sv = c_sv(buf, len);
+    return f;
+}
+
+STC_DEF cmapfile cmapfile_open(const char* path, int flags) {
+  #if defined _cmapfile_POSIX
+    cmapfile f = _cmapfile_empty();
+    struct stat st;
+  #if !defined POSIX_MADV_SEQUENTIAL
+    /* posix_madvise() is not declared: a system header was included before stc/cmapfile.h
+     * in the implementing unit, without a feature macro such as _DEFAULT_SOURCE. */
+    if (flags & (cmapfile_SEQUENTIAL | cmapfile_RANDOM)) {
+        errno = EINVAL;
+        f.sv.buf = NULL;
+        return f;
+    }
+  #endif
+  #if defined O_CLOEXEC
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  #else
+    const int fd = open(path, O_RDONLY);
+  #endif
+    if (fd < 0) { f.sv.buf = NULL; return f; }
+
+    const bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (regular && st.st_size > 0) {
+        int mflags = MAP_PRIVATE;
+      #if defined MAP_POPULATE
+        if (flags & cmapfile_POPULATE) mflags |= MAP_POPULATE;
+      #endif
+        void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, mflags, fd, 0);
+        if (base != MAP_FAILED) {
+          #if defined POSIX_MADV_SEQUENTIAL
+            if (flags & cmapfile_SEQUENTIAL)
+                posix_madvise(base, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+            else if (flags & cmapfile_RANDOM)
+                posix_madvise(base, (size_t)st.st_size, POSIX_MADV_RANDOM);
+          #endif
+            close(fd);
+            f._base = base, f._size = (isize)st.st_size, f._mapped = 1;
+            f.sv = c_sv((const char*)base, (isize)st.st_size);
+            return f;
+        }
+    }
+    // pipes, character devices, /proc files, or mmap failure
+    f = _cmapfile_read_fd(fd, regular ? (isize)st.st_size : 0);
+    close(fd);
+    return f;
+  #else
+    (void)flags;
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        cmapfile f = _cmapfile_empty();
+        f.sv.buf = NULL;
+        return f;
+    }
+    cmapfile f = cmapfile_from_stream(fp);
+    fclose(fp);
+    return f;
+  #endif
+}
+
+STC_DEF void cmapfile_drop(cmapfile* self) {
+  #if defined _cmapfile_POSIX
+    if (self->_mapped) munmap(self->_base, (size_t)self->_size);
+    else
+  #endif
+    if (self->_base) i_free(self->_base, self->_size);
+    self->_base = NULL, self->_size = 0;
+    self->sv = c_sv("", 0);
+}
+
+#endif // STC_CMAPFILE_PRV_C_INCLUDED
@@ -0,0 +1,230 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CMULTISEARCHER_PRV_C_INCLUDED
+#define STC_CMULTISEARCHER_PRV_C_INCLUDED
+
+enum { _cms_DENSE_MAX = 1 << 22 }; // max transitions in the dense table (16 MB)
+
+STC_INLINE int32_t _cms_next(const cmultisearcher* self, int32_t s, unsigned c) {
+    if (self->dense)
+        return self->delta[s*self->nclasses + (int32_t)c];
+    for (;;) {
+        if (s == 0)
+            return self->delta[c];
+        for (int32_t e = self->child[s]; e != 0; e = self->sibling[e])
+            if (self->label[e] == c) return e;
+        s = self->fail[s];
+    }
+}
+
+static int32_t _cms_goto(const cmultisearcher* self, int32_t s, unsigned c) {
+    for (int32_t e = self->child[s]; e != 0; e = self->sibling[e])
+        if (self->label[e] == c) return e;
+    return 0;
+}
+
+STC_DEF cmultisearcher cmultisearcher_make(const csview needles[], isize n, int flags) {
+    cmultisearcher ms = {.npatterns = (int32_t)n};
+    isize total = 1;
+    int32_t ncls = 1;
+
+    // byte classes: one class per distinct needle byte (case folded with ICASE), 0 for the rest
+    for (isize i = 0; i < n; ++i) {
+        total += needles[i].size;
+        for (isize j = 0; j < needles[i].size; ++j) {
+            unsigned c = (uint8_t)needles[i].buf[j];
+            if ((flags & cmultisearcher_ICASE) && c - 'A' < 26U) c += 32;
+            if (ms.classes[c] == 0) ms.classes[c] = (uint16_t)ncls++;
+        }
+    }
+    if (flags & cmultisearcher_ICASE)
+        for (unsigned c = 'A'; c <= 'Z'; ++c) ms.classes[c] = ms.classes[c + 32];
+    ms.nclasses = ncls;
+
+    // trie with sibling lists
+    ms.child = (int32_t*)i_calloc(total, c_sizeof(int32_t));
+    ms.sibling = (int32_t*)i_calloc(total, c_sizeof(int32_t));
+    ms.fail = (int32_t*)i_calloc(total, c_sizeof(int32_t));
+    ms.depth = (int32_t*)i_calloc(total, c_sizeof(int32_t));
+    ms.label = (uint16_t*)i_calloc(total, c_sizeof(uint16_t));
+    ms.match = (int32_t*)i_malloc(total*c_sizeof(int32_t));
+    ms.patlen = (int32_t*)i_malloc((n + 1)*c_sizeof(int32_t));
+    for (isize s = 0; s < total; ++s) ms.match[s] = -1;
+    ms.nstates = 1;
+
+    for (int32_t i = 0; i < (int32_t)n; ++i) {
+        int32_t s = 0;
+        ms.patlen[i] = (int32_t)needles[i].size;
+        for (isize j = 0; j < needles[i].size; ++j) {
+            const unsigned c = ms.classes[(uint8_t)needles[i].buf[j]];
+            int32_t t = _cms_goto(&ms, s, c);
+            if (t == 0) {
+                t = ms.nstates++;
+                ms.label[t] = (uint16_t)c;
+                ms.depth[t] = ms.depth[s] + 1;
+                ms.sibling[t] = ms.child[s], ms.child[s] = t;
+            }
+            s = t;
+        }
+        if (s != 0 && ms.match[s] < 0) // empty needles never match, duplicates keep first index
+            ms.match[s] = i;
+    }
+
+    // breadth first: failure links, dictionary suffixes and transitions
+    ms.dense = (isize)ms.nstates*ncls <= _cms_DENSE_MAX;
+    ms.delta = (int32_t*)i_calloc(ms.dense ? (isize)ms.nstates*ncls : ncls, c_sizeof(int32_t));
+    int32_t* queue = (int32_t*)i_malloc(ms.nstates*c_sizeof(int32_t));
+    int32_t head = 0, tail = 0;
+    for (int32_t e = ms.child[0]; e != 0; e = ms.sibling[e]) {
+        ms.delta[ms.label[e]] = e;
+        queue[tail++] = e;
+    }
+    while (head < tail) {
+        const int32_t u = queue[head++];
+        if (ms.match[u] < 0)
+            ms.match[u] = ms.match[ms.fail[u]];
+        if (ms.dense)
+            c_memcpy(ms.delta + (isize)u*ncls, ms.delta + (isize)ms.fail[u]*ncls, ncls*c_sizeof(int32_t));
+        for (int32_t v = ms.child[u]; v != 0; v = ms.sibling[v]) {
+            int32_t f = ms.fail[u];
+            while (f != 0 && _cms_goto(&ms, f, ms.label[v]) == 0)
+                f = ms.fail[f];
+            ms.fail[v] = f == 0 ? ms.delta[ms.label[v]] : _cms_goto(&ms, f, ms.label[v]);
+            if (ms.dense)
+                ms.delta[(isize)u*ncls + ms.label[v]] = v;
+            queue[tail++] = v;
+        }
+    }
+    i_free(queue, ms.nstates*c_sizeof(int32_t));
+
+    if (ms.dense) { // the trie edges are not needed by the dense automaton
+        i_free(ms.child, total*c_sizeof(int32_t));
+        i_free(ms.sibling, total*c_sizeof(int32_t));
+        i_free(ms.fail, total*c_sizeof(int32_t));
+        i_free(ms.label, total*c_sizeof(uint16_t));
+        ms.child = ms.sibling = ms.fail = NULL, ms.label = NULL;
+    } else {
+        ms.child = (int32_t*)i_realloc(ms.child, total*c_sizeof(int32_t), ms.nstates*c_sizeof(int32_t));
+        ms.sibling = (int32_t*)i_realloc(ms.sibling, total*c_sizeof(int32_t), ms.nstates*c_sizeof(int32_t));
+        ms.fail = (int32_t*)i_realloc(ms.fail, total*c_sizeof(int32_t), ms.nstates*c_sizeof(int32_t));
+        ms.label = (uint16_t*)i_realloc(ms.label, total*c_sizeof(uint16_t), ms.nstates*c_sizeof(uint16_t));
+    }
+    ms.match = (int32_t*)i_realloc(ms.match, total*c_sizeof(int32_t), ms.nstates*c_sizeof(int32_t));
+    ms.depth = (int32_t*)i_realloc(ms.depth, total*c_sizeof(int32_t), ms.nstates*c_sizeof(int32_t));
+    return ms;
+}
+
+STC_DEF void cmultisearcher_drop(cmultisearcher* self) {
+    const isize total = self->nstates;
+    if (!self->dense) {
+        i_free(self->child, total*c_sizeof(int32_t));
+        i_free(self->sibling, total*c_sizeof(int32_t));
+        i_free(self->fail, total*c_sizeof(int32_t));
+        i_free(self->label, total*c_sizeof(uint16_t));
+    }
+    i_free(self->delta, (self->dense ? total*self->nclasses : self->nclasses)*c_sizeof(int32_t));
+    i_free(self->match, total*c_sizeof(int32_t));
+    i_free(self->depth, total*c_sizeof(int32_t));
+    i_free(self->patlen, (self->npatterns + 1)*c_sizeof(int32_t));
+}
+
+STC_DEF bool cmultisearcher_find(const cmultisearcher* self, csview input, isize start,
+                                 cmultisearcher_match* m) {
+    const uint8_t* buf = (const uint8_t*)input.buf;
+    isize i = start;
+    int32_t s = 0;
+    // scan to the first match end
+    if (self->dense) {
+        for (const int32_t ncls = self->nclasses; i < input.size; ++i)
+            if (self->match[s = self->delta[s*ncls + self->classes[buf[i]]]] >= 0) break;
+    } else {
+        for (; i < input.size; ++i)
+            if (self->match[s = _cms_next(self, s, self->classes[buf[i]])] >= 0) break;
+    }
+    if (i == input.size)
+        return false;
+
+    // continue while a longer match, or one starting earlier, is still possible
+    int32_t pat = self->match[s];
+    isize best = i + 1 - self->patlen[pat];
+    while (++i < input.size) {
+        s = _cms_next(self, s, self->classes[buf[i]]);
+        if (i + 1 - self->depth[s] > best)
+            break;
+        const int32_t p = self->match[s];
+        if (p >= 0) {
+            const isize pos = i + 1 - self->patlen[p];
+            if (pos < best || (pos == best && self->patlen[p] > self->patlen[pat]))
+                best = pos, pat = p;
+        }
+    }
+    m->pos = best, m->len = self->patlen[pat], m->pattern = pat;
+    return true;
+}
+
+STC_DEF isize cmultisearcher_find_all(const cmultisearcher* self, csview input,
+                                      cmultisearcher_match out[], isize maxcount) {
+    isize count = 0, from = 0;
+    cmultisearcher_match m;
+    while (count < maxcount && cmultisearcher_find(self, input, from, &m)) {
+        out[count++] = m;
+        from = m.pos + m.len;
+    }
+    return count;
+}
+
+STC_DEF cstr cmultisearcher_replace_all(const cmultisearcher* self, csview input,
+                                        const csview repl[], isize nrepl) {
+    cstr out = cstr_init();
+    isize from = 0;
+    cmultisearcher_match m;
+    while (cmultisearcher_find(self, input, from, &m)) {
+        const csview r = repl[nrepl == 1 ? 0 : m.pattern];
+        cstr_append_n(&out, input.buf + from, m.pos - from);
+        cstr_append_n(&out, r.buf, r.size);
+        from = m.pos + m.len;
+    }
+    cstr_append_n(&out, input.buf + from, input.size - from);
+    return out;
+}
+
+STC_DEF bool cmultisearcher_stream_next(cmultisearcher_stream* st, csview chunk,
+                                        cmultisearcher_match* m) {
+    const cmultisearcher* self = st->searcher;
+    int32_t s = st->state;
+    while (st->pos < chunk.size) {
+        s = _cms_next(self, s, self->classes[(uint8_t)chunk.buf[st->pos++]]);
+        const int32_t p = self->match[s];
+        if (p >= 0) {
+            st->state = s;
+            m->pos = st->offset + st->pos - self->patlen[p];
+            m->len = self->patlen[p], m->pattern = p;
+            return true;
+        }
+    }
+    st->state = s;
+    st->offset += chunk.size, st->pos = 0;
+    return false;
+}
+
+#endif // STC_CMULTISEARCHER_PRV_C_INCLUDED
@@ -0,0 +1,331 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CROPE_PRV_C_INCLUDED
+#define STC_CROPE_PRV_C_INCLUDED
+
+// The rope is an implicit treap: nodes are ordered by position, and each subtree knows its
+// byte and codepoint size. Edits within a chunk are done in place, others by split and merge.
+enum { _crope_FILL = crope_CHUNK*3/4 }; // leave room for in place inserts
+
+static uint64_t _crope_prio(crope* self) { // xorshift64*
+    uint64_t x = self->seed ? self->seed : 0x9E3779B97F4A7C15u;
+    x ^= x >> 12, x ^= x << 25, x ^= x >> 27;
+    self->seed = x;
+    return x*0x2545F4914F6CDD1Du;
+}
+
+static _crope_node* _crope_new(crope* self, const char* buf, isize len) {
+    _crope_node* n = (_crope_node*)i_malloc(c_sizeof(_crope_node));
+    c_memcpy(n->data, buf, len);
+    n->left = n->right = n->parent = NULL;
+    n->sv = c_sv(n->data, len);
+    n->u8len = n->u8size = _utf8_count_leads(buf, len);
+    n->size = len;
+    n->prio = _crope_prio(self);
+    return n;
+}
+
+static void _crope_free(_crope_node* t) {
+    while (t) {
+        _crope_node* right = t->right;
+        _crope_free(t->left);
+        i_free(t, c_sizeof(_crope_node));
+        t = right;
+    }
+}
+
+static void _crope_update(_crope_node* n) { // also links the children to n
+    n->size = n->sv.size, n->u8size = n->u8len;
+    if (n->left) {
+        n->size += n->left->size, n->u8size += n->left->u8size;
+        n->left->parent = n;
+    }
+    if (n->right) {
+        n->size += n->right->size, n->u8size += n->right->u8size;
+        n->right->parent = n;
+    }
+}
+
+static void _crope_fix_up(_crope_node* n) {
+    for (; n; n = n->parent) _crope_update(n);
+}
+
+static _crope_node* _crope_merge(_crope_node* a, _crope_node* b) {
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+    if (a->prio > b->prio) {
+        a->right = _crope_merge(a->right, b);
+        _crope_update(a);
+        return a;
+    }
+    b->left = _crope_merge(a, b->left);
+    _crope_update(b);
+    return b;
+}
+
+// split t into bytes [0, pos) and [pos, size). parent links of *l and *r are not set.
+static void _crope_split(crope* self, _crope_node* t, isize pos, _crope_node** l, _crope_node** r) {
+    if (t == NULL) {
+        *l = *r = NULL;
+        return;
+    }
+    const isize lsize = t->left ? t->left->size : 0;
+    if (pos <= lsize) {
+        _crope_split(self, t->left, pos, l, &t->left);
+        _crope_update(t);
+        *r = t;
+    } else if (pos >= lsize + t->sv.size) {
+        _crope_split(self, t->right, pos - lsize - t->sv.size, &t->right, r);
+        _crope_update(t);
+        *l = t;
+    } else { // cut the chunk
+        const isize k = pos - lsize;
+        _crope_node* tail = _crope_new(self, t->data + k, t->sv.size - k);
+        tail->prio = t->prio ? tail->prio % t->prio : 0; // keep the heap order with t's ancestors
+        t->sv.size = k;
+        t->u8len -= tail->u8len;
+        *r = _crope_merge(tail, t->right);
+        t->right = NULL;
+        _crope_update(t);
+        *l = t;
+    }
+}
+
+static _crope_node* _crope_find(const _crope_node* t, isize* pos) { // requires 0 <= *pos < size
+    for (;;) {
+        const isize lsize = t->left ? t->left->size : 0;
+        if (*pos < lsize) {
+            t = t->left;
+        } else if (*pos < lsize + t->sv.size) {
+            *pos -= lsize;
+            return (_crope_node*)t;
+        } else {
+            *pos -= lsize + t->sv.size;
+            t = t->right;
+        }
+    }
+}
+
+static const _crope_node* _crope_successor(const _crope_node* n) {
+    if (n->right) {
+        for (n = n->right; n->left; n = n->left) {}
+        return n;
+    }
+    while (n->parent && n->parent->right == n)
+        n = n->parent;
+    return n->parent;
+}
+
+static _crope_node* _crope_build(crope* self, csview sv) {
+    _crope_node* t = NULL;
+    for (isize i = 0, len; i < sv.size; i += len) {
+        len = sv.size - i < _crope_FILL ? sv.size - i : _crope_FILL;
+        // avoid splitting codepoints between chunks
+        for (isize n = len; n > _crope_FILL - 4 && i + n < sv.size; --n)
+            if ((sv.buf[i + n] & 0xC0) != 0x80) { len = n; break; }
+        t = _crope_merge(t, _crope_new(self, sv.buf + i, len));
+    }
+    if (t) t->parent = NULL;
+    return t;
+}
+
+static void _crope_unlink(crope* self, _crope_node* n) {
+    _crope_node* p = n->parent;
+    _crope_node* m = _crope_merge(n->left, n->right);
+    if (m) m->parent = p;
+    if (p == NULL) self->root = m;
+    else if (p->left == n) p->left = m;
+    else p->right = m;
+    _crope_fix_up(p);
+    i_free(n, c_sizeof(_crope_node));
+}
+
+static void _crope_coalesce(crope* self, isize pos) { // join the chunks around pos if small
+    if (pos <= 0 || pos >= crope_size(self))
+        return;
+    isize i = pos - 1, j = pos;
+    _crope_node *a = _crope_find(self->root, &i), *b = _crope_find(self->root, &j);
+    if (a != b && a->sv.size + b->sv.size <= _crope_FILL) {
+        c_memcpy(a->data + a->sv.size, b->data, b->sv.size);
+        a->sv.size += b->sv.size;
+        a->u8len += b->u8len;
+        _crope_fix_up(a);
+        _crope_unlink(self, b);
+    }
+}
+
+STC_DEF crope crope_from_sv(csview sv) {
+    crope r = crope_init();
+    r.root = _crope_build(&r, sv);
+    return r;
+}
+
+static _crope_node* _crope_clone(const _crope_node* t, _crope_node* parent) {
+    if (t == NULL)
+        return NULL;
+    _crope_node* n = (_crope_node*)i_malloc(c_sizeof(_crope_node));
+    c_memcpy(n, t, c_sizeof(_crope_node) - crope_CHUNK + t->sv.size);
+    n->sv.buf = n->data;
+    n->parent = parent;
+    n->left = _crope_clone(t->left, n);
+    n->right = _crope_clone(t->right, n);
+    return n;
+}
+
+STC_DEF crope crope_clone(crope r) {
+    r.root = _crope_clone(r.root, NULL);
+    return r;
+}
+
+STC_DEF void crope_drop(const crope* self)
+    { _crope_free(self->root); }
+
+STC_DEF void crope_clear(crope* self) {
+    _crope_free(self->root);
+    self->root = NULL;
+}
+
+STC_DEF void crope_insert_sv(crope* self, isize pos, csview sv) {
+    const isize size = crope_size(self);
+    c_assert(pos >= 0 && pos <= size);
+    if (sv.size == 0)
+        return;
+    if (self->root && sv.size <= crope_CHUNK/4) { // try in place, in the chunk at pos or before it
+        _crope_node* n = NULL;
+        isize k = pos;
+        if (pos < size)
+            n = _crope_find(self->root, &k);
+        if ((n == NULL || n->sv.size + sv.size > crope_CHUNK) && pos > 0) {
+            k = pos - 1;
+            n = _crope_find(self->root, &k);
+            ++k;
+        }
+        if (n->sv.size + sv.size <= crope_CHUNK && !c_uless(sv.buf - n->data, crope_CHUNK)) {
+            c_memmove(n->data + k + sv.size, n->data + k, n->sv.size - k);
+            c_memcpy(n->data + k, sv.buf, sv.size);
+            n->sv.size += sv.size;
+            n->u8len += _utf8_count_leads(sv.buf, sv.size);
+            _crope_fix_up(n);
+            return;
+        }
+    }
+    _crope_node *l, *r;
+    _crope_split(self, self->root, pos, &l, &r);
+    self->root = _crope_merge(_crope_merge(l, _crope_build(self, sv)), r);
+    self->root->parent = NULL;
+}
+
+STC_DEF void crope_erase(crope* self, isize pos, isize len) {
+    const isize size = crope_size(self);
+    c_assert(pos >= 0 && pos <= size);
+    if (len > size - pos) len = size - pos;
+    if (len <= 0)
+        return;
+    isize k = pos;
+    _crope_node* n = _crope_find(self->root, &k);
+    if (k == 0 && len == n->sv.size) {
+        _crope_unlink(self, n);
+    } else if (k + len <= n->sv.size) {
+        n->u8len -= _utf8_count_leads(n->data + k, len);
+        c_memmove(n->data + k, n->data + k + len, n->sv.size - k - len);
+        n->sv.size -= len;
+        _crope_fix_up(n);
+    } else {
+        _crope_node *l, *m, *r;
+        _crope_split(self, self->root, pos, &l, &r);
+        _crope_split(self, r, len, &m, &r);
+        _crope_free(m);
+        self->root = _crope_merge(l, r);
+        if (self->root) self->root->parent = NULL;
+    }
+    _crope_coalesce(self, pos);
+}
+
+STC_DEF char crope_at(const crope* self, isize pos) {
+    c_assert(c_uless(pos, crope_size(self)));
+    const _crope_node* n = _crope_find(self->root, &pos);
+    return n->data[pos];
+}
+
+STC_DEF crope_iter crope_begin(const crope* self) {
+    const _crope_node* n = self->root;
+    if (n) while (n->left) n = n->left;
+    crope_iter it = {n ? &n->sv : NULL, n};
+    return it;
+}
+
+STC_DEF void crope_next(crope_iter* it) {
+    it->_node = _crope_successor(it->_node);
+    it->ref = it->_node ? &it->_node->sv : NULL;
+}
+
+STC_DEF crope_iter crope_find_chunk(const crope* self, isize pos, isize* offset) {
+    crope_iter it = {NULL, NULL};
+    *offset = 0;
+    if (c_uless(pos, crope_size(self))) {
+        it._node = _crope_find(self->root, &pos);
+        it.ref = &it._node->sv;
+        *offset = pos;
+    }
+    return it;
+}
+
+STC_DEF cstr crope_substr(const crope* self, isize pos, isize len) {
+    const isize size = crope_size(self);
+    c_assert(pos >= 0 && pos <= size);
+    if (len > size - pos) len = size - pos;
+    cstr out = cstr_with_capacity(len > 0 ? len : 0);
+    isize k;
+    for (crope_iter it = crope_find_chunk(self, pos, &k); it.ref && len > 0; crope_next(&it), k = 0) {
+        const isize n = it.ref->size - k < len ? it.ref->size - k : len;
+        cstr_append_n(&out, it.ref->buf + k, n);
+        len -= n;
+    }
+    return out;
+}
+
+STC_DEF isize crope_u8_to_pos(const crope* self, isize u8pos) {
+    c_assert(u8pos >= 0 && u8pos <= crope_u8_size(self));
+    const _crope_node* t = self->root;
+    isize pos = 0;
+    while (t) {
+        const isize lu = t->left ? t->left->u8size : 0;
+        if (u8pos < lu) {
+            t = t->left;
+            continue;
+        }
+        u8pos -= lu;
+        pos += t->left ? t->left->size : 0;
+        if (u8pos < t->u8len) {
+            for (isize i = 0; ; ++i)
+                if ((t->data[i] & 0xC0) != 0x80 && u8pos-- == 0)
+                    return pos + i;
+        }
+        u8pos -= t->u8len;
+        pos += t->sv.size;
+        t = t->right;
+    }
+    return pos;
+}
+
+#endif // STC_CROPE_PRV_C_INCLUDED
@@ -0,0 +1,175 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CSEARCHER_PRV_C_INCLUDED
+#define STC_CSEARCHER_PRV_C_INCLUDED
+
+#if defined __SSE2__ && defined __GNUC__
+  #include <emmintrin.h>
+  #define _csearch_SSE2
+#endif
+
+/* approximate byte frequency rank in text and source code: 0 = rarest */
+static const uint8_t _csearch_rank[256] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,161,245,  9,155, 10, 11, 12,
+    13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+   255,169,223,217,158,173,199,170,234,235,225,183,236,228,229,224,
+   211,213,209,201,196,190,194,178,193,182,192,230,176,214,206,166,
+   157,210,187,212,195,219,189,177,180,218,165,168,216,208,215,207,
+   198,167,204,220,221,184,174,172,186,175,164,191,185,188,162,244,
+   197,247,232,246,242,254,241,227,238,252,171,222,243,237,250,248,
+   240,179,249,251,253,239,231,226,205,233,200,202,181,203,156, 29,
+   151, 30,139, 31, 32, 33, 34, 35, 36,150, 37,129, 38, 39,140, 40,
+   146, 41, 42, 43, 44, 45, 46,141,152, 47,130, 48, 49,131, 50,154,
+   132, 51, 52,133, 53, 54, 55, 56,142,160, 57, 58, 59, 60, 61,134,
+    62, 63, 64, 65, 66, 67,135, 68,159, 69, 70, 71,147, 72, 73,136,
+    74, 75,148,163, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85,143, 86,
+    87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,100,101,102,
+   103,104,105,106,107,144,149,137,108,138,109,110,111,112,113,145,
+   153,114,115,116,117,118,119,120,121,122,123,124,125,126,127,128,
+};
+
+csearcher csearcher_from(csview needle) {
+    const uint8_t* n = (const uint8_t*)needle.buf;
+    const isize m = needle.size;
+    csearcher s = {.needle = needle.buf, .size = m};
+
+    for (isize i = 0; i < m; ++i) {
+        s.byteset[n[i] >> 3] |= (uint8_t)(1U << (n[i] & 7));
+        if (_csearch_rank[n[i]] < _csearch_rank[n[s.rare1]])
+            s.rare1 = i;
+    }
+    s.rare2 = s.rare1 == 0 && m > 1;
+    for (isize i = 0; i < m; ++i)
+        if (i != s.rare1 && _csearch_rank[n[i]] < _csearch_rank[n[s.rare2]])
+            s.rare2 = i;
+    if (s.rare1 > s.rare2)
+        c_swap(&s.rare1, &s.rare2);
+
+    // Two-Way critical factorization: maximal suffix for both byte orderings.
+    isize ms, p0, ip = -1, jp = 0, k = 1, p = 1;
+    while (jp + k < m) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) jp += p, k = 1;
+            else ++k;
+        } else if (n[ip + k] > n[jp + k]) {
+            jp += k, k = 1, p = jp - ip;
+        } else {
+            ip = jp++, k = p = 1;
+        }
+    }
+    ms = ip, p0 = p;
+    ip = -1, jp = 0, k = p = 1;
+    while (jp + k < m) {
+        if (n[ip + k] == n[jp + k]) {
+            if (k == p) jp += p, k = 1;
+            else ++k;
+        } else if (n[ip + k] < n[jp + k]) {
+            jp += k, k = 1, p = jp - ip;
+        } else {
+            ip = jp++, k = p = 1;
+        }
+    }
+    if (ip + 1 > ms + 1) ms = ip;
+    else p = p0;
+
+    s.crit = ms;
+    s.periodic = p + ms + 1 <= m && !c_memcmp(n, n + p, ms + 1);
+    s.period = s.periodic ? p : (ms > m - ms - 1 ? ms : m - ms - 1) + 1;
+    return s;
+}
+
+static const char* _csearch_twoway(const csearcher* s, const char* hay, isize hlen) {
+    const uint8_t *n = (const uint8_t*)s->needle, *h = (const uint8_t*)hay;
+    const isize m = s->size, ms = s->crit, p = s->period, mem0 = s->periodic ? m - p : 0;
+    isize mem = 0, j = 0, k;
+    while (j <= hlen - m) {
+        const uint8_t c = h[j + m - 1];
+        if (!(s->byteset[c >> 3] & (1U << (c & 7)))) { // last byte in window is not in needle
+            j += m, mem = 0;
+            continue;
+        }
+        for (k = (ms + 1 > mem ? ms + 1 : mem); k < m && n[k] == h[j + k]; ++k) ;
+        if (k < m) {
+            j += k - ms, mem = 0;
+            continue;
+        }
+        for (k = ms + 1; k > mem && n[k - 1] == h[j + k - 1]; --k) ;
+        if (k <= mem)
+            return hay + j;
+        j += p, mem = mem0;
+    }
+    return NULL;
+}
+
+/* Locate the needle by its two rarest bytes. When too many candidates fail to verify, the
+ * rest of the haystack is searched with Two-Way to keep the worst case linear. */
+static const char* _csearch_filter(const csearcher* s, const char* hay, isize hlen) {
+    const isize m = s->size, r1 = s->rare1, r2 = s->rare2, last = hlen - m;
+    const char b1 = s->needle[r1], b2 = s->needle[r2];
+    isize j = 0, fails = 0;
+  #if defined _csearch_SSE2
+    const __m128i v1 = _mm_set1_epi8(b1), v2 = _mm_set1_epi8(b2);
+    for (; j <= last - 15; j += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(v1, _mm_loadu_si128((const __m128i*)(hay + j + r1))),
+            _mm_cmpeq_epi8(v2, _mm_loadu_si128((const __m128i*)(hay + j + r2)))));
+        while (mask) {
+            const isize i = j + __builtin_ctz(mask);
+            if (!c_memcmp(hay + i, s->needle, m))
+                return hay + i;
+            if (++fails*m > 4*i + 256)
+                return _csearch_twoway(s, hay + i + 1, hlen - i - 1);
+            mask &= mask - 1;
+        }
+    }
+  #endif
+    for (const char* p; j <= last; ++j) {
+        if ((p = (const char*)memchr(hay + j + r1, b1, (size_t)(last - j + 1))) == NULL)
+            return NULL;
+        j = p - hay - r1;
+        if (hay[j + r2] == b2 && !c_memcmp(hay + j, s->needle, m))
+            return hay + j;
+        if (++fails*m > 4*j + 256)
+            return _csearch_twoway(s, hay + j + 1, hlen - j - 1);
+    }
+    return NULL;
+}
+
+const char* csearcher_find(const csearcher* self, csview hay) {
+    if (self->size == 0) return hay.buf;
+    if (self->size > hay.size) return NULL;
+    if (self->size == 1) return (const char*)memchr(hay.buf, self->needle[0], (size_t)hay.size);
+    return _csearch_filter(self, hay.buf, hay.size);
+}
+
+/* One-shot search. Needles shorter than _csearch_SHORT are not worth the searcher setup
+ * (rare bytes and Two-Way factorization): use memchr on the first byte and verify. */
+
+const char* c_strsearch(const char* str, isize slen, const char* needle, isize nlen) {
+    if (nlen < _csearch_SHORT || nlen > slen)
+        return c_strnstrn(str, slen, needle, nlen);
+    csearcher s = csearcher_from(c_sv(needle, nlen));
+    return csearcher_find(&s, c_sv(str, slen));
+}
+
+#endif // STC_CSEARCHER_PRV_C_INCLUDED
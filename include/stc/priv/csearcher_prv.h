@@ -0,0 +1,49 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// IWYU pragma: private, include "stc/csearcher.h"
+#ifndef STC_CSEARCHER_PRV_H_INCLUDED
+#define STC_CSEARCHER_PRV_H_INCLUDED
+
+/* Precompiled substring searcher. Short needles are located by scanning for their two rarest
+ * bytes (SSE2 or memchr), long or repetitive needles fall back to Two-Way, which is linear in
+ * the worst case. The needle buffer must outlive the searcher.
+ *
+ * The following requires linking with cstr symbols, or define i_implement before including
+ * stc/csearcher.h in one translation unit.
+ */
+typedef struct {
+    const char* needle;
+    isize size;
+    isize rare1, rare2;     // positions of the two rarest bytes in needle
+    isize crit, period;     // Two-Way critical factorization
+    bool periodic;
+    uint8_t byteset[32];    // bytes present in needle
+} csearcher;
+
+enum { _csearch_SHORT = 16 }; // one-shot searches for shorter needles skip the setup
+
+extern csearcher   csearcher_from(csview needle);
+extern const char* csearcher_find(const csearcher* self, csview haystack); // NULL if not found
+extern const char* c_strsearch(const char* str, isize slen, const char* needle, isize nlen);
+
+#endif // STC_CSEARCHER_PRV_H_INCLUDED
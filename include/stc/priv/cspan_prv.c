@@ -0,0 +1,511 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// ----------------------- cspan_matmul -----------------------
+#if !defined STC_CSPAN_MATMUL_C_INCLUDED && defined i_implement
+#define STC_CSPAN_MATMUL_C_INCLUDED
+
+#if defined __AVX__ || defined __SSE2__ || defined _M_X64
+  #include <immintrin.h>
+#elif defined __ARM_NEON
+  #include <arm_neon.h>
+#endif
+
+// Cache blocking sizes: A-block MC x KC fits in L2, B-panel KC x NR in L1.
+enum { _cspan_MC = 128, _cspan_KC = 256, _cspan_NC = 2048 };
+
+// Register-blocked micro-kernels: tile[MR][NR] = Apanel[kc][MR]^T * Bpanel[kc][NR].
+#define _cspan_KERNEL_C(T, MR, NR) do { \
+    T _acc[MR*NR] = {0}; \
+    for (isize _p = 0; _p < kc; ++_p, a += MR, b += NR) \
+        for (int _i = 0; _i < MR; ++_i) \
+            for (int _j = 0; _j < NR; ++_j) \
+                _acc[_i*NR + _j] += a[_i]*b[_j]; \
+    memcpy(tile, _acc, sizeof _acc); \
+} while (0)
+
+static void _cspan_kernel_float(isize kc, const float* a, const float* b, float tile[4*8]) {
+#if defined __AVX__
+  #if defined __FMA__
+    #define _cspan_fma_ps(x, y, acc) _mm256_fmadd_ps(x, y, acc)
+  #else
+    #define _cspan_fma_ps(x, y, acc) _mm256_add_ps(acc, _mm256_mul_ps(x, y))
+  #endif
+    __m256 c0 = _mm256_setzero_ps(), c1 = c0, c2 = c0, c3 = c0;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 8) {
+        __m256 bv = _mm256_loadu_ps(b);
+        c0 = _cspan_fma_ps(_mm256_broadcast_ss(a + 0), bv, c0);
+        c1 = _cspan_fma_ps(_mm256_broadcast_ss(a + 1), bv, c1);
+        c2 = _cspan_fma_ps(_mm256_broadcast_ss(a + 2), bv, c2);
+        c3 = _cspan_fma_ps(_mm256_broadcast_ss(a + 3), bv, c3);
+    }
+    _mm256_storeu_ps(tile + 0, c0); _mm256_storeu_ps(tile + 8, c1);
+    _mm256_storeu_ps(tile + 16, c2); _mm256_storeu_ps(tile + 24, c3);
+    #undef _cspan_fma_ps
+#elif defined __SSE2__ || defined _M_X64
+    __m128 c00 = _mm_setzero_ps(), c01 = c00, c10 = c00, c11 = c00,
+           c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 8) {
+        __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4), av;
+        av = _mm_set1_ps(a[0]); c00 = _mm_add_ps(c00, _mm_mul_ps(av, b0)); c01 = _mm_add_ps(c01, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(a[1]); c10 = _mm_add_ps(c10, _mm_mul_ps(av, b0)); c11 = _mm_add_ps(c11, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(a[2]); c20 = _mm_add_ps(c20, _mm_mul_ps(av, b0)); c21 = _mm_add_ps(c21, _mm_mul_ps(av, b1));
+        av = _mm_set1_ps(a[3]); c30 = _mm_add_ps(c30, _mm_mul_ps(av, b0)); c31 = _mm_add_ps(c31, _mm_mul_ps(av, b1));
+    }
+    _mm_storeu_ps(tile + 0, c00); _mm_storeu_ps(tile + 4, c01);
+    _mm_storeu_ps(tile + 8, c10); _mm_storeu_ps(tile + 12, c11);
+    _mm_storeu_ps(tile + 16, c20); _mm_storeu_ps(tile + 20, c21);
+    _mm_storeu_ps(tile + 24, c30); _mm_storeu_ps(tile + 28, c31);
+#elif defined __ARM_NEON
+    float32x4_t c00 = vdupq_n_f32(0), c01 = c00, c10 = c00, c11 = c00,
+                c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 8) {
+        float32x4_t b0 = vld1q_f32(b), b1 = vld1q_f32(b + 4);
+        c00 = vmlaq_n_f32(c00, b0, a[0]); c01 = vmlaq_n_f32(c01, b1, a[0]);
+        c10 = vmlaq_n_f32(c10, b0, a[1]); c11 = vmlaq_n_f32(c11, b1, a[1]);
+        c20 = vmlaq_n_f32(c20, b0, a[2]); c21 = vmlaq_n_f32(c21, b1, a[2]);
+        c30 = vmlaq_n_f32(c30, b0, a[3]); c31 = vmlaq_n_f32(c31, b1, a[3]);
+    }
+    vst1q_f32(tile + 0, c00); vst1q_f32(tile + 4, c01);
+    vst1q_f32(tile + 8, c10); vst1q_f32(tile + 12, c11);
+    vst1q_f32(tile + 16, c20); vst1q_f32(tile + 20, c21);
+    vst1q_f32(tile + 24, c30); vst1q_f32(tile + 28, c31);
+#else
+    _cspan_KERNEL_C(float, 4, 8);
+#endif
+}
+
+static void _cspan_kernel_double(isize kc, const double* a, const double* b, double tile[4*4]) {
+#if defined __AVX__
+  #if defined __FMA__
+    #define _cspan_fma_pd(x, y, acc) _mm256_fmadd_pd(x, y, acc)
+  #else
+    #define _cspan_fma_pd(x, y, acc) _mm256_add_pd(acc, _mm256_mul_pd(x, y))
+  #endif
+    __m256d c0 = _mm256_setzero_pd(), c1 = c0, c2 = c0, c3 = c0;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 4) {
+        __m256d bv = _mm256_loadu_pd(b);
+        c0 = _cspan_fma_pd(_mm256_broadcast_sd(a + 0), bv, c0);
+        c1 = _cspan_fma_pd(_mm256_broadcast_sd(a + 1), bv, c1);
+        c2 = _cspan_fma_pd(_mm256_broadcast_sd(a + 2), bv, c2);
+        c3 = _cspan_fma_pd(_mm256_broadcast_sd(a + 3), bv, c3);
+    }
+    _mm256_storeu_pd(tile + 0, c0); _mm256_storeu_pd(tile + 4, c1);
+    _mm256_storeu_pd(tile + 8, c2); _mm256_storeu_pd(tile + 12, c3);
+    #undef _cspan_fma_pd
+#elif defined __SSE2__ || defined _M_X64
+    __m128d c00 = _mm_setzero_pd(), c01 = c00, c10 = c00, c11 = c00,
+            c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 4) {
+        __m128d b0 = _mm_loadu_pd(b), b1 = _mm_loadu_pd(b + 2), av;
+        av = _mm_set1_pd(a[0]); c00 = _mm_add_pd(c00, _mm_mul_pd(av, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(av, b1));
+        av = _mm_set1_pd(a[1]); c10 = _mm_add_pd(c10, _mm_mul_pd(av, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(av, b1));
+        av = _mm_set1_pd(a[2]); c20 = _mm_add_pd(c20, _mm_mul_pd(av, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(av, b1));
+        av = _mm_set1_pd(a[3]); c30 = _mm_add_pd(c30, _mm_mul_pd(av, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(av, b1));
+    }
+    _mm_storeu_pd(tile + 0, c00); _mm_storeu_pd(tile + 2, c01);
+    _mm_storeu_pd(tile + 4, c10); _mm_storeu_pd(tile + 6, c11);
+    _mm_storeu_pd(tile + 8, c20); _mm_storeu_pd(tile + 10, c21);
+    _mm_storeu_pd(tile + 12, c30); _mm_storeu_pd(tile + 14, c31);
+#elif defined __ARM_NEON && defined __aarch64__
+    float64x2_t c00 = vdupq_n_f64(0), c01 = c00, c10 = c00, c11 = c00,
+                c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (isize p = 0; p < kc; ++p, a += 4, b += 4) {
+        float64x2_t b0 = vld1q_f64(b), b1 = vld1q_f64(b + 2);
+        c00 = vfmaq_n_f64(c00, b0, a[0]); c01 = vfmaq_n_f64(c01, b1, a[0]);
+        c10 = vfmaq_n_f64(c10, b0, a[1]); c11 = vfmaq_n_f64(c11, b1, a[1]);
+        c20 = vfmaq_n_f64(c20, b0, a[2]); c21 = vfmaq_n_f64(c21, b1, a[2]);
+        c30 = vfmaq_n_f64(c30, b0, a[3]); c31 = vfmaq_n_f64(c31, b1, a[3]);
+    }
+    vst1q_f64(tile + 0, c00); vst1q_f64(tile + 2, c01);
+    vst1q_f64(tile + 4, c10); vst1q_f64(tile + 6, c11);
+    vst1q_f64(tile + 8, c20); vst1q_f64(tile + 10, c21);
+    vst1q_f64(tile + 12, c30); vst1q_f64(tile + 14, c31);
+#else
+    _cspan_KERNEL_C(double, 4, 4);
+#endif
+}
+
+static void _cspan_kernel_int(isize kc, const int* a, const int* b, int tile[4*8]) {
+    _cspan_KERNEL_C(int, 4, 8); // auto-vectorized
+}
+
+// True if the 2-d views x and y (element size esz) occupy non-overlapping address ranges.
+static bool _cspan_disjoint2(const void* x, const _istride xsh[2], const _istride xst[2],
+                             const void* y, const _istride ysh[2], const _istride yst[2], isize esz) {
+    intptr_t xlo = (intptr_t)x, xhi = xlo, ylo = (intptr_t)y, yhi = ylo;
+    for (int i = 0; i < 2; ++i) {
+        intptr_t dx = (intptr_t)(xsh[i] - 1)*xst[i]*esz, dy = (intptr_t)(ysh[i] - 1)*yst[i]*esz;
+        if (dx < 0) xlo += dx; else xhi += dx;
+        if (dy < 0) ylo += dy; else yhi += dy;
+    }
+    return xhi + esz <= ylo || yhi + esz <= xlo;
+}
+
+// Generic driver: pack MR-row panels of A and NR-column panels of B into contiguous
+// zero-padded buffers, so that the micro-kernel works on any strides/transposed views.
+#define _cspan_DEF_MATMUL(T, MR, NR) \
+static void _cspan_pack_a_##T(isize mc, isize kc, const T* a, isize rs, isize cs, T* ap) { \
+    for (isize i0 = 0; i0 < mc; i0 += MR) { \
+        isize mr = mc - i0 < MR ? mc - i0 : MR; \
+        for (isize p = 0; p < kc; ++p, ap += MR) { \
+            const T* ai = a + i0*rs + p*cs; \
+            for (isize i = 0; i < MR; ++i) ap[i] = i < mr ? ai[i*rs] : (T)0; \
+        } \
+    } \
+} \
+\
+static void _cspan_pack_b_##T(isize kc, isize nc, const T* b, isize rs, isize cs, T* bp) { \
+    for (isize j0 = 0; j0 < nc; j0 += NR) { \
+        isize nr = nc - j0 < NR ? nc - j0 : NR; \
+        for (isize p = 0; p < kc; ++p, bp += NR) { \
+            const T* bj = b + p*rs + j0*cs; \
+            if (nr == NR && cs == 1) memcpy(bp, bj, NR*sizeof(T)); \
+            else for (isize j = 0; j < NR; ++j) bp[j] = j < nr ? bj[j*cs] : (T)0; \
+        } \
+    } \
+} \
+\
+/* Unblocked kernel, used when the packing buffers cannot be allocated: C[m,n] += A[m,k]*B[k,n] */ \
+static void _cspan_gemm_ref_##T(isize m, isize n, isize k, const T* a, isize ars, isize acs, \
+                                const T* b, isize brs, isize bcs, T* c, isize crs, isize ccs) { \
+    for (isize i = 0; i < m; ++i) \
+        for (isize p = 0; p < k; ++p) { \
+            const T aip = a[i*ars + p*acs]; \
+            for (isize j = 0; j < n; ++j) c[i*crs + j*ccs] += aip*b[p*brs + j*bcs]; \
+        } \
+} \
+\
+STC_DEF void _cspan_matmul_##T(const T* a, const _istride ash[2], const _istride ast[2], \
+                               const T* b, const _istride bsh[2], const _istride bst[2], \
+                               T* c, const _istride csh[2], const _istride cst[2], bool add) { \
+    const isize M = csh[0], N = csh[1], K = ash[1]; \
+    c_assert(ash[0] == M && bsh[0] == K && bsh[1] == N); \
+    if (!add) \
+        for (isize i = 0; i < M; ++i) \
+            for (isize j = 0; j < N; ++j) c[i*cst[0] + j*cst[1]] = (T)0; \
+    if (M <= 0 || N <= 0 || K <= 0) \
+        return; \
+    /* C is accumulated in place: it must not overlap A or B */ \
+    c_assert(_cspan_disjoint2(c, csh, cst, a, ash, ast, c_sizeof(T)) && \
+             _cspan_disjoint2(c, csh, cst, b, bsh, bst, c_sizeof(T))); \
+    const isize bp_n = ((N < _cspan_NC ? N : _cspan_NC) + NR - 1)/NR*NR; \
+    T* bp = _i_malloc(T, _cspan_KC*bp_n); \
+    if (bp == NULL) { \
+        _cspan_gemm_ref_##T(M, N, K, a, ast[0], ast[1], b, bst[0], bst[1], c, cst[0], cst[1]); \
+        return; \
+    } \
+    for (isize jc = 0; jc < N; jc += _cspan_NC) { \
+        const isize nc = N - jc < _cspan_NC ? N - jc : _cspan_NC; \
+        for (isize pc = 0; pc < K; pc += _cspan_KC) { \
+            const isize kc = K - pc < _cspan_KC ? K - pc : _cspan_KC; \
+            _cspan_pack_b_##T(kc, nc, b + pc*bst[0] + jc*bst[1], bst[0], bst[1], bp); \
+            \
+            _cspan_OMP(omp parallel if (M*nc*kc >= _cspan_PAR_MIN)) \
+            { \
+                T* ap = _i_malloc(T, _cspan_MC*kc + MR*kc); \
+                _cspan_OMP(omp for schedule(dynamic)) \
+                for (isize ic = 0; ic < M; ic += _cspan_MC) { \
+                    const isize mc = M - ic < _cspan_MC ? M - ic : _cspan_MC; \
+                    if (ap == NULL) { \
+                        _cspan_gemm_ref_##T(mc, nc, kc, a + ic*ast[0] + pc*ast[1], ast[0], ast[1], \
+                                            b + pc*bst[0] + jc*bst[1], bst[0], bst[1], \
+                                            c + ic*cst[0] + jc*cst[1], cst[0], cst[1]); \
+                        continue; \
+                    } \
+                    _cspan_pack_a_##T(mc, kc, a + ic*ast[0] + pc*ast[1], ast[0], ast[1], ap); \
+                    \
+                    for (isize jr = 0; jr < nc; jr += NR) { \
+                        const isize nr = nc - jr < NR ? nc - jr : NR; \
+                        for (isize ir = 0; ir < mc; ir += MR) { \
+                            const isize mr = mc - ir < MR ? mc - ir : MR; \
+                            T tile[MR*NR], *cc = c + (ic + ir)*cst[0] + (jc + jr)*cst[1]; \
+                            _cspan_kernel_##T(kc, ap + ir*kc, bp + jr*kc, tile); \
+                            for (isize i = 0; i < mr; ++i) \
+                                for (isize j = 0; j < nr; ++j) \
+                                    cc[i*cst[0] + j*cst[1]] += tile[i*NR + j]; \
+                        } \
+                    } \
+                } \
+                if (ap) i_free(ap, (_cspan_MC*kc + MR*kc)*c_sizeof(T)); \
+            } \
+        } \
+    } \
+    i_free(bp, _cspan_KC*bp_n*c_sizeof(T)); \
+}
+
+_cspan_DEF_MATMUL(float, 4, 8)
+_cspan_DEF_MATMUL(double, 4, 4)
+_cspan_DEF_MATMUL(int, 4, 8)
+
+#endif // STC_CSPAN_MATMUL_C_INCLUDED
+
+// ----------------------- cspan_npy -----------------------
+#if !defined STC_CSPAN_NPY_C_INCLUDED && defined i_implement
+#define STC_CSPAN_NPY_C_INCLUDED
+#include <stdlib.h>
+#include <limits.h>
+#if defined __unix__ || defined __APPLE__
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #define _cspan_NPY_MMAP 1
+#endif
+
+static char _cspan_npy_byteorder(isize elemsize) {
+    const uint16_t one = 1;
+    return elemsize == 1 ? '|' : *(const char*)&one ? '<' : '>';
+}
+
+// Returns length of header including magic string.
+static isize _cspan_npy_make_header(char buf[512], char kind, isize elemsize,
+                                    const isize shape[], int rank, bool fortran) {
+    int n = snprintf(buf + 10, 400, "{'descr': '%c%c%d', 'fortran_order': %s, 'shape': (",
+                     _cspan_npy_byteorder(elemsize), kind, (int)elemsize, fortran ? "True" : "False");
+    for (int i = 0; i < rank; ++i)
+        n += snprintf(buf + 10 + n, 40, "%" c_ZI "%s", shape[i], rank == 1 || i < rank - 1 ? ", " : "");
+    n += snprintf(buf + 10 + n, 8, "), }");
+    while ((10 + n + 1) % 64) buf[10 + n++] = ' ';
+    buf[10 + n++] = '\n';
+    memcpy(buf, "\x93NUMPY\x01\x00", 8);
+    buf[8] = (char)(n & 0xff), buf[9] = (char)(n >> 8);
+    return 10 + n;
+}
+
+static const char* _cspan_npy_value(const char* dict, const char* key) {
+    const char* p = strstr(dict, key);
+    if (p == NULL) return NULL;
+    p = strchr(p + strlen(key), ':');
+    if (p) while (*++p == ' ');
+    return p;
+}
+
+// Parse header of file positioned at start. Returns data offset, or -1 on error.
+static isize _cspan_npy_parse_header(FILE* fp, cspan_npy* npy) {
+    unsigned char pre[12];
+    char dict[4096];
+    isize hlen, pre_len = 10;
+    const char* p;
+
+    if (fread(pre, 1, 10, fp) != 10 || memcmp(pre, "\x93NUMPY", 6) != 0)
+        return -1;
+    if (pre[6] == 1) {
+        hlen = pre[8] | pre[9] << 8;
+    } else {
+        if (fread(pre + 10, 1, 2, fp) != 2) return -1;
+        hlen = pre[8] | pre[9] << 8 | (isize)pre[10] << 16 | (isize)pre[11] << 24;
+        pre_len = 12;
+    }
+    if (hlen >= c_sizeof dict || fread(dict, 1, (size_t)hlen, fp) != (size_t)hlen)
+        return -1;
+    dict[hlen] = '\0';
+
+    if (!(p = _cspan_npy_value(dict, "'descr'")) || *p++ != '\'')
+        return -1;
+    int n = 0;
+    while (*p != '\'' && n < c_sizeof npy->descr - 1) npy->descr[n++] = *p++;
+    npy->descr[n] = '\0';
+
+    if (!(p = _cspan_npy_value(dict, "'fortran_order'")))
+        return -1;
+    npy->fortran_order = (*p == 'T');
+
+    if (!(p = _cspan_npy_value(dict, "'shape'")) || *p++ != '(')
+        return -1;
+    npy->rank = 0;
+    npy->size = 1;
+    for (;;) {
+        char* end;
+        while (*p == ' ' || *p == ',') ++p;
+        if (*p == ')') break;
+        long long d = strtoll(p, &end, 10);
+        if (end == p || d < 0 || d > INT32_MAX || npy->rank == c_arraylen(npy->shape) ||
+            (d > 0 && npy->size > PTRDIFF_MAX/d))
+            return -1;
+        npy->shape[npy->rank++] = (_istride)d;
+        npy->size *= (isize)d;
+        p = end;
+    }
+    return pre_len + hlen;
+}
+
+// Byte size of the array data, or -1 if the element size is invalid or the size overflows.
+static isize _cspan_npy_nbytes(const cspan_npy* npy) {
+    const int esz = atoi(npy->descr + 2);
+    if (esz <= 0 || esz > 16 || npy->size > PTRDIFF_MAX/esz)
+        return -1;
+    return npy->size*esz;
+}
+
+STC_DEF bool cspan_npy_load(cspan_npy* npy, const char* path) {
+    FILE* fp = fopen(path, "rb");
+    cspan_npy tmp = {0};
+    isize offset, nbytes;
+    bool ok = false;
+    if (fp == NULL) return false;
+
+    if ((offset = _cspan_npy_parse_header(fp, &tmp)) >= 0 &&
+        (nbytes = _cspan_npy_nbytes(&tmp)) >= 0) {
+        tmp.data = tmp._mem.base = c_malloc(nbytes > 0 ? nbytes : 1);
+        tmp._mem.len = nbytes;
+        ok = tmp.data && fread(tmp.data, 1, (size_t)nbytes, fp) == (size_t)nbytes;
+        if (!ok) c_free(tmp._mem.base, nbytes);
+    }
+    fclose(fp);
+    if (ok) *npy = tmp;
+    return ok;
+}
+
+STC_DEF bool cspan_npy_mmap(cspan_npy* npy, const char* path) {
+  #if defined _cspan_NPY_MMAP
+    cspan_npy tmp = {0};
+    struct stat st;
+    isize offset, nbytes;
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return false;
+    offset = _cspan_npy_parse_header(fp, &tmp);
+    fclose(fp);
+    if (offset < 0 || (nbytes = _cspan_npy_nbytes(&tmp)) < 0) return false;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+        nbytes <= (isize)st.st_size - offset)
+    {
+        void* base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+          #if defined POSIX_MADV_WILLNEED
+            posix_madvise(base, (size_t)st.st_size, POSIX_MADV_WILLNEED);
+          #endif
+            close(fd);
+            tmp._mem.base = base;
+            tmp._mem.len = (isize)st.st_size;
+            tmp._mem.mapped = true;
+            tmp.data = (char*)base + offset;
+            *npy = tmp;
+            return true;
+        }
+    }
+    close(fd);
+  #endif
+    return cspan_npy_load(npy, path);
+}
+
+STC_DEF void cspan_npy_drop(cspan_npy* npy) {
+  #if defined _cspan_NPY_MMAP
+    if (npy->_mem.mapped)
+        munmap(npy->_mem.base, (size_t)npy->_mem.len);
+    else
+  #endif
+        c_free(npy->_mem.base, npy->_mem.len);
+    memset(npy, 0, sizeof *npy);
+}
+
+STC_DEF void* _cspan_npy_get(const cspan_npy* npy, char kind, isize elemsize,
+                             _istride shape[], _istride stride[], int rank) {
+    if (npy->rank != rank || npy->descr[0] != _cspan_npy_byteorder(elemsize) ||
+        npy->descr[1] != kind || atoi(npy->descr + 2) != elemsize)
+        return NULL;
+    for (int i = 0; i < rank; ++i)
+        shape[i] = stride[i] = npy->shape[i];
+    _cspan_shape2stride(npy->fortran_order ? c_COLMAJOR : c_ROWMAJOR, stride, rank);
+    return npy->data;
+}
+
+// Write span elements in C order.
+static bool _cspan_npy_fwrite(FILE* fp, const char* data, isize esz,
+                              const _istride shape[], const _istride stride[], int rank) {
+    char buf[4096];
+    isize n = 0;
+    for (_cspan_runs r = _cspan_runs_init(shape, stride, stride, rank); !r.done; _cspan_runs_next(&r)) {
+        const char* p = data + r.off[0]*esz;
+        if (r.step[0] == 1) {
+            if (fwrite(p, (size_t)esz, (size_t)r.size, fp) != (size_t)r.size) return false;
+            continue;
+        }
+        for (isize i = 0; i < r.size; ++i, n += esz) { // gather strided elements
+            if (n + esz > c_sizeof buf) {
+                if (fwrite(buf, 1, (size_t)n, fp) != (size_t)n) return false;
+                n = 0;
+            }
+            memcpy(buf + n, p + i*r.step[0]*esz, (size_t)esz);
+        }
+        if (fwrite(buf, 1, (size_t)n, fp) != (size_t)n) return false;
+        n = 0;
+    }
+    return true;
+}
+
+STC_DEF bool _cspan_npy_save(const char* path, const void* data, char kind, isize elemsize,
+                             const _istride shape[], const _istride stride[], int rank) {
+    char header[512];
+    isize dims[8], size = 1;
+    bool fortran = rank > 1 && _cspan_is_layout(c_COLMAJOR, shape, stride, rank);
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) return false;
+
+    for (int i = 0; i < rank; ++i)
+        size *= (dims[i] = shape[i]);
+    isize hlen = _cspan_npy_make_header(header, kind, elemsize, dims, rank, fortran);
+    bool ok = fwrite(header, 1, (size_t)hlen, fp) == (size_t)hlen;
+    if (ok) {
+        if (fortran) ok = fwrite(data, (size_t)elemsize, (size_t)size, fp) == (size_t)size;
+        else ok = _cspan_npy_fwrite(fp, (const char*)data, elemsize, shape, stride, rank);
+    }
+    return (fclose(fp) == 0) & ok;
+}
+
+STC_DEF bool _cspan_npy_writer_open(cspan_npy_writer* w, const char* path, char kind, isize elemsize,
+                                    const isize shape[], int rank) {
+    char header[512];
+    isize hlen = _cspan_npy_make_header(header, kind, elemsize, shape, rank, false);
+    w->kind = kind;
+    w->elemsize = elemsize;
+    w->remaining = 1;
+    for (int i = 0; i < rank; ++i) w->remaining *= shape[i];
+    if ((w->fp = fopen(path, "wb")) == NULL)
+        return false;
+    if (fwrite(header, 1, (size_t)hlen, w->fp) != (size_t)hlen) {
+        fclose(w->fp);
+        w->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+STC_DEF bool _cspan_npy_write(cspan_npy_writer* w, const void* data, char kind, isize elemsize,
+                              const _istride shape[], const _istride stride[], int rank) {
+    isize n = _cspan_size(shape, rank);
+    if (w->fp == NULL || kind != w->kind || elemsize != w->elemsize || n > w->remaining)
+        return false;
+    w->remaining -= n;
+    return _cspan_npy_fwrite(w->fp, (const char*)data, elemsize, shape, stride, rank);
+}
+
+STC_DEF bool cspan_npy_writer_close(cspan_npy_writer* w) {
+    bool ok = w->fp != NULL && w->remaining == 0;
+    if (w->fp != NULL && fclose(w->fp) != 0) ok = false;
+    w->fp = NULL;
+    return ok;
+}
+#endif // STC_CSPAN_NPY_C_INCLUDED
@@ -32,7 +32,7 @@ size_t cstr_hash(const cstr *self) {
 
 isize cstr_find_sv(const cstr* self, csview search) {
     csview sv = cstr_sv(self);
-    char* res = c_strnstrn(sv.buf, sv.size, search.buf, search.size);
+    const char* res = c_strsearch(sv.buf, sv.size, search.buf, search.size);
     return res ? (res - sv.buf) : c_NPOS;
 }
 
@@ -120,10 +120,13 @@ char* cstr_append_n(cstr* self, const char* str, const isize len) {
 
 cstr cstr_from_replace(csview in, csview search, csview repl, int32_t count) {
     cstr out = cstr_init();
-    isize from = 0; char* res;
+    isize from = 0; const char* res;
+    csearcher searcher = {0}; // size 0: short needle, not worth the searcher setup
+    if (search.size >= _csearch_SHORT) searcher = csearcher_from(search);
     if (count == 0) count = INT32_MAX;
     if (search.size)
-        while (count-- && (res = c_strnstrn(in.buf + from, in.size - from, search.buf, search.size))) {
+        while (count-- && (res = searcher.size ? csearcher_find(&searcher, c_sv(in.buf + from, in.size - from))
+                                               : c_strnstrn(in.buf + from, in.size - from, search.buf, search.size))) {
             const isize pos = (res - in.buf);
             cstr_append_n(&out, in.buf + from, pos - from);
             cstr_append_n(&out, repl.buf, repl.size);
@@ -170,7 +173,40 @@ char* cstr_append_uninit(cstr *self, isize len) {
     return r.data + r.size;
 }
 
+/* Read newline-terminated lines in blocks with fgets(). The block is prefilled with '\n'
+ * in order to find the number of bytes read even when the line contains '\0' bytes:
+ * a newline read by fgets() is followed by '\0', a prefilled one is preceded by it. */
+static bool _cstr_getline(cstr *self, FILE *fp) {
+    enum { BLOCK = 512 };
+    isize pos = 0;
+    for (;;) {
+        cstr_view r = cstr_getview(self);
+        if (r.cap - pos < BLOCK/2) {
+            _cstr_set_size(self, pos);
+            r.data = cstr_reserve(self, r.cap*3/2 + BLOCK);
+            r.cap = cstr_capacity(self);
+        }
+        const isize n = r.cap - pos + 1 < BLOCK ? r.cap - pos + 1 : BLOCK;
+        char* b = r.data + pos;
+        c_memset(b, '\n', n);
+        if (fgets(b, (int)n, fp) == NULL) {
+            _cstr_set_size(self, pos);
+            return pos > 0;
+        }
+        const char* nl = (const char*)memchr(b, '\n', (size_t)n);
+        if (nl == NULL) { // block is filled, no newline yet
+            pos += n - 1;
+            continue;
+        }
+        const bool found = nl + 1 < b + n && nl[1] == '\0';
+        _cstr_set_size(self, pos + (nl - b) - !found);
+        return true;
+    }
+}
+
 bool cstr_getdelim(cstr *self, const int delim, FILE *fp) {
+    if (delim == '\n')
+        return _cstr_getline(self, fp);
     int c = fgetc(fp);
     if (c == EOF)
         return false;
@@ -190,11 +226,46 @@ bool cstr_getdelim(cstr *self, const int delim, FILE *fp) {
     }
 }
 
+bool cstr_lines_next(cstr_lines* self, csview* line) {
+    bool spilled = false;
+    if (self->buf == NULL)
+        self->buf = (char *)i_malloc(cstr_lines_BLOCK);
+    for (;;) {
+        const char* b = self->buf + self->pos;
+        const char* p = (const char*)memchr(b, self->delim, (size_t)(self->end - self->pos));
+        if (p != NULL) {
+            self->pos += (p - b) + 1;
+            if (!spilled) {
+                *line = c_sv(b, p - b);
+                return true;
+            }
+            cstr_append_n(&self->spill, b, p - b);
+            break;
+        }
+        if (self->pos < self->end) { // line continues in the next block
+            if (!spilled) cstr_clear(&self->spill);
+            cstr_append_n(&self->spill, b, self->end - self->pos);
+            spilled = true;
+        }
+        self->pos = 0;
+        self->end = (isize)fread(self->buf, 1, cstr_lines_BLOCK, self->fp);
+        if (self->end == 0) {
+            if (!spilled) return false;
+            break;
+        }
+    }
+    *line = cstr_sv(&self->spill);
+    return true;
+}
+
+/* Formats directly into the spare capacity, and only formats a second time when it does not fit. */
 static isize cstr_vfmt(cstr* self, isize start, const char* fmt, va_list args) {
     va_list args2;
     va_copy(args2, args);
-    const int n = vsnprintf(NULL, 0ULL, fmt, args);
-    vsnprintf(cstr_reserve(self, start + n) + start, (size_t)n+1, fmt, args2);
+    cstr_view r = cstr_getview(self);
+    const int n = vsnprintf(r.data + start, (size_t)(r.cap - start) + 1, fmt, args);
+    if (n > r.cap - start)
+        vsnprintf(cstr_reserve(self, start + n) + start, (size_t)n+1, fmt, args2);
     va_end(args2);
     _cstr_set_size(self, start + n);
     return n;
@@ -225,6 +296,204 @@ isize cstr_printf(cstr* self, const char* fmt, ...) {
     va_end(args);
     return n;
 }
+
+static const char _cstr_digits2[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static int _cstr_utoa(char* end, uint64_t val) { // writes backwards from end
+    char* p = end;
+    for (; val >= 100; val /= 100)
+        c_memcpy(p -= 2, _cstr_digits2 + 2*(val % 100), 2);
+    if (val >= 10) c_memcpy(p -= 2, _cstr_digits2 + 2*val, 2);
+    else *--p = (char)('0' + val);
+    return (int)(end - p);
+}
+
+isize cstr_append_uint(cstr* self, uint64_t val) {
+    char buf[24];
+    const int n = _cstr_utoa(buf + sizeof buf, val);
+    c_memcpy(cstr_append_uninit(self, n), buf + sizeof buf - n, n);
+    return n;
+}
+
+isize cstr_append_int(cstr* self, int64_t val) {
+    char buf[24];
+    int n = _cstr_utoa(buf + sizeof buf, val < 0 ? 0 - (uint64_t)val : (uint64_t)val);
+    if (val < 0) buf[(int)sizeof buf - ++n] = '-';
+    c_memcpy(cstr_append_uninit(self, n), buf + sizeof buf - n, n);
+    return n;
+}
+
+/* Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+ * Generates the digits of a positive double which read back to the same value, and are the
+ * shortest such digits in all but rare cases. */
+typedef struct { uint64_t f; int e; } _cstr_diyfp;
+
+static _cstr_diyfp _cstr_diyfp_mul(_cstr_diyfp x, _cstr_diyfp y) { // upper 64 bits, rounded
+    const uint64_t M32 = 0xFFFFFFFFu, a = x.f >> 32, b = x.f & M32, c = y.f >> 32, d = y.f & M32;
+    const uint64_t ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+    const uint64_t mid = (bd >> 32) + (ad & M32) + (bc & M32) + (1u << 31);
+    _cstr_diyfp r = {ac + (ad >> 32) + (bc >> 32) + (mid >> 32), x.e + y.e + 64};
+    return r;
+}
+
+static _cstr_diyfp _cstr_cached_pow10(int e, int* K) { // 10^-K, such that the product has e in [-60, -32]
+    static const uint64_t F[] = {
+        0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76, 0xcf42894a5dce35ea,
+        0x9a6bb0aa55653b2d, 0xe61acf033d1a45df, 0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f,
+        0xbe5691ef416bd60c, 0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+        0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57, 0xc21094364dfb5637,
+        0x9096ea6f3848984f, 0xd77485cb25823ac7, 0xa086cfcd97bf97f4, 0xef340a98172aace5,
+        0xb23867fb2a35b28e, 0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+        0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126, 0xb5b5ada8aaff80b8,
+        0x87625f056c7c4a8b, 0xc9bcff6034c13053, 0x964e858c91ba2655, 0xdff9772470297ebd,
+        0xa6dfbd9fb8e5b88f, 0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+        0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06, 0xaa242499697392d3,
+        0xfd87b5f28300ca0e, 0xbce5086492111aeb, 0x8cbccc096f5088cc, 0xd1b71758e219652c,
+        0x9c40000000000000, 0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+        0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068, 0x9f4f2726179a2245,
+        0xed63a231d4c4fb27, 0xb0de65388cc8ada8, 0x83c7088e1aab65db, 0xc45d1df942711d9a,
+        0x924d692ca61be758, 0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+        0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d, 0x952ab45cfa97a0b3,
+        0xde469fbd99a05fe3, 0xa59bc234db398c25, 0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece,
+        0x88fcf317f22241e2, 0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+        0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410, 0x8bab8eefb6409c1a,
+        0xd01fef10a657842c, 0x9b10a4e5e9913129, 0xe7109bfba19c0c9d, 0xac2820d9623bf429,
+        0x80444b5e7aa7cf85, 0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+        0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b,
+    };
+    static const int16_t E[] = {
+        -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927, -901, -874, -847,
+        -821, -794, -768, -741, -715, -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+        -422, -396, -369, -343, -316, -289, -263, -236, -210, -183, -157, -130, -103, -77, -50,
+        -24, 3, 30, 56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+        375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747,
+        774, 800, 827, 853, 880, 907, 933, 960, 986, 1013, 1039, 1066,
+    };
+    const double dk = (-61 - e)*0.30102999566398114 + 347; // log10(2)
+    int k = (int)dk;
+    if (dk - k > 0.0) ++k;
+    const int i = (k >> 3) + 1;
+    *K = -(-348 + i*8);
+    _cstr_diyfp r = {F[i], E[i]};
+    return r;
+}
+
+static void _cstr_grisu_round(char* buf, int len, uint64_t delta, uint64_t rest,
+                              uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        --buf[len - 1];
+        rest += ten_kappa;
+    }
+}
+
+static int _cstr_grisu2(double value, char* buf, int* K) { // value > 0. returns number of digits
+    static const uint64_t pow10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+        10000000000, 100000000000, 1000000000000, 10000000000000, 100000000000000,
+        1000000000000000, 10000000000000000, 100000000000000000, 1000000000000000000,
+        10000000000000000000u,
+    };
+    const uint64_t HIDDEN = (uint64_t)1 << 52;
+    uint64_t u;
+    c_memcpy(&u, &value, 8);
+    const int biased_e = (int)(u >> 52 & 0x7FF);
+    _cstr_diyfp v = {u & (HIDDEN - 1), 1 - 1075};
+    if (biased_e) v.f += HIDDEN, v.e = biased_e - 1075;
+
+    _cstr_diyfp wp = {(v.f << 1) + 1, v.e - 1}, wm; // upper and lower boundaries
+    while (!(wp.f & (HIDDEN << 1))) wp.f <<= 1, --wp.e;
+    wp.f <<= 64 - 52 - 2, wp.e -= 64 - 52 - 2;
+    if (v.f == HIDDEN) wm.f = (v.f << 2) - 1, wm.e = v.e - 2;
+    else               wm.f = (v.f << 1) - 1, wm.e = v.e - 1;
+    wm.f <<= wm.e - wp.e, wm.e = wp.e;
+    while (!(v.f & ((uint64_t)1 << 63))) v.f <<= 1, --v.e;
+
+    const _cstr_diyfp c_mk = _cstr_cached_pow10(wp.e, K);
+    const _cstr_diyfp W = _cstr_diyfp_mul(v, c_mk);
+    _cstr_diyfp Mp = _cstr_diyfp_mul(wp, c_mk), Mm = _cstr_diyfp_mul(wm, c_mk);
+    ++Mm.f, --Mp.f;
+
+    // generate digits of Mp until they are within delta of it
+    uint64_t delta = Mp.f - Mm.f;
+    const int shift = -Mp.e;
+    const uint64_t one = (uint64_t)1 << shift, wp_w = Mp.f - W.f;
+    uint32_t p1 = (uint32_t)(Mp.f >> shift);
+    uint64_t p2 = Mp.f & (one - 1);
+    int kappa = 1, len = 0;
+    while (kappa < 10 && p1 >= pow10[kappa]) ++kappa;
+    while (kappa > 0) {
+        const uint32_t d = p1 / (uint32_t)pow10[kappa - 1];
+        p1 %= (uint32_t)pow10[kappa - 1];
+        if (d || len) buf[len++] = (char)('0' + d);
+        --kappa;
+        const uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *K += kappa;
+            _cstr_grisu_round(buf, len, delta, rest, pow10[kappa] << shift, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        p2 *= 10, delta *= 10;
+        const char d = (char)(p2 >> shift);
+        if (d || len) buf[len++] = (char)('0' + d);
+        p2 &= one - 1;
+        --kappa;
+        if (p2 < delta) {
+            *K += kappa;
+            _cstr_grisu_round(buf, len, delta, p2, one, -kappa < 20 ? wp_w*pow10[-kappa] : 0);
+            return len;
+        }
+    }
+}
+
+/* Shortest representation which reads back to the same double, formatted as "%.17g" would,
+ * except without trailing zeros: fixed notation for decimal exponents -5 < exp < 17. */
+isize cstr_append_double(cstr* self, double val) {
+    char buf[32], digits[20], *p = buf;
+    uint64_t u;
+    c_memcpy(&u, &val, 8);
+    if (u >> 63) *p++ = '-', u &= ~((uint64_t)1 << 63);
+    if (u >= (uint64_t)0x7FF << 52) {
+        if (u > (uint64_t)0x7FF << 52) p = buf;
+        c_memcpy(p, u > (uint64_t)0x7FF << 52 ? "nan" : "inf", 3), p += 3;
+    } else if (u == 0) {
+        *p++ = '0';
+    } else {
+        c_memcpy(&val, &u, 8);
+        int K, len = _cstr_grisu2(val, digits, &K);
+        const int kk = len + K, exp = kk - 1; // value = 0.digits * 10^kk
+        if (exp < -4 || exp >= 17) {
+            *p++ = digits[0];
+            if (len > 1) {
+                *p++ = '.';
+                c_memcpy(p, digits + 1, len - 1), p += len - 1;
+            }
+            *p++ = 'e', *p++ = exp < 0 ? '-' : '+';
+            const int e = exp < 0 ? -exp : exp;
+            if (e >= 100) *p++ = (char)('0' + e/100);
+            c_memcpy(p, _cstr_digits2 + 2*(e % 100), 2), p += 2;
+        } else if (kk >= len) { // integer
+            c_memcpy(p, digits, len), p += len;
+            c_memset(p, '0', kk - len), p += kk - len;
+        } else if (kk > 0) {
+            c_memcpy(p, digits, kk), p += kk;
+            *p++ = '.';
+            c_memcpy(p, digits + kk, len - kk), p += len - kk;
+        } else {
+            *p++ = '0', *p++ = '.';
+            c_memset(p, '0', -kk), p += -kk;
+            c_memcpy(p, digits, len), p += len;
+        }
+    }
+    const isize n = p - buf;
+    c_memcpy(cstr_append_uninit(self, n), buf, n);
+    return n;
+}
 #endif // STC_CSTR_IO_C_INCLUDED
 
 // ------------------- STC_CSTR_UTF8 --------------------
@@ -244,33 +513,25 @@ void cstr_u8_erase(cstr* self, const isize u8pos, const isize u8len) {
 bool cstr_u8_valid(const cstr* self)
     { return utf8_valid(cstr_str(self)); }
 
-static int toLower(int c)
-    { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
-static int toUpper(int c)
-    { return c >= 'a' && c <= 'z' ? c - 32 : c; }
-static struct {
-    int      (*conv_asc)(int);
-    uint32_t (*conv_utf)(uint32_t);
-}
-fn_tocase[] = {{toLower, utf8_casefold},
-               {toLower, utf8_tolower},
-               {toUpper, utf8_toupper}};
-
 cstr cstr_tocase_sv(csview sv, int k) {
     cstr out = {0};
     char *buf = cstr_reserve(&out, sv.size*3/2);
-    const char *end = sv.buf + sv.size;
-    uint32_t cp; isize sz = 0;
+    const char *end = sv.buf + sv.size, *next_block = sv.buf;
+    isize sz = 0;
     utf8_decode_t d = {.state=0};
 
     while (sv.buf < end) {
-        do { utf8_decode(&d, (uint8_t)*sv.buf++); } while (d.state);
-        if (d.codep < 128)
-            buf[sz++] = (char)fn_tocase[k].conv_asc((int)d.codep);
-        else {
-            cp = fn_tocase[k].conv_utf(d.codep);
-            sz += utf8_encode(buf + sz, cp);
+        if (sv.buf >= next_block) { // map ASCII blocks, retry after a block
+            const isize n = _utf8_ascii_tocase(buf + sz, sv.buf, end - sv.buf, k);
+            sz += n, sv.buf += n, next_block = sv.buf + 8;
+            if (sv.buf == end) break;
+        }
+        if ((uint8_t)*sv.buf < 128) {
+            buf[sz++] = (char)_utf8_tocase((uint8_t)*sv.buf++, k);
+            continue;
         }
+        do { utf8_decode(&d, (uint8_t)*sv.buf++); } while (d.state);
+        sz += utf8_encode(buf + sz, _utf8_tocase(d.codep, k));
     }
     _cstr_set_size(&out, sz);
     cstr_shrink_to_fit(&out);
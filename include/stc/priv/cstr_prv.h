@@ -76,6 +76,9 @@ STC_INLINE char*    cstr_append(cstr* self, const char* str);
 STC_INLINE char*    cstr_append_s(cstr* self, cstr s);
 extern  char*       cstr_append_n(cstr* self, const char* str, isize len);
 extern  isize       cstr_append_fmt(cstr* self, const char* fmt, ...);
+extern  isize       cstr_append_int(cstr* self, int64_t val);
+extern  isize       cstr_append_uint(cstr* self, uint64_t val);
+extern  isize       cstr_append_double(cstr* self, double val); // shortest round-trip
 extern  char*       cstr_append_uninit(cstr *self, isize len);
 extern  bool        cstr_getdelim(cstr *self, int delim, FILE *fp);
 extern  void        cstr_erase(cstr* self, isize pos, isize len);
@@ -223,6 +226,22 @@ STC_INLINE cstr_iter cstr_u8_at(const cstr* self, isize u8pos) {
     return c_literal(cstr_iter){.chr = sv};
 }
 
+/* positional access using an index built by utf8_index_from(cstr_sv(self)). invalid after modification */
+STC_INLINE csview cstr_u8_subview_ix(const cstr* self, const utf8_index* ix, isize u8pos, isize u8len) {
+    const char* s = cstr_str(self); csview sv;
+    sv.buf = utf8_index_at(ix, s, u8pos);
+    sv.size = utf8_index_at(ix, s, u8pos + u8len) - sv.buf;
+    return sv;
+}
+
+STC_INLINE cstr_iter cstr_u8_at_ix(const cstr* self, const utf8_index* ix, isize u8pos) {
+    csview sv;
+    sv.buf = utf8_index_at(ix, cstr_str(self), u8pos);
+    sv.size = utf8_chr_size(sv.buf);
+    c_assert(sv.size);
+    return c_literal(cstr_iter){.chr = sv};
+}
+
 // utf8 iterator
 
 STC_INLINE cstr_iter cstr_begin(const cstr* self) {
@@ -270,20 +289,17 @@ STC_INLINE void cstr_lowercase(cstr* self)
 STC_INLINE void cstr_uppercase(cstr* self)
     { cstr_take(self, cstr_toupper_sv(cstr_sv(self))); }
 
-STC_INLINE bool cstr_istarts_with(const cstr* self, const char* sub) {
-    csview sv = cstr_sv(self);
-    isize len = c_strlen(sub);
-    return len <= sv.size && !utf8_icompare(sv, c_sv(sub, len));
-}
+STC_INLINE bool cstr_istarts_with(const cstr* self, const char* sub)
+    { return _utf8_istarts_with(cstr_sv(self), c_sv(sub, c_strlen(sub))); }
 
 STC_INLINE bool cstr_iends_with(const cstr* self, const char* sub) {
     csview sv = cstr_sv(self);
     isize n = c_strlen(sub);
-    return n <= sv.size && !utf8_icmp(sv.buf + sv.size - n, sub);
+    return n <= sv.size && !utf8_icompare(c_sv(sv.buf + sv.size - n, n), c_sv(sub, n));
 }
 
 STC_INLINE int cstr_icmp(const cstr* s1, const cstr* s2)
-    { return utf8_icmp(cstr_str(s1), cstr_str(s2)); }
+    { return utf8_icompare(cstr_sv(s1), cstr_sv(s2)); }
 
 STC_INLINE bool cstr_ieq(const cstr* s1, const cstr* s2) {
     csview x = cstr_sv(s1), y = cstr_sv(s2);
@@ -291,7 +307,7 @@ STC_INLINE bool cstr_ieq(const cstr* s1, const cstr* s2) {
 }
 
 STC_INLINE bool cstr_iequals(const cstr* self, const char* str)
-    { return !utf8_icmp(cstr_str(self), str); }
+    { return !utf8_icompare(cstr_sv(self), c_sv(str, c_strlen(str))); }
 
 // END utf8 =====
 
@@ -427,4 +443,26 @@ STC_INLINE void cstr_u8_insert(cstr* self, isize u8pos, const char* str)
 STC_INLINE bool cstr_getline(cstr *self, FILE *fp)
     { return cstr_getdelim(self, '\n', fp); }
 
+/* Block-buffered line reader. Lines are zero-copy views into the block buffer, except lines
+ * spanning two blocks, which are collected in a cstr. A line is valid until the next call.
+ * The reader consumes the stream in blocks, so do not mix with other reads from fp. */
+enum { cstr_lines_BLOCK = 1 << 16 };
+typedef struct {
+    FILE* fp;
+    char* buf;
+    isize pos, end;
+    cstr spill;
+    int delim;
+} cstr_lines;
+
+extern  bool        cstr_lines_next(cstr_lines* self, csview* line);
+
+STC_INLINE cstr_lines cstr_lines_from(FILE* fp, int delim)
+    { cstr_lines rd = {.fp = fp, .delim = delim}; return rd; }
+
+STC_INLINE void cstr_lines_drop(cstr_lines* self) {
+    if (self->buf) i_free(self->buf, cstr_lines_BLOCK);
+    cstr_drop(&self->spill);
+}
+
 #endif // STC_CSTR_PRV_H_INCLUDED
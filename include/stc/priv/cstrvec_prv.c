@@ -0,0 +1,290 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Tyge Løvset
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STC_CSTRVEC_PRV_C_INCLUDED
+#define STC_CSTRVEC_PRV_C_INCLUDED
+
+static const char _cstrvec_magic[8] = {'S', 'T', 'C', 'S', 'V', 'E', 'C', '1'};
+
+static isize _cstrvec_record_size(isize len) { // LEB128 prefix + bytes + zero
+    isize n = len + 2;
+    while (len >= 0x80) len >>= 7, ++n;
+    return n;
+}
+
+static isize _cstrvec_record_end(const cstrvec* self, isize idx) {
+    csview sv = cstrvec_at(self, idx);
+    return sv.buf + sv.size + 1 - self->chars;
+}
+
+static void _cstrvec_put(char* dst, csview sv) {
+    uint8_t* p = (uint8_t*)dst;
+    size_t n = (size_t)sv.size;
+    for (; n >= 0x80; n >>= 7) *p++ = (uint8_t)(n | 0x80);
+    *p++ = (uint8_t)n;
+    c_memcpy(p, sv.buf, sv.size);
+    p[sv.size] = '\0';
+}
+
+// Both buffers are allocated before either is replaced, so self is unchanged on failure.
+STC_DEF bool cstrvec_reserve(cstrvec* self, isize n, isize nchars) {
+    isize* offset = self->offset;
+    char* chars = self->chars;
+    if (n > self->capacity) {
+        if (n > PTRDIFF_MAX/c_sizeof(isize) || (offset = (isize*)i_malloc(n*c_sizeof(isize))) == NULL)
+            return false;
+    }
+    if (nchars > self->chars_capacity && (chars = (char*)i_malloc(nchars)) == NULL) {
+        if (offset != self->offset) i_free(offset, n*c_sizeof(isize));
+        return false;
+    }
+    if (offset != self->offset) {
+        c_memcpy(offset, self->offset, self->size*c_sizeof(isize));
+        i_free(self->offset, self->capacity*c_sizeof(isize));
+        self->offset = offset, self->capacity = n;
+    }
+    if (chars != self->chars) {
+        c_memcpy(chars, self->chars, self->chars_size);
+        i_free(self->chars, self->chars_capacity);
+        self->chars = chars, self->chars_capacity = nchars;
+    }
+    return true;
+}
+
+STC_DEF cstrvec cstrvec_with_capacity(isize n, isize nchars) {
+    cstrvec v = cstrvec_init();
+    cstrvec_reserve(&v, n, nchars);
+    return v;
+}
+
+STC_DEF void cstrvec_drop(const cstrvec* self) {
+    i_free(self->offset, self->capacity*c_sizeof(isize));
+    i_free(self->chars, self->chars_capacity);
+}
+
+STC_DEF void cstrvec_clear(cstrvec* self)
+    { self->size = self->chars_size = 0; }
+
+STC_DEF csview cstrvec_push(cstrvec* self, csview sv) {
+    const isize rec = _cstrvec_record_size(sv.size);
+    if (self->size == self->capacity || self->chars_size + rec > self->chars_capacity) {
+        const isize from = sv.buf - self->chars; // sv may be a string in self
+        const bool inside = self->chars && c_uless(from, self->chars_size);
+        if (!cstrvec_reserve(self, self->size*3/2 + 4, (self->chars_size + rec)*3/2 + 64))
+            return c_sv("", 0);
+        if (inside) sv.buf = self->chars + from;
+    }
+    _cstrvec_put(self->chars + self->chars_size, sv);
+    self->offset[self->size] = self->chars_size;
+    self->chars_size += rec;
+    return cstrvec_at(self, self->size++);
+}
+
+STC_DEF void cstrvec_pop(cstrvec* self) {
+    c_assert(self->size > 0);
+    const isize idx = self->size - 1;
+    if (_cstrvec_record_end(self, idx) == self->chars_size) // reclaim the chars if last in buffer
+        self->chars_size = self->offset[idx];
+    self->size = idx;
+}
+
+STC_DEF void cstrvec_erase_n(cstrvec* self, isize idx, isize n) {
+    c_assert(idx >= 0 && n >= 0 && idx + n <= self->size);
+    c_memmove(self->offset + idx, self->offset + idx + n, (self->size - idx - n)*c_sizeof(isize));
+    self->size -= n;
+}
+
+static isize _cstrvec_packed_size(const cstrvec* self, bool* in_order) {
+    isize total = 0;
+    *in_order = true;
+    for (isize i = 0; i < self->size; ++i) {
+        if (self->offset[i] != total) *in_order = false;
+        total += _cstrvec_record_end(self, i) - self->offset[i];
+    }
+    return total;
+}
+
+static cstrvec _cstrvec_repack(const cstrvec* self, isize extra) {
+    bool in_order;
+    const isize total = _cstrvec_packed_size(self, &in_order);
+    cstrvec v = cstrvec_with_capacity(self->size + extra, total);
+    if (v.capacity < self->size || v.chars_capacity < total)
+        return v;
+    if (in_order) {
+        c_memcpy(v.chars, self->chars, total);
+        c_memcpy(v.offset, self->offset, self->size*c_sizeof(isize));
+    } else for (isize i = 0; i < self->size; ++i) {
+        const isize len = _cstrvec_record_end(self, i) - self->offset[i];
+        c_memcpy(v.chars + v.chars_size, self->chars + self->offset[i], len);
+        v.offset[i] = v.chars_size;
+        v.chars_size += len;
+    }
+    v.size = self->size, v.chars_size = total;
+    return v;
+}
+
+STC_DEF cstrvec cstrvec_clone(cstrvec v)
+    { return _cstrvec_repack(&v, 0); }
+
+STC_DEF void cstrvec_compact(cstrvec* self) {
+    cstrvec v = _cstrvec_repack(self, self->capacity - self->size);
+    if (v.size == self->size) cstrvec_take(self, v);
+    else cstrvec_drop(&v);
+}
+
+// Sort keys: the first 8 bytes big endian, so most comparisons do not follow the offsets.
+typedef struct { uint64_t prefix; const char* rec; } _cstrvec_key;
+
+static bool _cstrvec_key_less(const _cstrvec_key* x, const _cstrvec_key* y) {
+    if (x->prefix != y->prefix)
+        return x->prefix < y->prefix;
+    const csview a = _cstrvec_record(x->rec), b = _cstrvec_record(y->rec);
+    return _cstrvec_cmp(&a, &b) < 0;
+}
+
+static void _cstrvec_keys_sort_lowhigh(_cstrvec_key* arr, isize lo, isize hi); // sort.h instance below
+
+STC_DEF void cstrvec_sort(cstrvec* self) {
+    _cstrvec_key* key = (_cstrvec_key*)i_malloc(self->size*c_sizeof(_cstrvec_key));
+    if (key == NULL)
+        return;
+    for (isize i = 0; i < self->size; ++i) {
+        const csview sv = cstrvec_at(self, i);
+        uint8_t b[8] = {0};
+        c_memcpy(b, sv.buf, sv.size < 8 ? sv.size : 8);
+        key[i].prefix = (uint64_t)b[0] << 56 | (uint64_t)b[1] << 48 | (uint64_t)b[2] << 40 | (uint64_t)b[3] << 32 |
+                        (uint64_t)b[4] << 24 | (uint64_t)b[5] << 16 | (uint64_t)b[6] << 8 | b[7];
+        key[i].rec = self->chars + self->offset[i];
+    }
+    _cstrvec_keys_sort_lowhigh(key, 0, self->size - 1);
+    for (isize i = 0; i < self->size; ++i)
+        self->offset[i] = key[i].rec - self->chars;
+    i_free(key, self->size*c_sizeof(_cstrvec_key));
+}
+
+STC_DEF isize cstrvec_lower_bound(const cstrvec* self, csview key) {
+    isize lo = 0, count = self->size;
+    while (count > 0) {
+        const isize step = count/2;
+        const csview x = cstrvec_at(self, lo + step);
+        if (_cstrvec_cmp(&x, &key) < 0)
+            lo += step + 1, count -= step + 1;
+        else
+            count = step;
+    }
+    return lo == self->size ? c_NPOS : lo;
+}
+
+STC_DEF isize cstrvec_binary_search(const cstrvec* self, csview key) {
+    const isize idx = cstrvec_lower_bound(self, key);
+    return idx != c_NPOS && cstrvec_eq_at(self, idx, key) ? idx : c_NPOS;
+}
+
+STC_DEF isize cstrvec_append_lines(cstrvec* self, FILE* fp, int delim) {
+    cstr_lines rd = cstr_lines_from(fp, delim);
+    csview line;
+    isize n = 0;
+    for (; cstr_lines_next(&rd, &line); ++n)
+        cstrvec_push(self, line);
+    cstr_lines_drop(&rd);
+    return n;
+}
+
+STC_DEF bool cstrvec_write_lines(const cstrvec* self, FILE* fp, int delim) {
+    for (isize i = 0; i < self->size; ++i) {
+        const csview sv = cstrvec_at(self, i);
+        if (fwrite(sv.buf, 1, (size_t)sv.size, fp) != (size_t)sv.size || fputc(delim, fp) == EOF)
+            return false;
+    }
+    return true;
+}
+
+// Format: 8 byte magic, int64 number of strings and packed size (native endian), then
+// the records in element order.
+STC_DEF bool cstrvec_save(const cstrvec* self, FILE* fp) {
+    bool in_order;
+    const int64_t head[2] = {self->size, _cstrvec_packed_size(self, &in_order)};
+    if (fwrite(_cstrvec_magic, 1, sizeof _cstrvec_magic, fp) != sizeof _cstrvec_magic ||
+        fwrite(head, sizeof head[0], 2, fp) != 2)
+        return false;
+    if (in_order)
+        return fwrite(self->chars, 1, (size_t)head[1], fp) == (size_t)head[1];
+    for (isize i = 0; i < self->size; ++i) {
+        const size_t len = (size_t)(_cstrvec_record_end(self, i) - self->offset[i]);
+        if (fwrite(self->chars + self->offset[i], 1, len, fp) != len)
+            return false;
+    }
+    return true;
+}
+
+// Loads into a new vector, so self is unchanged when the file is invalid or allocation fails.
+STC_DEF bool cstrvec_load(cstrvec* self, FILE* fp) {
+    char magic[sizeof _cstrvec_magic];
+    int64_t head[2];
+    if (fread(magic, 1, sizeof magic, fp) != sizeof magic || c_memcmp(magic, _cstrvec_magic, c_sizeof magic) ||
+        fread(head, sizeof head[0], 2, fp) != 2 || head[1] < 0 || head[1] > PTRDIFF_MAX ||
+        head[0] < 0 || head[0] > head[1]/2 || head[0] > PTRDIFF_MAX/c_sizeof(isize))
+        return false;
+    const isize n = (isize)head[0], nchars = (isize)head[1];
+    const long cur = ftell(fp); // when seekable, nchars must fit in the rest of the file
+    if (cur >= 0 && fseek(fp, 0, SEEK_END) == 0) {
+        const long end = ftell(fp);
+        if (fseek(fp, cur, SEEK_SET) != 0 || (end >= 0 && end - cur < nchars))
+            return false;
+    }
+    cstrvec v = cstrvec_init();
+    if (!cstrvec_reserve(&v, n, nchars) || fread(v.chars, 1, (size_t)nchars, fp) != (size_t)nchars)
+        goto fail;
+
+    // rebuild and validate the offsets
+    const uint8_t* p = (const uint8_t*)v.chars;
+    isize pos = 0;
+    for (isize i = 0; i < n; ++i) {
+        size_t len = 0;
+        int shift = 0;
+        v.offset[i] = pos;
+        do {
+            if (pos == nchars || shift > 56) goto fail;
+            len |= (size_t)(p[pos] & 0x7f) << shift;
+            shift += 7;
+        } while (p[pos++] & 0x80);
+        if (len >= (size_t)(nchars - pos) || p[pos + (isize)len] != 0)
+            goto fail;
+        pos += (isize)len + 1;
+    }
+    if (pos != nchars)
+        goto fail;
+    v.size = n, v.chars_size = nchars;
+    cstrvec_take(self, v);
+    return true;
+
+    fail: cstrvec_drop(&v);
+    return false;
+}
+
+// Instantiated last: sort.h resets the linkage and allocator macros used above.
+#define i_type _cstrvec_keys, _cstrvec_key
+#define i_less _cstrvec_key_less
+#define i_static
+#include "../sort.h"
+
+#endif // STC_CSTRVEC_PRV_C_INCLUDED
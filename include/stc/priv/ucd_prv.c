@@ -41,17 +41,345 @@ enum {
     U8G_SIZE
 };
 
-static bool utf8_isgroup(int group, uint32_t c);
+/* Group membership bitmasks for the BMP in a two-stage table: two array lookups per codepoint.
+   Generated by src/utf8_tab.py ucd. Group ranges were originally extracted from the RE2 library. */
+enum { _utf8_UCD_SHIFT = 5 };
+
+static const uint32_t _utf8_ucd_masks[33] = {
+    0x000000, 0x000001, 0x000004, 0x000008, 0x000010, 0x000020,
+    0x000040, 0x000080, 0x000100, 0x000200, 0x000400, 0x000800,
+    0x001000, 0x001004, 0x001100, 0x002000, 0x002004, 0x002100,
+    0x004000, 0x008000, 0x008004, 0x010000, 0x020000, 0x020002,
+    0x040000, 0x040008, 0x080000, 0x100000, 0x200000, 0x200002,
+    0x200008, 0x400000, 0x400004,
+};
+
+static const uint8_t _utf8_ucd_stage1[2048] = {
+    0, 1, 2, 3, 0, 4, 5, 5, 6, 6, 6, 6, 6, 6, 7, 8, 6, 6, 6, 6,
+    6, 9, 10, 11, 10, 10, 10, 12, 13, 14, 15, 16, 17, 17, 17, 17, 18, 17, 17, 17,
+    17, 19, 10, 10, 20, 21, 10, 10, 22, 23, 24, 25, 23, 23, 26, 27, 10, 10, 28, 23,
+    10, 10, 29, 30, 10, 10, 10, 28, 31, 23, 23, 32, 33, 33, 34, 35, 36, 37, 38, 39,
+    10, 10, 10, 40, 10, 10, 10, 41, 10, 10, 10, 40, 10, 10, 10, 42, 10, 10, 10, 40,
+    10, 10, 10, 40, 10, 10, 10, 40, 10, 10, 10, 40, 43, 44, 45, 10, 10, 10, 46, 10,
+    10, 29, 10, 10, 10, 10, 10, 10, 10, 10, 29, 10, 46, 47, 48, 49, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    50, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    51, 10, 10, 52, 10, 10, 10, 10, 10, 10, 53, 29, 54, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 40, 10, 10, 10, 46, 10, 10, 10, 10, 10, 55, 10, 10, 10, 10, 10, 46, 10,
+    10, 46, 10, 10, 10, 10, 55, 10, 56, 57, 10, 10, 6, 58, 59, 60, 6, 61, 10, 10,
+    6, 6, 6, 6, 6, 6, 6, 6, 62, 15, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72,
+    73, 74, 75, 10, 10, 76, 77, 78, 79, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 6, 10, 10, 10, 10,
+    47, 80, 10, 10, 10, 10, 10, 17, 81, 82, 83, 10, 84, 85, 85, 86, 85, 85, 85, 85,
+    85, 85, 87, 10, 88, 89, 90, 91, 92, 93, 94, 95, 10, 10, 10, 10, 10, 10, 10, 96,
+    10, 10, 10, 10, 10, 10, 96, 97, 94, 94, 98, 10, 10, 10, 10, 10, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 10, 10, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85, 85,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 29, 17, 17, 17, 10, 10, 99, 10, 100, 6, 6,
+    101, 6, 102, 103, 10, 104, 10, 10, 10, 10, 46, 33, 29, 10, 10, 10, 10, 10, 46, 46,
+    10, 10, 46, 10, 10, 10, 10, 10, 10, 105, 106, 107, 10, 10, 10, 46, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 85, 85, 85, 85, 85, 85, 85, 85,
+    85, 85, 85, 108, 85, 85, 109, 10, 110, 10, 28, 23, 23, 23, 111, 23, 23, 23, 23, 23,
+    23, 23, 23, 23, 23, 112, 23, 23, 113, 23, 114, 115, 10, 116, 117, 118, 23, 23, 23, 119,
+    120, 2, 121, 122, 123, 10, 10, 124,
+};
+
+static const uint8_t _utf8_ucd_stage2[4000] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 11, 0, 0, 0, 8, 0, 0, 0,
+    0, 0, 0, 0, 0, 5, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0,
+    0, 0, 0, 0, 0, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 0, 0, 0, 0, 4, 0, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 0, 0, 0, 0, 1, 11, 0, 8, 8, 8, 8, 0, 0, 0, 0, 28, 7,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 6, 0, 0, 0, 0,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 0, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 29, 28, 28, 29, 28, 28, 29, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 29, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 28, 28, 28, 28, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    22, 22, 22, 22, 0, 22, 22, 22, 0, 0, 22, 22, 22, 22, 0, 22, 0, 0, 0, 0,
+    22, 0, 22, 0, 22, 22, 22, 0, 22, 0, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 0, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 8, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 5, 0, 12, 12, 12, 12, 12, 0, 12, 12, 12, 12, 12, 14, 0, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 12, 12, 12, 0, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 12, 12, 12, 12, 12, 0, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 12, 12, 12, 12, 12, 12, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 0, 12, 12, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 0, 0, 0, 0, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 19, 19, 19, 0, 0, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 15, 15, 15, 15, 0, 15, 15, 15,
+    15, 15, 15, 15, 15, 0, 0, 15, 15, 0, 0, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 0, 15, 15, 15, 15, 15, 15,
+    15, 0, 15, 0, 0, 0, 15, 15, 15, 15, 0, 0, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 0, 0, 15, 15, 0, 0, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0, 15,
+    0, 0, 0, 0, 15, 15, 0, 15, 15, 15, 15, 15, 0, 0, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 15, 15, 17, 17, 15, 15, 15, 15, 15, 15, 15, 17, 15, 15, 15, 0,
+    0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 0, 0, 0, 0, 8,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 31, 31, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0,
+    0, 0, 0, 0, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 0, 21, 0, 0, 0, 0, 0, 21, 0, 0, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 0, 21, 21, 21, 21,
+    5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3,
+    3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18,
+    18, 0, 0, 0, 0, 0, 0, 0, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 0, 0, 21, 21, 21, 28, 28, 28, 28,
+    28, 28, 22, 22, 22, 22, 22, 18, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 22, 22, 22,
+    22, 22, 28, 28, 28, 28, 22, 22, 22, 22, 22, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 18, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 0, 0, 22, 22, 22, 22, 22, 22, 0, 0, 22, 22, 22, 22,
+    22, 22, 0, 0, 22, 22, 22, 22, 22, 22, 0, 0, 22, 22, 22, 22, 22, 22, 22, 22,
+    0, 22, 0, 22, 0, 22, 0, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 0, 0,
+    22, 22, 22, 22, 22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 23, 23, 22, 22, 22, 22,
+    22, 22, 22, 22, 23, 23, 23, 23, 23, 23, 23, 23, 22, 22, 22, 22, 22, 22, 22, 22,
+    23, 23, 23, 23, 23, 23, 23, 23, 22, 22, 22, 22, 22, 0, 22, 22, 22, 22, 22, 22,
+    23, 22, 22, 22, 22, 22, 22, 22, 22, 0, 22, 22, 22, 22, 22, 22, 23, 22, 22, 22,
+    22, 22, 22, 22, 0, 0, 22, 22, 22, 22, 22, 22, 0, 22, 22, 22, 22, 22, 22, 22,
+    22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 22, 0, 0, 22, 22, 22, 0, 22, 22,
+    22, 22, 22, 22, 23, 22, 22, 0, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 0,
+    0, 0, 0, 0, 5, 5, 5, 5, 5, 5, 0, 0, 7, 6, 0, 7, 7, 6, 0, 7,
+    0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 7, 6, 0, 0, 0, 0, 4, 4, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8,
+    8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 22, 0,
+    0, 0, 28, 28, 0, 0, 0, 0, 0, 0, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 30, 30, 30,
+    30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30,
+    30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 28, 28, 30, 30, 30, 30, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    21, 21, 21, 21, 21, 21, 0, 21, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 6, 7, 6, 0, 0,
+    0, 7, 6, 0, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 5, 0,
+    7, 6, 0, 0, 7, 6, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 5, 0, 0, 0, 0, 5, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 5, 0, 0, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 0, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0,
+    0, 24, 0, 25, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 5, 0, 0, 0, 0, 25, 25, 25, 25, 25, 25, 25, 25, 25, 0, 0,
+    0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 25, 25, 25, 24, 0, 0, 0, 0,
+    0, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 26, 26, 26, 26, 0, 0, 0, 0, 0, 0, 26, 26, 26, 5, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 0, 0, 27, 27, 27, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 0, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    0, 0, 0, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 0, 0, 0, 0, 0,
+    28, 28, 0, 28, 0, 28, 28, 28, 28, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 0,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 22, 28, 28, 28, 28, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 0, 0, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 0, 0, 0, 0, 0, 0,
+    28, 28, 28, 28, 28, 28, 28, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 12, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 0, 0,
+    0, 0, 0, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 14, 12, 12, 12, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 18, 18, 0, 5, 5, 4, 4, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4,
+    0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5,
+    0, 0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 12, 12, 12, 12, 12, 0, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 0,
+    0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 28, 28, 28, 28, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    0, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    27, 27, 27, 27, 27, 27, 0, 0, 8, 8, 0, 0, 0, 8, 8, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   
+};
+
+static uint32_t _utf8_groupmask(uint32_t c) {
+    if (c >= 0x10000) return 0;
+    const unsigned block = _utf8_ucd_stage1[c >> _utf8_UCD_SHIFT];
+    return _utf8_ucd_masks[_utf8_ucd_stage2[(block << _utf8_UCD_SHIFT) | (c & ((1U << _utf8_UCD_SHIFT) - 1))]];
+}
+
+static bool utf8_isgroup(int group, uint32_t c)
+    { return (_utf8_groupmask(c) >> group) & 1; }
+
+#define _utf8_ALPHA_MASK (1U<<U8G_Latin | 1U<<U8G_Nl | 1U<<U8G_Cyrillic | 1U<<U8G_Han | 1U<<U8G_Devanagari | \
+                          1U<<U8G_Arabic | 1U<<U8G_Bengali | 1U<<U8G_Hiragana | 1U<<U8G_Katakana | \
+                          1U<<U8G_Thai | 1U<<U8G_Greek | 1U<<U8G_Georgian)
 
 static bool utf8_isalpha(uint32_t c) {
-    static int16_t groups[] = {U8G_Latin, U8G_Nl, U8G_Cyrillic, U8G_Han, U8G_Devanagari,
-                               U8G_Arabic, U8G_Bengali, U8G_Hiragana, U8G_Katakana,
-                               U8G_Thai, U8G_Greek, U8G_Georgian};
     if (c < 128) return isalpha((int)c) != 0;
-    for (int j=0; j < (int)(sizeof groups/sizeof groups[0]); ++j)
-        if (utf8_isgroup(groups[j], c))
-            return true;
-    return false;
+    return (_utf8_groupmask(c) & _utf8_ALPHA_MASK) != 0;
 }
 
 static bool utf8_iscased(uint32_t c) {
@@ -62,13 +390,12 @@ static bool utf8_iscased(uint32_t c) {
 
 static bool utf8_isalnum(uint32_t c) {
     if (c < 128) return isalnum((int)c) != 0;
-    return utf8_isalpha(c) || utf8_isgroup(U8G_Nd, c);
+    return (_utf8_groupmask(c) & (_utf8_ALPHA_MASK | 1U<<U8G_Nd)) != 0;
 }
 
 static bool utf8_isword(uint32_t c) {
     if (c < 128) return (isalnum((int)c) != 0) | (c == '_');
-    return utf8_isalpha(c) || utf8_isgroup(U8G_Nd, c) ||
-           utf8_isgroup(U8G_Pc, c);
+    return (_utf8_groupmask(c) & (_utf8_ALPHA_MASK | 1U<<U8G_Nd | 1U<<U8G_Pc)) != 0;
 }
 
 static bool utf8_isblank(uint32_t c) {
@@ -81,402 +408,4 @@ static bool utf8_isspace(uint32_t c) {
     return ((c == 8232) | (c == 8233)) || utf8_isgroup(U8G_Zs, c);
 }
 
-/* The tables below are extracted from the RE2 library */
-typedef struct {
-  uint16_t lo;
-  uint16_t hi;
-} URange16;
-
-static const URange16 Cc_range16[] = { // Control
-    { 0, 31 },
-    { 127, 159 },
-};
-
-static const URange16 Lt_range16[] = { // Title case
-    { 453, 453 },
-    { 456, 456 },
-    { 459, 459 },
-    { 498, 498 },
-    { 8072, 8079 },
-    { 8088, 8095 },
-    { 8104, 8111 },
-    { 8124, 8124 },
-    { 8140, 8140 },
-    { 8188, 8188 },
-};
-
-static const URange16 Nd_range16[] = { // Decimal number
-    { 48, 57 },
-    { 1632, 1641 },
-    { 1776, 1785 },
-    { 1984, 1993 },
-    { 2406, 2415 },
-    { 2534, 2543 },
-    { 2662, 2671 },
-    { 2790, 2799 },
-    { 2918, 2927 },
-    { 3046, 3055 },
-    { 3174, 3183 },
-    { 3302, 3311 },
-    { 3430, 3439 },
-    { 3558, 3567 },
-    { 3664, 3673 },
-    { 3792, 3801 },
-    { 3872, 3881 },
-    { 4160, 4169 },
-    { 4240, 4249 },
-    { 6112, 6121 },
-    { 6160, 6169 },
-    { 6470, 6479 },
-    { 6608, 6617 },
-    { 6784, 6793 },
-    { 6800, 6809 },
-    { 6992, 7001 },
-    { 7088, 7097 },
-    { 7232, 7241 },
-    { 7248, 7257 },
-    { 42528, 42537 },
-    { 43216, 43225 },
-    { 43264, 43273 },
-    { 43472, 43481 },
-    { 43504, 43513 },
-    { 43600, 43609 },
-    { 44016, 44025 },
-    { 65296, 65305 },
-};
-
-static const URange16 Nl_range16[] = { // Number letter
-    { 5870, 5872 },
-    { 8544, 8578 },
-    { 8581, 8584 },
-    { 12295, 12295 },
-    { 12321, 12329 },
-    { 12344, 12346 },
-    { 42726, 42735 },
-};
-
-static const URange16 Pc_range16[] = { // Connector punctuation
-    { 95, 95 },
-    { 8255, 8256 },
-    { 8276, 8276 },
-    { 65075, 65076 },
-    { 65101, 65103 },
-    { 65343, 65343 },
-};
-
-static const URange16 Pd_range16[] = { // Dash punctuation
-    { 45, 45 },
-    { 1418, 1418 },
-    { 1470, 1470 },
-    { 5120, 5120 },
-    { 6150, 6150 },
-    { 8208, 8213 },
-    { 11799, 11799 },
-    { 11802, 11802 },
-    { 11834, 11835 },
-    { 11840, 11840 },
-    { 11869, 11869 },
-    { 12316, 12316 },
-    { 12336, 12336 },
-    { 12448, 12448 },
-    { 65073, 65074 },
-    { 65112, 65112 },
-    { 65123, 65123 },
-    { 65293, 65293 },
-};
-
-static const URange16 Pf_range16[] = { // Final punctuation
-    { 187, 187 },
-    { 8217, 8217 },
-    { 8221, 8221 },
-    { 8250, 8250 },
-    { 11779, 11779 },
-    { 11781, 11781 },
-    { 11786, 11786 },
-    { 11789, 11789 },
-    { 11805, 11805 },
-    { 11809, 11809 },
-};
-
-static const URange16 Pi_range16[] = { // Initial punctuation
-    { 171, 171 },
-    { 8216, 8216 },
-    { 8219, 8220 },
-    { 8223, 8223 },
-    { 8249, 8249 },
-    { 11778, 11778 },
-    { 11780, 11780 },
-    { 11785, 11785 },
-    { 11788, 11788 },
-    { 11804, 11804 },
-    { 11808, 11808 },
-};
-
-static const URange16 Sc_range16[] = { // Currency symbol
-    { 36, 36 },
-    { 162, 165 },
-    { 1423, 1423 },
-    { 1547, 1547 },
-    { 2046, 2047 },
-    { 2546, 2547 },
-    { 2555, 2555 },
-    { 2801, 2801 },
-    { 3065, 3065 },
-    { 3647, 3647 },
-    { 6107, 6107 },
-    { 8352, 8384 },
-    { 43064, 43064 },
-    { 65020, 65020 },
-    { 65129, 65129 },
-    { 65284, 65284 },
-    { 65504, 65505 },
-    { 65509, 65510 },
-};
-
-static const URange16 Zl_range16[] = { // Line separator
-    { 8232, 8232 },
-};
-
-static const URange16 Zp_range16[] = { // Paragraph separator
-    { 8233, 8233 },
-};
-
-static const URange16 Zs_range16[] = { // Space separator
-    { 32, 32 },
-    { 160, 160 },
-    { 5760, 5760 },
-    { 8192, 8202 },
-    { 8239, 8239 },
-    { 8287, 8287 },
-    { 12288, 12288 },
-};
-
-static const URange16 Arabic_range16[] = {
-    { 1536, 1540 },
-    { 1542, 1547 },
-    { 1549, 1562 },
-    { 1564, 1566 },
-    { 1568, 1599 },
-    { 1601, 1610 },
-    { 1622, 1647 },
-    { 1649, 1756 },
-    { 1758, 1791 },
-    { 1872, 1919 },
-    { 2160, 2190 },
-    { 2192, 2193 },
-    { 2200, 2273 },
-    { 2275, 2303 },
-    { 64336, 64450 },
-    { 64467, 64829 },
-    { 64832, 64911 },
-    { 64914, 64967 },
-    { 64975, 64975 },
-    { 65008, 65023 },
-    { 65136, 65140 },
-    { 65142, 65276 },
-};
-
-static const URange16 Bengali_range16[] = {
-    { 2432, 2435 },
-    { 2437, 2444 },
-    { 2447, 2448 },
-    { 2451, 2472 },
-    { 2474, 2480 },
-    { 2482, 2482 },
-    { 2486, 2489 },
-    { 2492, 2500 },
-    { 2503, 2504 },
-    { 2507, 2510 },
-    { 2519, 2519 },
-    { 2524, 2525 },
-    { 2527, 2531 },
-    { 2534, 2558 },
-};
-
-static const URange16 Cyrillic_range16[] = {
-    { 1024, 1156 },
-    { 1159, 1327 },
-    { 7296, 7304 },
-    { 7467, 7467 },
-    { 7544, 7544 },
-    { 11744, 11775 },
-    { 42560, 42655 },
-    { 65070, 65071 },
-};
-
-static const URange16 Devanagari_range16[] = {
-    { 2304, 2384 },
-    { 2389, 2403 },
-    { 2406, 2431 },
-    { 43232, 43263 },
-};
-
-static const URange16 Georgian_range16[] = {
-    { 4256, 4293 },
-    { 4295, 4295 },
-    { 4301, 4301 },
-    { 4304, 4346 },
-    { 4348, 4351 },
-    { 7312, 7354 },
-    { 7357, 7359 },
-    { 11520, 11557 },
-    { 11559, 11559 },
-    { 11565, 11565 },
-};
-
-static const URange16 Greek_range16[] = {
-    { 880, 883 },
-    { 885, 887 },
-    { 890, 893 },
-    { 895, 895 },
-    { 900, 900 },
-    { 902, 902 },
-    { 904, 906 },
-    { 908, 908 },
-    { 910, 929 },
-    { 931, 993 },
-    { 1008, 1023 },
-    { 7462, 7466 },
-    { 7517, 7521 },
-    { 7526, 7530 },
-    { 7615, 7615 },
-    { 7936, 7957 },
-    { 7960, 7965 },
-    { 7968, 8005 },
-    { 8008, 8013 },
-    { 8016, 8023 },
-    { 8025, 8025 },
-    { 8027, 8027 },
-    { 8029, 8029 },
-    { 8031, 8061 },
-    { 8064, 8116 },
-    { 8118, 8132 },
-    { 8134, 8147 },
-    { 8150, 8155 },
-    { 8157, 8175 },
-    { 8178, 8180 },
-    { 8182, 8190 },
-    { 8486, 8486 },
-    { 43877, 43877 },
-};
-
-static const URange16 Han_range16[] = {
-    { 11904, 11929 },
-    { 11931, 12019 },
-    { 12032, 12245 },
-    { 12293, 12293 },
-    { 12295, 12295 },
-    { 12321, 12329 },
-    { 12344, 12347 },
-    { 13312, 19903 },
-    { 19968, 40959 },
-    { 63744, 64109 },
-    { 64112, 64217 },
-};
-
-static const URange16 Hiragana_range16[] = {
-	{ 12353, 12438 },
-	{ 12445, 12447 },
-};
-
-static const URange16 Katakana_range16[] = {
-	{ 12449, 12538 },
-	{ 12541, 12543 },
-	{ 12784, 12799 },
-	{ 13008, 13054 },
-	{ 13056, 13143 },
-	{ 65382, 65391 },
-	{ 65393, 65437 },
-};
-
-static const URange16 Latin_range16[] = {
-    { 65, 90 },
-    { 97, 122 },
-    { 170, 170 },
-    { 186, 186 },
-    { 192, 214 },
-    { 216, 246 },
-    { 248, 696 },
-    { 736, 740 },
-    { 7424, 7461 },
-    { 7468, 7516 },
-    { 7522, 7525 },
-    { 7531, 7543 },
-    { 7545, 7614 },
-    { 7680, 7935 },
-    { 8305, 8305 },
-    { 8319, 8319 },
-    { 8336, 8348 },
-    { 8490, 8491 },
-    { 8498, 8498 },
-    { 8526, 8526 },
-    { 8544, 8584 },
-    { 11360, 11391 },
-    { 42786, 42887 },
-    { 42891, 42954 },
-    { 42960, 42961 },
-    { 42963, 42963 },
-    { 42965, 42969 },
-    { 42994, 43007 },
-    { 43824, 43866 },
-    { 43868, 43876 },
-    { 43878, 43881 },
-    { 64256, 64262 },
-    { 65313, 65338 },
-    { 65345, 65370 },
-};
-
-static const URange16 Thai_range16[] = {
-    { 3585, 3642 },
-    { 3648, 3675 },
-};
-
-#ifdef __cplusplus
-    #define _e_arg(k, v) v
-#else
-    #define _e_arg(k, v) [k] = v
-#endif
-#define UNI_ENTRY(Code) { Code##_range16, sizeof(Code##_range16)/sizeof(URange16) }
-
-typedef struct {
-  const URange16 *r16;
-  int nr16;
-} UGroup;
-
-static const UGroup _utf8_unicode_groups[U8G_SIZE] = {
-    _e_arg(U8G_Cc, UNI_ENTRY(Cc)),
-    _e_arg(U8G_Lt, UNI_ENTRY(Lt)),
-    _e_arg(U8G_Nd, UNI_ENTRY(Nd)),
-    _e_arg(U8G_Nl, UNI_ENTRY(Nl)),
-    _e_arg(U8G_Pc, UNI_ENTRY(Pc)),
-    _e_arg(U8G_Pd, UNI_ENTRY(Pd)),
-    _e_arg(U8G_Pf, UNI_ENTRY(Pf)),
-    _e_arg(U8G_Pi, UNI_ENTRY(Pi)),
-    _e_arg(U8G_Sc, UNI_ENTRY(Sc)),
-    _e_arg(U8G_Zl, UNI_ENTRY(Zl)),
-    _e_arg(U8G_Zp, UNI_ENTRY(Zp)),
-    _e_arg(U8G_Zs, UNI_ENTRY(Zs)),
-    _e_arg(U8G_Arabic, UNI_ENTRY(Arabic)),
-    _e_arg(U8G_Bengali, UNI_ENTRY(Bengali)),
-    _e_arg(U8G_Cyrillic, UNI_ENTRY(Cyrillic)),
-    _e_arg(U8G_Devanagari, UNI_ENTRY(Devanagari)),
-    _e_arg(U8G_Georgian, UNI_ENTRY(Georgian)),
-    _e_arg(U8G_Greek, UNI_ENTRY(Greek)),
-    _e_arg(U8G_Han, UNI_ENTRY(Han)),
-    _e_arg(U8G_Hiragana, UNI_ENTRY(Hiragana)),
-    _e_arg(U8G_Katakana, UNI_ENTRY(Katakana)),
-    _e_arg(U8G_Latin, UNI_ENTRY(Latin)),
-    _e_arg(U8G_Thai, UNI_ENTRY(Thai)),
-};
-
-static bool utf8_isgroup(int group, uint32_t c) {
-    for (int j=0; j<_utf8_unicode_groups[group].nr16; ++j) {
-        if (c < _utf8_unicode_groups[group].r16[j].lo)
-            return false;
-        if (c <= _utf8_unicode_groups[group].r16[j].hi)
-            return true;
-    }
-    return false;
-}
-
 #endif // STC_UCD_PRV_C_INCLUDED
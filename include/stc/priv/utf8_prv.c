@@ -69,63 +69,378 @@ int utf8_encode(char *out, uint32_t c) {
 uint32_t utf8_peek_at(const char* s, isize offset)
     { return utf8_peek(utf8_offset(s, offset)); }
 
-bool utf8_valid_n(const char* s, isize nbytes) {
-    utf8_decode_t d = {.state=0};
-    while ((nbytes-- != 0) & (*s != 0))
-        utf8_decode(&d, (uint8_t)*s++);
-    return d.state == 0;
+/* ------------------------ counting and offsets ------------------------
+ * Lead (non-continuation) bytes are counted with the baseline vector instruction set
+ * (SSE2/NEON). On x86-64, the AVX2 version is selected at runtime when the CPU has it.
+ */
+#if defined __x86_64__ && defined __GNUC__ && !defined __TINYC__
+  #include <immintrin.h>
+  #define _utf8_X86
+  #define _utf8_TARGET(t) __attribute__((target(t)))
+#elif defined __aarch64__ && defined __ARM_NEON
+  #include <arm_neon.h>
+  #define _utf8_NEON
+#endif
+
+#if defined __SSE2__ && defined __GNUC__
+  #include <emmintrin.h>
+  #define _utf8_VBYTES 16
+  #define _utf8_LEADMASK(p) (unsigned)_mm_movemask_epi8( \
+        _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(p)), _mm_set1_epi8(-65)))
+#elif defined _utf8_NEON
+  #define _utf8_VBYTES 16
+#endif
+
+#if defined _utf8_X86
+_utf8_TARGET("avx2")
+static isize _utf8_count_leads_avx2(const char* s, isize n) {
+    isize count = 0, i = 0;
+    for (; n - i >= 32; ) { // count bytes > -65, summed with sad_epu8 before the byte counters overflow
+        const isize end = i + (n - i < 32*255 ? (n - i) & ~(isize)31 : 32*255);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i < end; i += 32)
+            acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(s + i)),
+                                                         _mm256_set1_epi8(-65)));
+        acc = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        count += (isize)(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1)
+                       + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+    }
+    return count + _utf8_count_leads_scalar(s + i, n - i);
 }
+#endif
 
-uint32_t utf8_casefold(uint32_t c) {
-    for (int i=0; i < casefold_len; ++i) {
-        const struct CaseMapping entry = casemappings[i];
-        if (c <= entry.c2) {
-            if (c < entry.c1) return c;
-            int d = entry.m2 - entry.c2;
-            if (d == 1) return c + ((entry.c2 & 1U) == (c & 1U));
-            return (uint32_t)((int)c + d);
+isize _utf8_count_leads(const char* s, isize n) {
+    isize count = 0, i = 0;
+  #if defined _utf8_X86
+    if (n >= 64 && __builtin_cpu_supports("avx2"))
+        return _utf8_count_leads_avx2(s, n);
+  #endif
+  #if defined __SSE2__ && defined __GNUC__
+    for (; n - i >= 16; ) {
+        const isize end = i + (n - i < 16*255 ? (n - i) & ~(isize)15 : 16*255);
+        __m128i acc = _mm_setzero_si128();
+        for (; i < end; i += 16)
+            acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(s + i)),
+                                                   _mm_set1_epi8(-65)));
+        acc = _mm_sad_epu8(acc, _mm_setzero_si128());
+        count += _mm_cvtsi128_si32(acc) + _mm_extract_epi16(acc, 4);
+    }
+  #elif defined _utf8_VBYTES
+    for (; n - i >= 16; ) {
+        const isize end = i + (n - i < 16*255 ? (n - i) & ~(isize)15 : 16*255);
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (; i < end; i += 16)
+            acc = vsubq_u8(acc, vcgtq_s8(vld1q_s8((const int8_t*)(s + i)), vdupq_n_s8(-65)));
+        count += vaddlvq_u8(acc);
+    }
+  #endif
+    return count + _utf8_count_leads_scalar(s + i, n - i);
+}
+
+const char* _utf8_at(const char *s, isize u8pos) {
+  #if defined _utf8_VBYTES
+    while ((u8pos > _utf8_VBYTES) & (*s != 0)) { // skip vectors holding fewer than u8pos lead bytes, 256 bytes at a time
+        const char* z = (const char*)memchr(s + 1, 0, 256);
+        const isize n = z ? z - (s + 1) : 256;
+        isize i = 0;
+        for (; n - i >= _utf8_VBYTES; i += _utf8_VBYTES) {
+          #if defined _utf8_LEADMASK
+            const isize k = __builtin_popcount(_utf8_LEADMASK(s + 1 + i));
+          #else
+            const isize k = vaddvq_u8(vandq_u8(vcgtq_s8(vld1q_s8((const int8_t*)(s + 1 + i)),
+                                                         vdupq_n_s8(-65)), vdupq_n_u8(1)));
+          #endif
+            if (k >= u8pos) break;
+            u8pos -= k;
         }
+        s += i;
+        if (z || i < 256) break;
+    }
+  #endif
+    return _utf8_at_scalar(s, u8pos);
+}
+
+/* ---------------------------- ASCII fast paths ----------------------------
+ * Case mapping and case-insensitive comparison of ASCII blocks. Blocks of 16 bytes are
+ * handled with SSE2, then 8 bytes as 64-bit words: bytes < 0x80 added to < 0x80 do not carry
+ * into the next byte. The last bytes are done as an overlapping word.
+ */
+#define _utf8_ONES UINT64_C(0x0101010101010101)
+#define _utf8_ASCII_ALPHA(w, lo, hi) /* 0x80 in the bytes of w in [lo, hi] */ \
+    (((w) + _utf8_ONES*(0x80 - (lo))) & ~((w) + _utf8_ONES*(0x7F - (hi))) & _utf8_ONES*0x80)
+
+/* k: 0 = casefold, 1 = tolower, 2 = toupper. false if a byte is not ASCII */
+STC_INLINE bool _utf8_ascii_tocase8(char* out, const char* s, int k) {
+    uint64_t w; c_memcpy(&w, s, 8);
+    if (w & _utf8_ONES*0x80) return false;
+    w ^= (k < 2 ? _utf8_ASCII_ALPHA(w, 'A', 'Z') : _utf8_ASCII_ALPHA(w, 'a', 'z')) >> 2;
+    c_memcpy(out, &w, 8);
+    return true;
+}
+
+/* true if a and b are ASCII, equal after case folding, and b has no zero byte */
+STC_INLINE bool _utf8_ascii_iequal8(const char* a, const char* b) {
+    uint64_t x, y; c_memcpy(&x, a, 8); c_memcpy(&y, b, 8);
+    if ((x | y) & _utf8_ONES*0x80 || (y - _utf8_ONES) & ~y & _utf8_ONES*0x80) return false;
+    return (x | _utf8_ASCII_ALPHA(x, 'A', 'Z') >> 2) == (y | _utf8_ASCII_ALPHA(y, 'A', 'Z') >> 2);
+}
+
+/* number of bytes mapped from s[0, n) to out; stops at a block with a non-ASCII byte */
+isize _utf8_ascii_tocase(char* out, const char* s, isize n, int k) {
+    isize i = 0;
+  #if defined __SSE2__ && defined __GNUC__
+    const __m128i lo = _mm_set1_epi8(k < 2 ? 'A' - 1 : 'a' - 1), hi = _mm_set1_epi8(k < 2 ? 'Z' + 1 : 'z' + 1);
+    for (; n - i >= 16; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        if (_mm_movemask_epi8(v)) return i;
+        const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(v, _mm_and_si128(alpha, _mm_set1_epi8(0x20))));
     }
-    return c;
+  #endif
+    for (; n - i >= 8; i += 8)
+        if (!_utf8_ascii_tocase8(out + i, s + i, k)) return i;
+    return i != n && n >= 8 && _utf8_ascii_tocase8(out + n - 8, s + n - 8, k) ? n : i;
 }
 
-uint32_t utf8_tolower(uint32_t c) {
-    for (int i=0; i < (int)(sizeof upcase_ind/sizeof *upcase_ind); ++i) {
-        const struct CaseMapping entry = casemappings[upcase_ind[i]];
-        if (c <= entry.c2) {
-            if (c < entry.c1) return c;
-            int d = entry.m2 - entry.c2;
-            if (d == 1) return c + ((entry.c2 & 1U) == (c & 1U));
-            return (uint32_t)((int)c + d);
+/* number of bytes of a[0, n) and b[0, n) skipped as equal ASCII, stopping at a mismatching block */
+STC_INLINE isize _utf8_ascii_iequal(const char* a, const char* b, isize n) {
+    isize i = 0;
+  #if defined __SSE2__ && defined __GNUC__
+    const __m128i lo = _mm_set1_epi8('A' - 1), hi = _mm_set1_epi8('Z' + 1), bit = _mm_set1_epi8(0x20);
+    for (; n - i >= 16; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(a + i)), y = _mm_loadu_si128((const __m128i*)(b + i));
+        const __m128i fx = _mm_or_si128(x, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(x, lo), _mm_cmplt_epi8(x, hi)), bit));
+        const __m128i fy = _mm_or_si128(y, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(y, lo), _mm_cmplt_epi8(y, hi)), bit));
+        const __m128i eq = _mm_andnot_si128(_mm_cmpeq_epi8(y, _mm_setzero_si128()), _mm_cmpeq_epi8(fx, fy));
+        if (_mm_movemask_epi8(_mm_or_si128(x, y)) | (_mm_movemask_epi8(eq) ^ 0xFFFF)) return i;
+    }
+  #endif
+    for (; n - i >= 8; i += 8)
+        if (!_utf8_ascii_iequal8(a + i, b + i)) return i;
+    return i != n && n >= 8 && _utf8_ascii_iequal8(a + n - 8, b + n - 8) ? n : i;
+}
+
+/* number of utf8 lead bytes in the 8 bytes at s */
+STC_INLINE int _utf8_leads8(const char* s) {
+    uint64_t w; c_memcpy(&w, s, 8);
+    w = (w & ~(w << 1) & 0x8080808080808080) >> 7; // continuation bytes: 10xxxxxx
+    return 8 - (int)((w * 0x0101010101010101) >> 56);
+}
+
+utf8_index utf8_index_from(csview sv) {
+    utf8_index ix = {0};
+    ix.u8size = _utf8_count_leads(sv.buf, sv.size);
+    ix.size = ((ix.u8size - 1) >> _utf8_INDEX_SHIFT) + 1;
+    ix.offset = (isize*)c_malloc(c_sizeof(isize)*(ix.size + 1));
+    isize count = 0, n = 0, i = 0;
+    while (n < ix.size) {
+        // skip 8 bytes at a time while the word has no rune number divisible by the step
+        for (; sv.size - i >= 8; i += 8) {
+            const isize k = count & (_utf8_INDEX_STEP - 1), leads = _utf8_leads8(sv.buf + i);
+            if ((k == 0 && leads) || k + leads > _utf8_INDEX_STEP) break;
+            count += leads;
+        }
+        for (const isize end = sv.size - i >= 8 ? i + 8 : sv.size; i < end; ++i) {
+            if ((sv.buf[i] & 0xC0) == 0x80) continue;
+            if ((count++ & (_utf8_INDEX_STEP - 1)) == 0)
+                ix.offset[n++] = i;
         }
     }
-    return c;
+    ix.offset[ix.size] = sv.size; // sentinel
+    return ix;
 }
 
-uint32_t utf8_toupper(uint32_t c) {
-    for (int i=0; i < (int)(sizeof lowcase_ind/sizeof *lowcase_ind); ++i) {
-        const struct CaseMapping entry = casemappings[lowcase_ind[i]];
-        if (c <= entry.m2) {
-            int d = entry.m2 - entry.c2;
-            if (c < (uint32_t)(entry.c1 + d)) return c;
-            if (d == 1) return c - ((entry.m2 & 1U) == (c & 1U));
-            return (uint32_t)((int)c - d);
+void utf8_index_drop(utf8_index* self)
+    { c_free(self->offset, c_sizeof(isize)*(self->size + 1)); }
+
+const char* utf8_index_at(const utf8_index* self, const char* s, isize u8pos) {
+    if (u8pos >= self->u8size)
+        return s + self->offset[self->size];
+    if (u8pos <= 0)
+        return s;
+    const isize k = u8pos >> _utf8_INDEX_SHIFT, end = self->offset[k + 1];
+    isize i = self->offset[k] + 1;
+    u8pos &= _utf8_INDEX_STEP - 1;
+    for (int leads; end - i >= 8 && (leads = _utf8_leads8(s + i)) < u8pos; i += 8)
+        u8pos -= leads;
+    for (--i; u8pos > 0; )
+        u8pos -= (s[++i] & 0xC0) != 0x80;
+    return s + i;
+}
+
+/* ---------------------------- SIMD validation ----------------------------
+ * Validation uses the lookup algorithm by Keiser & Lemire: "Validating UTF-8 In Less
+ * Than One Instruction Per Byte" (2021). On x86-64 the AVX2 or SSSE3 version is selected
+ * at runtime. The byte-at-a-time DFA is the fallback.
+ */
+
+#if defined _utf8_X86 || defined _utf8_NEON
+enum {
+    _u8_TOO_SHORT = 1<<0, _u8_TOO_LONG = 1<<1, _u8_OVERLONG_3 = 1<<2, _u8_TOO_LARGE = 1<<3,
+    _u8_SURROGATE = 1<<4, _u8_OVERLONG_2 = 1<<5, _u8_TOO_LARGE_1000 = 1<<6, _u8_OVERLONG_4 = 1<<6,
+    _u8_TWO_CONTS = 1<<7, _u8_CARRY = _u8_TOO_SHORT | _u8_TOO_LONG | _u8_TWO_CONTS,
+    _u8_LARGE = _u8_CARRY | _u8_TOO_LARGE | _u8_TOO_LARGE_1000,
+    _u8_CONT_HI = _u8_TOO_LONG | _u8_OVERLONG_2 | _u8_TWO_CONTS,
+};
+
+/* error flags by: high nibble of first byte, low nibble of first byte, high nibble of second byte */
+static const uint8_t _utf8_vtab[3][16] = {
+    {_u8_TOO_LONG, _u8_TOO_LONG, _u8_TOO_LONG, _u8_TOO_LONG,
+     _u8_TOO_LONG, _u8_TOO_LONG, _u8_TOO_LONG, _u8_TOO_LONG,
+     _u8_TWO_CONTS, _u8_TWO_CONTS, _u8_TWO_CONTS, _u8_TWO_CONTS,
+     _u8_TOO_SHORT | _u8_OVERLONG_2, _u8_TOO_SHORT, _u8_TOO_SHORT | _u8_OVERLONG_3 | _u8_SURROGATE,
+     _u8_TOO_SHORT | _u8_TOO_LARGE | _u8_TOO_LARGE_1000 | _u8_OVERLONG_4},
+    {_u8_CARRY | _u8_OVERLONG_3 | _u8_OVERLONG_2 | _u8_OVERLONG_4, _u8_CARRY | _u8_OVERLONG_2,
+     _u8_CARRY, _u8_CARRY, _u8_CARRY | _u8_TOO_LARGE, _u8_LARGE, _u8_LARGE, _u8_LARGE,
+     _u8_LARGE, _u8_LARGE, _u8_LARGE, _u8_LARGE, _u8_LARGE, _u8_LARGE | _u8_SURROGATE,
+     _u8_LARGE, _u8_LARGE},
+    {_u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT,
+     _u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT,
+     _u8_CONT_HI | _u8_OVERLONG_3 | _u8_TOO_LARGE_1000 | _u8_OVERLONG_4,
+     _u8_CONT_HI | _u8_OVERLONG_3 | _u8_TOO_LARGE,
+     _u8_CONT_HI | _u8_SURROGATE | _u8_TOO_LARGE, _u8_CONT_HI | _u8_SURROGATE | _u8_TOO_LARGE,
+     _u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT, _u8_TOO_SHORT},
+};
+
+/* bytes >= these at the end of a block start a sequence which continues in the next */
+static const uint8_t _utf8_vmax[32] = {
+    255,255,255,255,255,255,255,255, 255,255,255,255,255,255,255,255,
+    255,255,255,255,255,255,255,255, 255,255,255,255,255, 0xF0-1, 0xE0-1, 0xC0-1,
+};
+#endif
+
+#if defined _utf8_X86
+_utf8_TARGET("ssse3")
+static bool _utf8_valid_ssse3(const uint8_t* s, isize n) {
+    const __m128i t1 = _mm_loadu_si128((const __m128i*)_utf8_vtab[0]);
+    const __m128i t2 = _mm_loadu_si128((const __m128i*)_utf8_vtab[1]);
+    const __m128i t3 = _mm_loadu_si128((const __m128i*)_utf8_vtab[2]);
+    const __m128i nib = _mm_set1_epi8(0x0F), vmax = _mm_loadu_si128((const __m128i*)(_utf8_vmax + 16));
+    __m128i prev = _mm_setzero_si128(), err = prev, incomplete = prev, in;
+    uint8_t last[16] = {0};
+    for (isize i = 0; i < n; i += 16, prev = in) {
+        if (n - i >= 16) in = _mm_loadu_si128((const __m128i*)(s + i));
+        else { c_memcpy(last, s + i, n - i); in = _mm_loadu_si128((const __m128i*)last); }
+        if (_mm_movemask_epi8(in) == 0) {
+            err = _mm_or_si128(err, incomplete);
+            continue;
+        }
+        const __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+        const __m128i sc = _mm_and_si128(_mm_and_si128(
+            _mm_shuffle_epi8(t1, _mm_and_si128(_mm_srli_epi16(prev1, 4), nib)),
+            _mm_shuffle_epi8(t2, _mm_and_si128(prev1, nib))),
+            _mm_shuffle_epi8(t3, _mm_and_si128(_mm_srli_epi16(in, 4), nib)));
+        const __m128i must23 = _mm_or_si128(
+            _mm_subs_epu8(_mm_alignr_epi8(in, prev, 14), _mm_set1_epi8(0xE0 - 0x80)),
+            _mm_subs_epu8(_mm_alignr_epi8(in, prev, 13), _mm_set1_epi8(0xF0 - 0x80)));
+        err = _mm_or_si128(err, _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(-128)), sc));
+        incomplete = _mm_subs_epu8(in, vmax);
+    }
+    err = _mm_or_si128(err, incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) == 0xFFFF;
+}
+
+_utf8_TARGET("avx2")
+static bool _utf8_valid_avx2(const uint8_t* s, isize n) {
+    const __m256i t1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)_utf8_vtab[0]));
+    const __m256i t2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)_utf8_vtab[1]));
+    const __m256i t3 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)_utf8_vtab[2]));
+    const __m256i nib = _mm256_set1_epi8(0x0F), vmax = _mm256_loadu_si256((const __m256i*)_utf8_vmax);
+    __m256i prev = _mm256_setzero_si256(), err = prev, incomplete = prev, in;
+    uint8_t last[32] = {0};
+    for (isize i = 0; i < n; i += 32, prev = in) {
+        if (n - i >= 32) in = _mm256_loadu_si256((const __m256i*)(s + i));
+        else { c_memcpy(last, s + i, n - i); in = _mm256_loadu_si256((const __m256i*)last); }
+        if (_mm256_movemask_epi8(in) == 0) {
+            err = _mm256_or_si256(err, incomplete);
+            continue;
         }
+        const __m256i p = _mm256_permute2x128_si256(prev, in, 0x21);
+        const __m256i prev1 = _mm256_alignr_epi8(in, p, 15);
+        const __m256i sc = _mm256_and_si256(_mm256_and_si256(
+            _mm256_shuffle_epi8(t1, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nib)),
+            _mm256_shuffle_epi8(t2, _mm256_and_si256(prev1, nib))),
+            _mm256_shuffle_epi8(t3, _mm256_and_si256(_mm256_srli_epi16(in, 4), nib)));
+        const __m256i must23 = _mm256_or_si256(
+            _mm256_subs_epu8(_mm256_alignr_epi8(in, p, 14), _mm256_set1_epi8(0xE0 - 0x80)),
+            _mm256_subs_epu8(_mm256_alignr_epi8(in, p, 13), _mm256_set1_epi8(0xF0 - 0x80)));
+        err = _mm256_or_si256(err, _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(-128)), sc));
+        incomplete = _mm256_subs_epu8(in, vmax);
     }
-    return c;
+    err = _mm256_or_si256(err, incomplete);
+    return _mm256_testz_si256(err, err) != 0;
+}
+
+#elif defined _utf8_NEON
+static bool _utf8_valid_neon(const uint8_t* s, isize n) {
+    const uint8x16_t t1 = vld1q_u8(_utf8_vtab[0]), t2 = vld1q_u8(_utf8_vtab[1]), t3 = vld1q_u8(_utf8_vtab[2]);
+    const uint8x16_t nib = vdupq_n_u8(0x0F), vmax = vld1q_u8(_utf8_vmax + 16);
+    uint8x16_t prev = vdupq_n_u8(0), err = prev, incomplete = prev, in;
+    uint8_t last[16] = {0};
+    for (isize i = 0; i < n; i += 16, prev = in) {
+        if (n - i >= 16) in = vld1q_u8(s + i);
+        else { c_memcpy(last, s + i, n - i); in = vld1q_u8(last); }
+        if (vmaxvq_u8(in) < 0x80) {
+            err = vorrq_u8(err, incomplete);
+            continue;
+        }
+        const uint8x16_t prev1 = vextq_u8(prev, in, 15);
+        const uint8x16_t sc = vandq_u8(vandq_u8(vqtbl1q_u8(t1, vshrq_n_u8(prev1, 4)),
+                                                vqtbl1q_u8(t2, vandq_u8(prev1, nib))),
+                                       vqtbl1q_u8(t3, vshrq_n_u8(in, 4)));
+        const uint8x16_t must23 = vorrq_u8(vqsubq_u8(vextq_u8(prev, in, 14), vdupq_n_u8(0xE0 - 0x80)),
+                                           vqsubq_u8(vextq_u8(prev, in, 13), vdupq_n_u8(0xF0 - 0x80)));
+        err = vorrq_u8(err, veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), sc));
+        incomplete = vqsubq_u8(in, vmax);
+    }
+    return vmaxvq_u8(vorrq_u8(err, incomplete)) == 0;
+}
+
+#endif
+
+bool utf8_valid_n(const char* s, isize nbytes) {
+    const char* z = (const char*)memchr(s, 0, (size_t)nbytes);
+    if (z != NULL) nbytes = z - s;
+  #if defined _utf8_X86
+    if (__builtin_cpu_supports("avx2"))
+        return _utf8_valid_avx2((const uint8_t*)s, nbytes);
+    if (__builtin_cpu_supports("ssse3"))
+        return _utf8_valid_ssse3((const uint8_t*)s, nbytes);
+  #elif defined _utf8_NEON
+    return _utf8_valid_neon((const uint8_t*)s, nbytes);
+  #endif
+    utf8_decode_t d = {.state=0};
+    while (nbytes-- != 0)
+        utf8_decode(&d, (uint8_t)*s++);
+    return d.state == 0;
 }
 
 int utf8_icompare(const csview s1, const csview s2) {
     utf8_decode_t d1 = {.state=0}, d2 = {.state=0};
-    isize j1 = 0, j2 = 0;
+    isize j1 = 0, j2 = 0, next_block = 0;
+    const bool sized = (s1.size != INTPTR_MAX) & (s2.size != INTPTR_MAX); // utf8_icmp() has no sizes
     while ((j1 < s1.size) & (j2 < s2.size)) {
+        if (sized & (j2 >= next_block)) { // skip equal ASCII blocks, retry after a block
+            const isize r1 = s1.size - j1, r2 = s2.size - j2;
+            const isize n = _utf8_ascii_iequal(s1.buf + j1, s2.buf + j2, r1 < r2 ? r1 : r2);
+            j1 += n, j2 += n, next_block = j2 + 8;
+            if ((j1 == s1.size) | (j2 == s2.size)) break;
+        }
+        const uint32_t a = (uint8_t)s1.buf[j1], b = (uint8_t)s2.buf[j2];
+        if ((a | b) < 128) { // ASCII fast path
+            int32_t c = (int32_t)_utf8_tocase(a, 0) - (int32_t)_utf8_tocase(b, 0);
+            ++j1, ++j2;
+            if (c || !b)
+                return (int)c;
+            continue;
+        }
         do { utf8_decode(&d1, (uint8_t)s1.buf[j1++]); } while (d1.state);
         do { utf8_decode(&d2, (uint8_t)s2.buf[j2++]); } while (d2.state);
         int32_t c = (int32_t)utf8_casefold(d1.codep) - (int32_t)utf8_casefold(d2.codep);
         if (c || !s2.buf[j2 - 1]) // OK if s1.size and s2.size are npos
             return (int)c;
     }
-    return (int)(s1.size - s2.size);
+    return (j1 < s1.size) - (j2 < s2.size); // a proper prefix is less
 }
 
 #endif // STC_UTF8_PRV_C_INCLUDED
@@ -37,31 +37,61 @@ STC_INLINE int utf8_chr_size(const char *s) {
     /*return 0;*/
 }
 
-/* number of codepoints in the utf8 string s */
-STC_INLINE isize utf8_count(const char *s) {
-    isize size = 0;
-    while (*s)
-        size += (*++s & 0xC0) != 0x80;
-    return size;
-}
-
-STC_INLINE isize utf8_count_n(const char *s, isize nbytes) {
-    isize size = 0;
-    while ((nbytes-- != 0) & (*s != 0)) {
-        size += (*++s & 0xC0) != 0x80;
-    }
-    return size;
+/* number of lead (non-continuation) bytes in s[0, n) */
+STC_INLINE isize _utf8_count_leads_scalar(const char* s, isize n) {
+    isize count = 0;
+    for (isize i = 0; i < n; ++i)
+        count += (s[i] & 0xC0) != 0x80;
+    return count;
 }
 
-STC_INLINE const char* utf8_at(const char *s, isize u8pos) {
+STC_INLINE const char* _utf8_at_scalar(const char *s, isize u8pos) {
     while ((u8pos > 0) & (*s != 0))
         u8pos -= (*++s & 0xC0) != 0x80;
     return s;
 }
 
+// ------------------------------------------------------
+// The following requires linking with utf8 symbols.
+// To call them, either define i_import before including
+// one of cstr, csview, zsview, or link with src/libstc.o.
+
+extern bool     utf8_valid_n(const char* s, isize nbytes);
+extern int      utf8_encode(char *out, uint32_t c);
+extern int      utf8_icompare(const csview s1, const csview s2);
+extern uint32_t utf8_peek_at(const char* s, isize u8offset);
+extern isize    _utf8_count_leads(const char* s, isize n); // SIMD, AVX2 selected at runtime on x86-64
+extern const char* _utf8_at(const char *s, isize u8pos);   // SIMD
+extern isize    _utf8_ascii_tocase(char* out, const char* s, isize n, int k); // ASCII prefix of s mapped to out
+
+/* Counting and offsets use the SIMD versions above only when the utf8 symbols are linked
+ * anyway: with i_import, utf8.h with i_implement, or via cstr. Otherwise csview and zsview
+ * stay header-only with the scalar loops. */
+#if defined i_import || defined STC_CSTR_H_INCLUDED || (defined STC_UTF8_H_INCLUDED && defined i_implement)
+  #define _utf8_count_leads_x _utf8_count_leads
+  #define _utf8_at_x _utf8_at
+#else
+  #define _utf8_count_leads_x _utf8_count_leads_scalar
+  #define _utf8_at_x _utf8_at_scalar
+#endif
+
+/* number of codepoints in the utf8 string s */
+STC_INLINE isize utf8_count(const char *s)
+    { return _utf8_count_leads_x(s, c_strlen(s)); }
+
+/* number of codepoints starting in the first nbytes of s (stops at '\0') */
+STC_INLINE isize utf8_count_n(const char *s, isize nbytes) {
+    const char* z = (const char*)memchr(s, 0, (size_t)nbytes);
+    return _utf8_count_leads_x(s, z ? z - s : nbytes);
+}
+
+STC_INLINE const char* utf8_at(const char *s, isize u8pos)
+    { return _utf8_at_x(s, u8pos); }
+
 STC_INLINE const char* utf8_offset(const char* s, isize u8pos) {
     int inc = 1;
     if (u8pos < 0) u8pos = -u8pos, inc = -1;
+    else return utf8_at(s, u8pos);
     while (u8pos && *s)
         u8pos -= (*(s += inc) & 0xC0) != 0x80;
     return s;
@@ -76,19 +106,42 @@ STC_INLINE csview utf8_subview(const char *s, isize u8pos, isize u8len) {
     span.size = utf8_to_index(span.buf, u8len);
     return span;
 }
+#undef _utf8_count_leads_x
+#undef _utf8_at_x
+
+/* sampled codepoint index: byte offset of every _utf8_INDEX_STEP'th rune.
+ * Makes repeated u8pos lookups O(1) on large strings. Rebuild after the text is modified. */
+enum { _utf8_INDEX_SHIFT = 8, _utf8_INDEX_STEP = 1 << _utf8_INDEX_SHIFT };
+typedef struct { isize* offset; isize size, u8size; } utf8_index;
+
+extern utf8_index  utf8_index_from(csview sv);
+extern void        utf8_index_drop(utf8_index* self);
+extern const char* utf8_index_at(const utf8_index* self, const char* s, isize u8pos); // s must be the indexed buffer
+
+/* two-stage case mapping tables: {fold, lower, upper} offsets per BMP codepoint. utf8_tab.c */
+enum { _utf8_CASE_SHIFT = 6 }; // block size of utf8_casestage1, see src/utf8_tab.py
+extern const int32_t utf8_casedeltas[][3];
+extern const uint8_t utf8_casestage1[], utf8_casestage2[];
+
+/* k: 0 = casefold, 1 = tolower, 2 = toupper */
+STC_INLINE uint32_t _utf8_tocase(uint32_t c, int k) {
+    if (c < 128)
+        return k < 2 ? c + ((uint32_t)(c - 'A' < 26U) << 5) : c - ((uint32_t)(c - 'a' < 26U) << 5);
+    if (c >= 0x10000)
+        return c;
+    const unsigned block = utf8_casestage1[c >> _utf8_CASE_SHIFT];
+    const unsigned i = utf8_casestage2[(block << _utf8_CASE_SHIFT) | (c & ((1U << _utf8_CASE_SHIFT) - 1))];
+    return (uint32_t)((int32_t)c + utf8_casedeltas[i][k]);
+}
 
-// ------------------------------------------------------
-// The following requires linking with utf8 symbols.
-// To call them, either define i_import before including
-// one of cstr, csview, zsview, or link with src/libstc.o.
+STC_INLINE uint32_t utf8_casefold(uint32_t c)
+    { return _utf8_tocase(c, 0); }
 
-extern bool     utf8_valid_n(const char* s, isize nbytes);
-extern int      utf8_encode(char *out, uint32_t c);
-extern int      utf8_icompare(const csview s1, const csview s2);
-extern uint32_t utf8_peek_at(const char* s, isize u8offset);
-extern uint32_t utf8_casefold(uint32_t c);
-extern uint32_t utf8_tolower(uint32_t c);
-extern uint32_t utf8_toupper(uint32_t c);
+STC_INLINE uint32_t utf8_tolower(uint32_t c)
+    { return _utf8_tocase(c, 1); }
+
+STC_INLINE uint32_t utf8_toupper(uint32_t c)
+    { return _utf8_tocase(c, 2); }
 
 STC_INLINE bool utf8_isupper(uint32_t c)
     { return utf8_tolower(c) != c; }
@@ -114,6 +167,10 @@ STC_INLINE uint32_t utf8_peek(const char* s) {
     return d.codep;
 }
 
+/* case-insensitive prefix test: the first prefix.size bytes of s against prefix */
+STC_INLINE bool _utf8_istarts_with(csview s, csview prefix)
+    { return prefix.size <= s.size && !utf8_icompare(c_sv(s.buf, prefix.size), prefix); }
+
 /* case-insensitive utf8 string comparison */
 STC_INLINE int utf8_icmp(const char* s1, const char* s2) {
     return utf8_icompare(c_sv(s1, INTPTR_MAX), c_sv(s2, INTPTR_MAX));
@@ -36,12 +36,26 @@ typedef struct {
 
 typedef struct {
     double mean, stddev;
-    double _next;
-    int _has_next;
 } crand64_normal_dist;
 
+typedef struct {
+    double lambda;      // rate; mean is 1/lambda
+} crand64_exponential_dist;
+
+typedef struct {
+    struct _crand64_alias { uint64_t prob; isize alias; } *table;
+    isize size;
+} crand64_discrete_dist;
+
+// Ziggurat method; requires linking with stc lib.
 STC_API double crand64_normal(crand64_normal_dist* d);
 STC_API double crand64_normal_r(crand64* rng, uint64_t stream, crand64_normal_dist* d);
+STC_API double crand64_exponential(crand64_exponential_dist* d);
+STC_API double crand64_exponential_r(crand64* rng, uint64_t stream, crand64_exponential_dist* d);
+
+// Walker alias table from n non-negative weights (not all zero); requires linking with stc lib.
+STC_API crand64_discrete_dist crand64_make_discrete(const double weights[], isize n);
+STC_API void crand64_discrete_drop(crand64_discrete_dist* d);
 
 #if INTPTR_MAX == INT64_MAX
   #define crandWS crand64
@@ -108,6 +122,26 @@ STC_INLINE uint64_t crand64_uint(void)
 STC_INLINE double crand64_real(void)
     { return crand64_real_r(_stc64(), 1); }
 
+// Parallel streams: task/thread number `index` uses crand64_split(seed, index) with
+// stream crand64_stream(index). Deterministic for a given seed, independent of scheduling.
+STC_INLINE uint64_t crand64_stream(uint64_t index)
+    { return (index << 1) | 1; }
+
+STC_INLINE crand64 crand64_split(uint64_t seed, uint64_t index)
+    { return crand64_from(seed ^ index*0xd1b54a32d192ed03); }
+
+// Bulk generation: fills out[] from _crand_LANES generators which are seeded from rng and
+// advanced in lockstep using SIMD. Requires linking with stc lib.
+enum { _crand_LANES = 8 };
+STC_API void crand64_fill_r(crand64* rng, uint64_t stream, uint64_t out[], isize n);
+STC_API void crand64_fill_real_r(crand64* rng, uint64_t stream, double out[], isize n);
+
+STC_INLINE void crand64_fill(uint64_t out[], isize n)
+    { crand64_fill_r(_stc64(), 1, out, n); }
+
+STC_INLINE void crand64_fill_real(double out[], isize n)
+    { crand64_fill_real_r(_stc64(), 1, out, n); }
+
 // --- crand64_uniform ---
 
 typedef struct {
@@ -149,6 +183,26 @@ crand64_uniform_r(crand64* rng, uint64_t stream, crand64_uniform_dist* d) {
 STC_INLINE int64_t crand64_uniform(crand64_uniform_dist* d)
     { return crand64_uniform_r(_stc64(), 1, d); }
 
+// --- crand64_discrete ---
+
+// Returns index i in [0, d->size) with probability weights[i]/sum(weights). One rnd per sample:
+// the high part of rnd*size selects the column, the low part decides between it and its alias.
+STC_INLINE isize
+crand64_discrete_r(crand64* rng, uint64_t stream, const crand64_discrete_dist* d) {
+    uint64_t lo, hi;
+    #ifdef c_umul128
+        c_umul128(crand64_uint_r(rng, stream), (uint64_t)d->size, &lo, &hi);
+    #else
+        hi = crand64_uint_r(rng, stream) % (uint64_t)d->size;
+        lo = crand64_uint_r(rng, stream);
+    #endif
+    const struct _crand64_alias* e = &d->table[hi];
+    return lo < e->prob ? (isize)hi : e->alias;
+}
+
+STC_INLINE isize crand64_discrete(const crand64_discrete_dist* d)
+    { return crand64_discrete_r(_stc64(), 1, d); }
+
 // ===== crand32 ===================================
 
 typedef struct { uint32_t data[4]; } crand32;
@@ -191,6 +245,17 @@ STC_INLINE uint32_t crand32_uint(void)
 STC_INLINE double crand32_real(void)
     { return crand32_real_r(_stc32(), 1); }
 
+STC_INLINE uint32_t crand32_stream(uint32_t index)
+    { return (index << 1) | 1; }
+
+STC_INLINE crand32 crand32_split(uint32_t seed, uint32_t index)
+    { return crand32_from(seed ^ index*0x9e3779b9); }
+
+STC_API void crand32_fill_r(crand32* rng, uint32_t stream, uint32_t out[], isize n);
+
+STC_INLINE void crand32_fill(uint32_t out[], isize n)
+    { crand32_fill_r(_stc32(), 1, out, n); }
+
 // --- crand32_uniform ---
 
 typedef struct {
@@ -224,28 +289,372 @@ STC_INLINE int64_t crand32_uniform(crand32_uniform_dist* d)
 
 #ifndef STC_RANDOM_C_INCLUDED
 #define STC_RANDOM_C_INCLUDED
+#include <stdlib.h>
 #include <math.h>
 
-STC_DEF double
-crand64_normal_r(crand64* rng, uint64_t stream, crand64_normal_dist* d) {
-    double v1, v2, sq, rt;
-    if (d->_has_next++ & 1)
-        return d->_next*d->stddev + d->mean;
-    do {
-        // range (-1.0, 1.0):
-        v1 = (double)((int64_t)crand64_uint_r(rng, stream) >> 11) * 0x1.0p-52;
-        v2 = (double)((int64_t)crand64_uint_r(rng, stream) >> 11) * 0x1.0p-52;
+// --- ziggurat ---
+// 256 layers of equal area V covering f(x) = exp(-x*x/2) and exp(-x) respectively.
+// x[1] = R, x[0] = V/f(R), x[i+1] = f^-1(V/x[i] + f(x[i])), x[256] = 0.
+
+#define _crand_ZIG_NORM_R 3.6541528853610088
+#define _crand_ZIG_EXP_R 7.69711747013104972
+
+static const double _crand_zig_norm_x[257] = {
+    3.9107579595249167, 3.6541528853610092, 3.4492782985614316, 3.320244733839826,
+    3.2245750520478023, 3.1478892895180013, 3.0835261320021439, 3.0278377917695938,
+    2.9786032798818436, 2.9343668672088881, 2.8941210536134125, 2.857138730873225,
+    2.8228773968264433, 2.790921174001928, 2.760944005279987, 2.7326853590440123,
+    2.7059336561230634, 2.6805146432857461, 2.6562830375767441, 2.6331163936315836,
+    2.6109105184888244, 2.5895759867082875, 2.5690354526818444, 2.5492215503247837,
+    2.5300752321598545, 2.5115444416266945, 2.4935830412710467, 2.4761499396705231,
+    2.4592083743347048, 2.4427253182003641, 2.4266709849371466, 2.4110184139011195,
+    2.3957431197819274, 2.3808227951720857, 2.3662370567172908, 2.3519672273791445,
+    2.3379961487965284, 2.3243080188711325, 2.3108882506013719, 2.2977233489028634,
+    2.2848008027244919, 2.2721089902283818, 2.2596370951737876, 2.2473750329473892,
+    2.2353133849299209, 2.2234433400925102, 2.2117566428841604, 2.200245546611276,
+    2.1889027716263603, 2.1777214677402923, 2.1666951803543077, 2.1558178198767366,
+    2.145083634047888, 2.1344871828460161, 2.1240233156895227, 2.1136871506866526,
+    2.1034740557148766, 2.0933796311387916, 2.0833996939983042, 2.0735302635187427,
+    2.0637675478117319, 2.0541079316506519, 2.0445479652175313, 2.0350843537296188,
+    2.0257139478638542, 2.016433734906204, 2.0072408305605287, 1.9981324713584196,
+    1.9891060076174381, 1.9801588969004766, 1.9712886979336592, 1.962493064944363,
+    1.9537697423846467, 1.9451165600086784, 1.9365314282756947, 1.9280123340526658,
+    1.9195573365931882, 1.9111645637712535, 1.9028322085504297, 1.8945585256707052,
+    1.8863418285367834, 1.8781804862929965, 1.8700729210712674, 1.8620176053996749,
+    1.8540130597602025, 1.8460578502851861, 1.8381505865828072, 1.8302899196827576,
+    1.8224745400938864, 1.8147031759662833, 1.8069745913508215, 1.7992875845497207,
+    1.791640986552163, 1.7840336595494419, 1.7764644955245235, 1.7689324149112691,
+    1.7614363653189107, 1.753975320317672, 1.7465482782817228, 1.7391542612859121,
+    1.7317923140529636, 1.7244615029480455, 1.7171609150178238, 1.7098896570713025,
+    1.7026468547999238, 1.6954316519345622, 1.6882432094371962, 1.6810807047251746,
+    1.6739433309261256, 1.6668302961616661, 1.6597408228581831, 1.6526741470830566,
+    1.6456295179047831, 1.6386061967755485, 1.6316034569348743, 1.6246205828330356,
+    1.6176568695730162, 1.6107116223698308, 1.6037841560260953, 1.5968737944227889,
+    1.5899798700241916, 1.5831017233960301, 1.5762387027359073, 1.5693901634151246,
+    1.5625554675310458, 1.5557339834691772, 1.5489250854741743, 1.542128153229003,
+    1.5353425714415152, 1.5285677294377134, 1.5218030207609992, 1.5150478427767158,
+    1.5083015962813129, 1.501563685115465, 1.4948335157804951, 1.488110497057449,
+    1.4813940396281888, 1.4746835556978568, 1.4679784586180809, 1.4612781625102769,
+    1.4545820818884116, 1.4478896312805773, 1.4412002248487252, 1.4345132760058934,
+    1.4278281970302571, 1.4211443986753103, 1.4144612897754725, 1.4077782768464002,
+    1.4010947636792523, 1.3944101509281424, 1.3877238356899773, 1.3810352110758566,
+    1.3743436657731674, 1.3676485835974772, 1.3609493430332842, 1.354245316762636,
+    1.3475358711805883, 1.3408203658964051, 1.334098153219361, 1.3273685776279269,
+    1.3206309752210572, 1.3138846731502214, 1.307128989030732, 1.3003632303308381,
+    1.2935866937369487, 1.2867986644932445, 1.2799984157138189, 1.2731852076653574,
+    1.2663582870182304, 1.2595168860637151, 1.2526602218948981, 1.2457874955486281,
+    1.2388978911056883, 1.2319905747461368, 1.2250646937565315, 1.2181193754854824,
+    1.2111537262437, 1.2041668301443824, 1.1971577478794424, 1.1901255154266928,
+    1.1830691426826876, 1.1759876120154529, 1.1688798767308342, 1.1617448594456123,
+    1.1545814503599288, 1.1473885054208501, 1.1401648443681522, 1.132909248652535,
+    1.1256204592155346, 1.1182971741193461, 1.1109380460135769, 1.1035416794246411,
+    1.0961066278520228, 1.0886313906539813, 1.0811144097034053, 1.0735540657924376,
+    1.0659486747621238, 1.0582964833306765, 1.0505956645909313, 1.0428443131441505,
+    1.0350404398334425, 1.0271819660356476, 1.0192667174654859, 1.0112924174399973,
+    1.0032566795446747, 0.99515699963509263, 0.9869907470990642, 0.9787551552942263,
+    0.9704473110642261, 0.96206414322304223, 0.9536024098810878, 0.94505868446816721,
+    0.93642934028657687, 0.92771053340200182, 0.91889818364959241, 0.90998795349672035,
+    0.90097522446122358, 0.89185507073294346, 0.88262222958516745, 0.87327106808886257,
+    0.86379554555331084, 0.85418917100816583, 0.84444495490915594, 0.83455535408638426,
+    0.82451220875229425, 0.81430667013521751, 0.8039291169899736, 0.7933690588406257,
+    0.78261502330723554, 0.77165442422457053, 0.76047340643011063, 0.74905666201781795,
+    0.73738721143429831, 0.72544614091000248, 0.71321228519097879, 0.70066184110681806,
+    0.68776789279579165, 0.67449982283729704, 0.66082257424442303, 0.64669571489499733,
+    0.6320722363860648, 0.61689699000775522, 0.60110461775599644, 0.58461676610638347,
+    0.56733825705382324, 0.54915170232716992, 0.52990972066156317, 0.50942332960209724,
+    0.48744396613924196, 0.46363433679088872, 0.43751840220787891, 0.40838913461199949,
+    0.37512133287839028, 0.33573751921443695, 0.28617459179208804, 0.2152418959849064,
+    0.0
+};
+
+static const double _crand_zig_exp_x[257] = {
+    8.697117470131051, 7.6971174701310501, 6.9410336293772126, 6.4783784938325697,
+    6.1441646657724727, 5.8821443157953999, 5.6664101674540337, 5.4828906275260625,
+    5.323090505754398, 5.1814872813015, 5.0542884899813041, 4.9387770859012505,
+    4.832939741025112, 4.7352429966017411, 4.6444918854200852, 4.5597370617073514,
+    4.4802117465284219, 4.4052876934735732, 4.334443680317273, 4.2672424802773659,
+    4.2033137137351844, 4.1423408656640515, 4.0840513104082978, 4.0282085446479368,
+    3.9746060666737888, 3.9230625001354897, 3.8734176703995091, 3.8255294185223367,
+    3.7792709924116679, 3.7345288940397974, 3.6912010902374188, 3.6491955157608538,
+    3.6084288131289095, 3.568825265648337, 3.5303158891293434, 3.4928376547740596,
+    3.4563328211327602, 3.4207483572511199, 3.386035442460301, 3.3521490309001094,
+    3.319047470970748, 3.2866921715990687, 3.2550473085704499, 3.2240795652862642,
+    3.1937579032122403, 3.1640533580259729, 3.1349388580844404, 3.1063890623398245,
+    3.0783802152540902, 3.0508900166154551, 3.0238975044556766, 2.9973829495161306,
+    2.9713277599210897, 2.9457143948950457, 2.9205262865127408, 2.8957477686001418,
+    2.8713640120155364, 2.8473609656351888, 2.8237253024500353, 2.8004443702507378,
+    2.7775061464397566, 2.7548991965623446, 2.7326126361947001, 2.7106360958679288,
+    2.6889596887418037, 2.6675739807732666, 2.6464699631518092, 2.6256390267977885,
+    2.6050729387408356, 2.5847638202141408, 2.5647041263169053, 2.54488662711187,
+    2.525304390037828, 2.505950763528594, 2.4868193617402095, 2.4679040502973648,
+    2.4491989329782498, 2.4306983392644197, 2.4123968126888706, 2.3942890999214579,
+    2.3763701405361406, 2.3586350574093373, 2.3410791477030344, 2.3236978743901964,
+    2.3064868582835798, 2.2894418705322694, 2.2725588255531548, 2.2558337743672192,
+    2.239262898312909, 2.2228425031110368, 2.2065690132576639, 2.19043896672322,
+    2.1744490099377747, 2.158595893043886, 2.142876465399842, 2.1272876713173683,
+    2.1118265460190422, 2.096490211801715, 2.0812758743932251, 2.0661808194905755,
+    2.0512024094685848, 2.0363380802487696, 2.0215853383189262, 2.0069417578945186,
+    1.9924049782135766, 1.9779727009573604, 1.9636426877895483, 1.9494127580071849,
+    1.9352807862970514, 1.9212447005915281, 1.9073024800183875, 1.8934521529393082,
+    1.8796917950722112, 1.866019527692828, 1.8524335159111756, 1.83893196701888,
+    1.8255131289035198, 1.8121752885263906, 1.7989167704602909, 1.785735935484126,
+    1.7726311792313056, 1.7596009308890748, 1.7466436519460744, 1.7337578349855716,
+    1.7209420025219353, 1.7081947058780578, 1.6955145241015379, 1.6829000629175539,
+    1.6703499537164521, 1.6578628525741728, 1.6454374393037237, 1.6330724165359913,
+    1.6207665088282579, 1.6085184617988584, 1.5963270412864834, 1.5841910325326889,
+    1.5721092393862297, 1.5600804835278881, 1.5481036037145135, 1.5361774550410321,
+    1.5243009082192263, 1.5124728488721171, 1.5006921768428167, 1.4889578055167461,
+    1.4772686611561339, 1.4656236822457454, 1.4540218188487934, 1.4424620319720125,
+    1.4309432929388797, 1.4194645827699832, 1.4080248915695357, 1.3966232179170421,
+    1.3852585682631222, 1.3739299563284908, 1.362636402505087, 1.3513769332583354,
+    1.3401505805295051, 1.328956381137117, 1.3177933761763252, 1.3066606104151746,
+    1.2955571316866015, 1.2844819902750131, 1.2734342382962416, 1.2624129290696158,
+    1.251417116480853, 1.240445854334407, 1.2294981956938498, 1.218573192208791,
+    1.2076698934267622, 1.196787346088404, 1.1859245934042031, 1.1750806743109123,
+    1.1642546227056796, 1.1534454666557754, 1.1426522275816735, 1.1318739194110792,
+    1.1211095477013311, 1.1103581087274119, 1.0996185885325982, 1.0888899619385479,
+    1.0781711915113732, 1.0674612264799688, 1.0567590016025523, 1.0460634359770451,
+    1.0353734317905294, 1.0246878730026183, 1.0140056239570978, 1.0033255279156981,
+    0.99264640550727723, 0.98196705308506393, 0.97128624098390481, 0.96060271166866795,
+    0.94991517776407741, 0.93922231995526384, 0.92852278474721195, 0.91781518207004575,
+    0.90709808271569181, 0.89637001558989149, 0.88562946476175308, 0.87487486629102673,
+    0.86410460481100604, 0.85331700984237491, 0.84251035181037004, 0.83168283773427465,
+    0.82083260655441337, 0.80995772405741995, 0.79905617735548873, 0.7881258688694941,
+    0.77716460975913126, 0.76617011273543623, 0.7551399841819838, 0.74407171550050955,
+    0.73296267358436695, 0.72181009030875776, 0.71061105090965648, 0.6993624811032334,
+    0.68806113277374936, 0.67670356802952414, 0.66528614139267939, 0.6538049798476665,
+    0.64225596042453792, 0.63063468493349195, 0.61893645139487774, 0.60715622162030169,
+    0.59528858429150444, 0.58332771274877115, 0.57126731653258989, 0.55910058551154218,
+    0.54682012516331213, 0.53441788123716705, 0.52188505159213661, 0.50921198244365595,
+    0.4963880455186726, 0.4834014916534633, 0.47023927508217045, 0.45688684093142179,
+    0.44332786607355412, 0.42954394022541259, 0.41551416960035825, 0.4012146788962796,
+    0.3866179779411214, 0.37169214532991918, 0.3563997602583957, 0.34069648106485118,
+    0.32452911701691145, 0.30783295467493427, 0.29052795549123261, 0.27251318547846703,
+    0.25365836338591446, 0.23379048305967726, 0.21267151063096923, 0.18995868962243467,
+    0.16512762256419042, 0.13730498094001628, 0.10483850756582322, 0.063852163815007607,
+    0.0
+};
+
+static double _crand64_zig_normal(crand64* rng, uint64_t stream) {
+    const double* X = _crand_zig_norm_x;
+    for (;;) {
+        const uint64_t r = crand64_uint_r(rng, stream);
+        const int i = (int)(r & 0xff);
+        const double sign = r & 0x100 ? -1.0 : 1.0;
+        const double x = (double)(r >> 11)*0x1.0p-53 * X[i];
+        if (x < X[i + 1]) // inside the inner rectangle: ~99% of the samples
+            return sign*x;
+        if (i == 0) { // sample the tail beyond R (Marsaglia)
+            double a, b;
+            do {
+                a = -log(1.0 - crand64_real_r(rng, stream)) / _crand_ZIG_NORM_R;
+                b = -log(1.0 - crand64_real_r(rng, stream));
+            } while (b + b < a*a);
+            return sign*(_crand_ZIG_NORM_R + a);
+        }
+        const double f0 = exp(-0.5*X[i]*X[i]), f1 = exp(-0.5*X[i + 1]*X[i + 1]);
+        if (f0 + crand64_real_r(rng, stream)*(f1 - f0) < exp(-0.5*x*x))
+            return sign*x;
+    }
+}
 
-        sq = v1*v1 + v2*v2;
-    } while (sq >= 1.0 || sq == 0.0);
-    rt = sqrt(-2.0 * log(sq) / sq);
-    d->_next = v2*rt;
-    return (v1*rt)*d->stddev + d->mean;
+static double _crand64_zig_exponential(crand64* rng, uint64_t stream) {
+    const double* X = _crand_zig_exp_x;
+    double base = 0.0;
+    for (;;) {
+        const uint64_t r = crand64_uint_r(rng, stream);
+        const int i = (int)(r & 0xff);
+        const double x = (double)(r >> 11)*0x1.0p-53 * X[i];
+        if (x < X[i + 1])
+            return base + x;
+        if (i == 0) { // memoryless: the tail is R + another exponential sample
+            base += _crand_ZIG_EXP_R;
+            continue;
+        }
+        const double f0 = exp(-X[i]), f1 = exp(-X[i + 1]);
+        if (f0 + crand64_real_r(rng, stream)*(f1 - f0) < exp(-x))
+            return base + x;
+    }
 }
 
+STC_DEF double
+crand64_normal_r(crand64* rng, uint64_t stream, crand64_normal_dist* d)
+    { return _crand64_zig_normal(rng, stream)*d->stddev + d->mean; }
+
 STC_DEF double crand64_normal(crand64_normal_dist* d)
     { return crand64_normal_r(_stc64(), 1, d); }
 
+STC_DEF double
+crand64_exponential_r(crand64* rng, uint64_t stream, crand64_exponential_dist* d)
+    { return _crand64_zig_exponential(rng, stream) / d->lambda; }
+
+STC_DEF double crand64_exponential(crand64_exponential_dist* d)
+    { return crand64_exponential_r(_stc64(), 1, d); }
+
+// --- alias table (Vose) ---
+
+STC_DEF crand64_discrete_dist crand64_make_discrete(const double weights[], isize n) {
+    crand64_discrete_dist d = {NULL, 0};
+    double sum = 0.0;
+    for (isize i = 0; i < n; ++i) sum += weights[i];
+    if (n <= 0 || !(sum > 0.0))
+        return d;
+
+    d.table = (struct _crand64_alias*)c_malloc(n*c_sizeof *d.table);
+    double* p = (double*)c_malloc(n*c_sizeof *p);
+    isize* work = (isize*)c_malloc(n*c_sizeof *work);
+    isize nsmall = 0, nlarge = n; // small from the front, large from the back of work[]
+    d.size = n;
+
+    for (isize i = 0; i < n; ++i) {
+        p[i] = weights[i]*(double)n/sum;
+        if (p[i] < 1.0) work[nsmall++] = i;
+        else work[--nlarge] = i;
+    }
+    while (nsmall > 0 && nlarge < n) {
+        const isize s = work[--nsmall], l = work[nlarge];
+        d.table[s].prob = (uint64_t)(p[s]*0x1.0p64);
+        d.table[s].alias = l;
+        p[l] -= 1.0 - p[s];
+        if (p[l] < 1.0) { // l becomes small: move it over to the small end
+            work[nsmall++] = l;
+            ++nlarge;
+        }
+    }
+    // remaining columns are full (up to rounding errors)
+    for (isize i = 0; i < nsmall; ++i) d.table[work[i]] = (struct _crand64_alias){UINT64_MAX, work[i]};
+    for (isize i = nlarge; i < n; ++i) d.table[work[i]] = (struct _crand64_alias){UINT64_MAX, work[i]};
+
+    c_free(work, n*c_sizeof *work);
+    c_free(p, n*c_sizeof *p);
+    return d;
+}
+
+STC_DEF void crand64_discrete_drop(crand64_discrete_dist* d) {
+    c_free(d->table, d->size*c_sizeof *d->table);
+    d->table = NULL, d->size = 0;
+}
+
+// --- bulk fill ---
+// Each lane j holds the state of one generator; lanes are stepped as 128/256-bit vectors
+// when available. The output is the same for all targets: out[i] comes from lane i % LANES.
+
+#if defined __AVX2__
+  #include <immintrin.h>
+  typedef __m256i _crand_v64, _crand_v32;
+  #define _crand_load(w, p) _mm256_loadu_si256((const __m256i*)(p))
+  #define _crand_store(w, p, a) _mm256_storeu_si256((__m256i*)(p), a)
+  #define _crand_add(w, a, b) _mm256_add_epi##w(a, b)
+  #define _crand_xor(w, a, b) _mm256_xor_si256(a, b)
+  #define _crand_or(w, a, b) _mm256_or_si256(a, b)
+  #define _crand_shl(w, a, k) _mm256_slli_epi##w(a, k)
+  #define _crand_shr(w, a, k) _mm256_srli_epi##w(a, k)
+#elif defined __SSE2__ || defined _M_X64
+  #include <emmintrin.h>
+  typedef __m128i _crand_v64, _crand_v32;
+  #define _crand_load(w, p) _mm_loadu_si128((const __m128i*)(p))
+  #define _crand_store(w, p, a) _mm_storeu_si128((__m128i*)(p), a)
+  #define _crand_add(w, a, b) _mm_add_epi##w(a, b)
+  #define _crand_xor(w, a, b) _mm_xor_si128(a, b)
+  #define _crand_or(w, a, b) _mm_or_si128(a, b)
+  #define _crand_shl(w, a, k) _mm_slli_epi##w(a, k)
+  #define _crand_shr(w, a, k) _mm_srli_epi##w(a, k)
+#elif defined __ARM_NEON
+  #include <arm_neon.h>
+  typedef uint64x2_t _crand_v64;
+  typedef uint32x4_t _crand_v32;
+  #define _crand_load(w, p) vld1q_u##w(p)
+  #define _crand_store(w, p, a) vst1q_u##w(p, a)
+  #define _crand_add(w, a, b) vaddq_u##w(a, b)
+  #define _crand_xor(w, a, b) veorq_u##w(a, b)
+  #define _crand_or(w, a, b) vorrq_u##w(a, b)
+  #define _crand_shl(w, a, k) vshlq_n_u##w(a, k)
+  #define _crand_shr(w, a, k) vshrq_n_u##w(a, k)
+#else
+  typedef uint64_t _crand_v64;
+  typedef uint32_t _crand_v32;
+  #define _crand_load(w, p) (*(p))
+  #define _crand_store(w, p, a) (*(p) = (a))
+  #define _crand_add(w, a, b) ((a) + (b))
+  #define _crand_xor(w, a, b) ((a) ^ (b))
+  #define _crand_or(w, a, b) ((a) | (b))
+  #define _crand_shl(w, a, k) ((a) << (k))
+  #define _crand_shr(w, a, k) ((a) >> (k))
+#endif
+
+#if defined __GNUC__ // keep the lane vectors in registers also at -O2
+  #define _crand_UNROLL _Pragma("GCC unroll 8")
+#else
+  #define _crand_UNROLL
+#endif
+
+// Generates nblocks*_crand_LANES numbers to out[] from the lane states st[4][_crand_LANES].
+#define _crand_DEF_LANES(w, a, b, c) \
+static void _crand##w##_lanes(uint##w##_t st[4][_crand_LANES], uint##w##_t stream, \
+                              uint##w##_t* out, isize nblocks) { \
+    enum { N = sizeof(_crand_v##w)/sizeof(uint##w##_t), NV = _crand_LANES/N }; \
+    _crand_v##w s0[NV], s1[NV], s2[NV], s3[NV], inc; \
+    uint##w##_t incv[N]; \
+    for (int j = 0; j < N; ++j) incv[j] = stream; \
+    inc = _crand_load(w, incv); \
+    memcpy(s0, st[0], sizeof s0); memcpy(s1, st[1], sizeof s1); \
+    memcpy(s2, st[2], sizeof s2); memcpy(s3, st[3], sizeof s3); \
+    for (; nblocks--; out += _crand_LANES) { \
+        _crand_UNROLL \
+        for (int v = 0; v < NV; ++v) { \
+            s3[v] = _crand_add(w, s3[v], inc); \
+            const _crand_v##w r = _crand_add(w, _crand_xor(w, s0[v], s3[v]), s1[v]); \
+            s0[v] = _crand_xor(w, s1[v], _crand_shr(w, s1[v], a)); \
+            s1[v] = _crand_add(w, s2[v], _crand_shl(w, s2[v], b)); \
+            s2[v] = _crand_add(w, _crand_or(w, _crand_shl(w, s2[v], c), _crand_shr(w, s2[v], w - c)), r); \
+            _crand_store(w, out + v*N, r); \
+        } \
+    } \
+    memcpy(st[0], s0, sizeof s0); memcpy(st[1], s1, sizeof s1); \
+    memcpy(st[2], s2, sizeof s2); memcpy(st[3], s3, sizeof s3); \
+} \
+\
+static void _crand##w##_lanes_init(crand##w* rng, uint##w##_t stream, uint##w##_t st[4][_crand_LANES]) { \
+    for (int j = 0; j < _crand_LANES; ++j) { \
+        crand##w lane = crand##w##_from(crand##w##_uint_r(rng, stream)); \
+        for (int k = 0; k < 4; ++k) st[k][j] = lane.data[k]; \
+    } \
+} \
+\
+STC_DEF void crand##w##_fill_r(crand##w* rng, uint##w##_t stream, uint##w##_t out[], isize n) { \
+    if (n < 4*_crand_LANES) { \
+        for (isize i = 0; i < n; ++i) out[i] = crand##w##_uint_r(rng, stream); \
+        return; \
+    } \
+    uint##w##_t st[4][_crand_LANES], tail[_crand_LANES]; \
+    const isize nb = n/_crand_LANES, rem = n - nb*_crand_LANES; \
+    _crand##w##_lanes_init(rng, stream, st); \
+    _crand##w##_lanes(st, stream, out, nb); \
+    if (rem) { \
+        _crand##w##_lanes(st, stream, tail, 1); \
+        c_memcpy(out + nb*_crand_LANES, tail, rem*c_sizeof tail[0]); \
+    } \
+}
+
+_crand_DEF_LANES(64, 11, 3, 24)
+_crand_DEF_LANES(32, 9, 3, 21)
+
+STC_DEF void crand64_fill_real_r(crand64* rng, uint64_t stream, double out[], isize n) {
+    enum { BLOCK = 64*_crand_LANES };
+    uint64_t st[4][_crand_LANES], buf[BLOCK];
+    if (n < 4*_crand_LANES) {
+        for (isize i = 0; i < n; ++i) out[i] = crand64_real_r(rng, stream);
+        return;
+    }
+    _crand64_lanes_init(rng, stream, st);
+    for (isize i = 0; i < n; i += BLOCK) {
+        const isize m = n - i < BLOCK ? n - i : BLOCK;
+        _crand64_lanes(st, stream, buf, (m + _crand_LANES - 1)/_crand_LANES);
+        for (isize j = 0; j < m; ++j)
+            out[i + j] = (double)(buf[j] >> 11) * 0x1.0p-53;
+    }
+}
+
 #endif // STC_RANDOM_C_INCLUDED
 #endif // i_implement
 #include "priv/linkage2.h"
@@ -148,22 +148,24 @@ STC_INLINE bool zsview_eq(const zsview* x, const zsview* y)
     { return x->size == y->size && !c_memcmp(x->str, y->str, x->size); }
 
 STC_INLINE int zsview_icmp(const zsview* x, const zsview* y)
-    { return utf8_icmp(x->str, y->str); }
+    { return utf8_icompare(c_sv(x->str, x->size), c_sv(y->str, y->size)); }
 
 STC_INLINE bool zsview_ieq(const zsview* x, const zsview* y)
-    { return x->size == y->size && !utf8_icmp(x->str, y->str); }
+    { return x->size == y->size && !utf8_icompare(c_sv(x->str, x->size), c_sv(y->str, y->size)); }
 
 /* ---- case insensitive ---- */
 
-STC_INLINE bool zsview_iequals(zsview zs, const char* str)
-    { return c_strlen(str) == zs.size && !utf8_icmp(zs.str, str); }
+STC_INLINE bool zsview_iequals(zsview zs, const char* str) {
+    isize n = c_strlen(str);
+    return n == zs.size && !utf8_icompare(c_sv(zs.str, n), c_sv(str, n));
+}
 
 STC_INLINE bool zsview_istarts_with(zsview zs, const char* str)
-    { return c_strlen(str) <= zs.size && !utf8_icmp(zs.str, str); }
+    { return _utf8_istarts_with(c_sv(zs.str, zs.size), c_sv(str, c_strlen(str))); }
 
 STC_INLINE bool zsview_iends_with(zsview zs, const char* str) {
     isize n = c_strlen(str);
-    return n <= zs.size && !utf8_icmp(zs.str + zs.size - n, str);
+    return n <= zs.size && !utf8_icompare(c_sv(zs.str + zs.size - n, n), c_sv(str, n));
 }
 
 #endif // STC_ZSVIEW_H_INCLUDED
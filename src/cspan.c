@@ -1,2 +1,3 @@
+#define _POSIX_C_SOURCE 200809L // mmap, posix_madvise for cspan_npy_mmap()
 #define i_implement
 #include "../include/stc/cspan.h"
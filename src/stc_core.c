@@ -1,2 +1,5 @@
+#if defined STC_CCO_PROFILE && !defined _POSIX_C_SOURCE
+  #define _POSIX_C_SOURCE 200809L // clock_gettime(CLOCK_MONOTONIC)
+#endif
 #define STC_IMPLEMENT
 #include "../include/stc/coroutine.h"
@@ -1,6 +1,8 @@
 #!python
 # To generate "include/stc/priv/utf8_tab.c" file.
+# With argument "ucd": the unicode group tables in "include/stc/priv/ucd_prv.c".
 
+import sys
 import pandas as pd
 import numpy as np
 
@@ -98,13 +100,124 @@ def print_table(name, table, style=1, bitrange=16):
     print('}; // %d\n' % (len(table)))
 
 
-def print_index_table(name, indtab):
-    print('\nstatic uint8_t %s[%d] = {\n   ' % (name, len(indtab)), end='')
+def print_index_table(name, indtab, qual='const '):
+    print('\n%suint8_t %s[%d] = {\n   ' % (qual, name, len(indtab)), end='')
     for i in range(len(indtab)):
         print(" %d," % (indtab[i]), end='\n   ' if (i+1) % 20 == 0 else '')
     print('\n};')
 
 
+def _map_case(entries, c, inverse=False):
+    # same lookup as the original range tables: entries sorted by first (mapped) char.
+    for c1, c2, m2 in entries:
+        d = m2 - c2
+        if inverse:
+            if c <= m2:
+                if c < c1 + d: return c
+                if d == 1: return c - ((m2 & 1) == (c & 1))
+                return c - d
+        elif c <= c2:
+            if c < c1: return c
+            if d == 1: return c + ((c2 & 1) == (c & 1))
+            return c + d
+    return c
+
+
+def make_case_stages(casemappings, casefold_len, upcase_ind, lowcase_ind, shift=6):
+    # two-stage lookup: stage1[c >> shift] selects a block in stage2, which holds
+    # an index into the distinct (fold, lower, upper) deltas for each char in the block.
+    fold = [(a, b, c) for a, b, c, _ in casemappings[:casefold_len]]
+    lower = [casemappings[i][:3] for i in upcase_ind]
+    upper = [casemappings[i][:3] for i in lowcase_ind]
+    deltas, delta_ind = [], {}
+    blocks, block_ind, stage1 = [], {}, []
+    size = 1 << shift
+    for start in range(0, 1 << 16, size):
+        block = []
+        for c in range(start, start + size):
+            d = (_map_case(fold, c) - c, _map_case(lower, c) - c, _map_case(upper, c, True) - c)
+            if d not in delta_ind:
+                delta_ind[d] = len(deltas)
+                deltas.append(d)
+            block.append(delta_ind[d])
+        block = tuple(block)
+        if block not in block_ind:
+            block_ind[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(block_ind[block])
+    return deltas, stage1, [i for b in blocks for i in b]
+
+
+def print_case_stages(deltas, stage1, stage2, shift=6):
+    # shift must match _utf8_CASE_SHIFT in utf8_prv.h
+    print('#include <stdint.h>\n')
+    print('// {fold, lower, upper} offsets, selected by utf8_casestage2[(utf8_casestage1[c >> %d] << %d) | (c & %d)]'
+          % (shift, shift, (1 << shift) - 1))
+    print('const int32_t utf8_casedeltas[%d][3] = {' % len(deltas))
+    for f, l, u in deltas:
+        print('    {%d, %d, %d},' % (f, l, u))
+    print('};')
+    print_index_table('utf8_casestage1', stage1)
+    print_index_table('utf8_casestage2', stage2)
+
+
+# group order must match the U8G_ enum in priv/ucd_prv.c
+UCD_GROUPS = ['Cc', 'Lt', 'Nd', 'Nl', 'Pc', 'Pd', 'Pf', 'Pi', 'Sc', 'Zl', 'Zp', 'Zs',
+              'Arabic', 'Bengali', 'Cyrillic', 'Devanagari', 'Georgian', 'Greek',
+              'Han', 'Hiragana', 'Katakana', 'Latin', 'Thai']
+
+
+def read_group_ranges(groups=UCD_GROUPS, bitrange=16):
+    # general categories from UnicodeData.txt, scripts from Scripts.txt
+    cat = read_unidata(None, None, bitrange)
+    scr = pd.read_csv(_UNICODE_DIR+'/Scripts.txt', engine='python', sep=r'\s*;\s*|\s+#', comment=None,
+                      names=['code', 'script', 'comment'], usecols=['code', 'script'])
+    scr = scr[~scr['code'].str.startswith('#', na=True)]
+    ranges = []
+    for g in groups:
+        if len(g) == 2:
+            ranges.append([(c, c) for c in cat[cat['category'] == g]['code']])
+        else:
+            rs = []
+            for code in scr[scr['script'] == g]['code']:
+                a, _, b = code.partition('..')
+                a = int(a, 16); b = int(b, 16) if b else a
+                if bitrange == 16 and a < (1<<16):
+                    rs.append((a, min(b, (1<<16) - 1)))
+            ranges.append(rs)
+    return ranges
+
+
+def make_property_stages(ranges, shift=5):
+    # bit j of masks[stage2[(stage1[c >> shift] << shift) | low bits]] is set if c is in group j.
+    mask = [0]*(1 << 16)
+    for bit, rs in enumerate(ranges):
+        for a, b in rs:
+            for c in range(a, b + 1):
+                mask[c] |= 1 << bit
+    masks = sorted(set(mask))
+    mask_ind = {m: i for i, m in enumerate(masks)}
+    blocks, block_ind, stage1 = [], {}, []
+    size = 1 << shift
+    for start in range(0, 1 << 16, size):
+        block = tuple(mask_ind[mask[c]] for c in range(start, start + size))
+        if block not in block_ind:
+            block_ind[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(block_ind[block])
+    return masks, stage1, [i for b in blocks for i in b]
+
+
+def print_property_stages(masks, stage1, stage2, shift=5):
+    # shift must match _utf8_UCD_SHIFT in priv/ucd_prv.c
+    print('static const uint32_t _utf8_ucd_masks[%d] = {' % len(masks))
+    for i in range(0, len(masks), 6):
+        print('    ' + ', '.join('0x%06X' % m for m in masks[i:i+6]) + ',')
+    print('};')
+    print_index_table('_utf8_ucd_stage1', stage1, 'static const ')
+    print_index_table('_utf8_ucd_stage2', stage2, 'static const ')
+
+
 def compile_table(casetype='lowcase', category=None, bitrange=16):
     if category:
         df = read_unidata(casetype, category, bitrange)
@@ -117,6 +230,9 @@ def compile_table(casetype='lowcase', category=None, bitrange=16):
 
 def main():
     bitrange = 16
+    if len(sys.argv) > 1 and sys.argv[1] == 'ucd': # group tables for priv/ucd_prv.c
+        print_property_stages(*make_property_stages(read_group_ranges(UCD_GROUPS, bitrange)))
+        return
 
     casemappings = compile_table('lowcase', None, bitrange) # CaseFolding.txt
     upcase       = compile_table('lowcase', 'Lu', bitrange) # UnicodeData.txt uppercase
@@ -146,18 +262,16 @@ def main():
             lowcase_ind.append(len(casemappings))
             casemappings.append(v)
 
-    print_table('casemappings', casemappings, style=1, bitrange=bitrange)
-    print('enum { casefold_len = %d };' % casefolding_len)
-
     # upcase => low
     upcase_ind.sort(key=lambda i: casemappings[i][0])
-    print_index_table('upcase_ind', upcase_ind)
 
     # lowcase => up. add "missing" SHARP S caused by https://www.unicode.org/policies/stability_policy.html#Case_Pair
     if bitrange == 16:
         lowcase_ind.append(next(i for i,x in enumerate(casemappings) if x[0]==ord('ẞ')))
     lowcase_ind.sort(key=lambda i: casemappings[i][2] - (casemappings[i][1] - casemappings[i][0]))
-    print_index_table('lowcase_ind', lowcase_ind)
+
+    deltas, stage1, stage2 = make_case_stages(casemappings, casefolding_len, upcase_ind, lowcase_ind)
+    print_case_stages(deltas, stage1, stage2)
 
 
 ########### main:
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include "stc/cbitmap.h"
+#include "ctest.h"
+
+enum {NBITS = 6*65536};
+
+static uint32_t lcg(uint64_t* s) {
+    *s = *s*6364136223846793005u + 1442695040888963407u;
+    return (uint32_t)(*s >> 33);
+}
+
+// Fill with a mix of sparse, dense and ranged chunks; mirror the members in a flat cbits.
+static void fill(cbitmap* bm, cbits* ref, uint64_t seed) {
+    for (c_range(i, 20000)) {
+        uint32_t x = lcg(&seed) % NBITS;
+        if ((x >> 16) % 3 == 0) x &= ~0x3f0u; // make some chunks sparse
+        cbitmap_add(bm, x);
+        cbits_set(ref, x);
+    }
+    uint32_t start = lcg(&seed) % NBITS, end = start + lcg(&seed) % 100000;
+    if (end > NBITS) end = NBITS;
+    cbitmap_add_range(bm, start, end);
+    for (c_range(i, start, end)) cbits_set(ref, i);
+}
+
+static bool equal(const cbitmap* bm, const cbits* ref) {
+    isize next = cbits_find_next(ref, 0);
+    for (c_each_set_bit(i, cbitmap, *bm)) {
+        if (i.index != next) return false;
+        next = cbits_find_next(ref, next + 1);
+    }
+    return next == c_NPOS && cbitmap_count(bm) == cbits_count(ref);
+}
+
+TEST(cbitmap, add_remove) {
+    cbitmap bm = cbitmap_init();
+    cbits ref = cbits_with_size(NBITS, false);
+    fill(&bm, &ref, 1);
+    EXPECT_TRUE(equal(&bm, &ref));
+    EXPECT_FALSE(cbitmap_add(&bm, (uint32_t)cbits_find_next(&ref, 0)));
+
+    for (c_range(i, 0, NBITS, 3)) {
+        EXPECT_EQ(cbits_test(&ref, i), cbitmap_contains(&bm, (uint32_t)i));
+        EXPECT_EQ(cbits_test(&ref, i), cbitmap_remove(&bm, (uint32_t)i));
+        cbits_reset(&ref, i);
+    }
+    EXPECT_TRUE(equal(&bm, &ref));
+    EXPECT_TRUE(cbitmap_contains(&bm, (uint32_t)cbits_find_next(&ref, 0)));
+
+    cbitmap_add(&bm, UINT32_MAX);
+    EXPECT_TRUE(cbitmap_contains(&bm, UINT32_MAX));
+    EXPECT_EQ(cbits_count(&ref) + 1, cbitmap_count(&bm));
+
+    cbitmap_clear(&bm);
+    cbitmap_add_range(&bm, 65530, 3*65536 + 5);
+    EXPECT_EQ(2*65536 + 11, cbitmap_count(&bm));
+    EXPECT_TRUE(cbitmap_contains(&bm, 65530));
+    EXPECT_FALSE(cbitmap_contains(&bm, 3*65536 + 5));
+    EXPECT_TRUE(cbitmap_remove(&bm, 2*65536));
+    EXPECT_FALSE(cbitmap_contains(&bm, 2*65536));
+    cbitmap_add_range(&bm, 0, (uint64_t)UINT32_MAX + 1);
+    EXPECT_EQ((int64_t)UINT32_MAX + 1, cbitmap_count(&bm));
+    cbitmap_drop(&bm);
+    cbits_drop(&ref);
+}
+
+TEST(cbitmap, set_ops) {
+    for (c_range(pass, 2)) {
+        cbitmap a = cbitmap_init(), b = cbitmap_init();
+        cbits ra = cbits_with_size(NBITS, false), rb = cbits_with_size(NBITS, false);
+        fill(&a, &ra, 2);
+        fill(&b, &rb, 3);
+        if (pass == 1) { // same ops on run-length chunks
+            cbitmap_run_optimize(&a);
+            cbitmap_run_optimize(&b);
+            EXPECT_TRUE(equal(&a, &ra));
+        }
+        EXPECT_EQ(cbits_and_count(&ra, &rb), cbitmap_and_count(&a, &b));
+
+        cbitmap c = cbitmap_clone(a);
+        cbits rc = cbits_clone(ra);
+        cbitmap_union(&c, &b);
+        cbits_union(&rc, &rb);
+        EXPECT_TRUE(equal(&c, &rc));
+
+        cbitmap_copy(&c, &a);
+        cbits_copy(&rc, &ra);
+        cbitmap_intersect(&c, &b);
+        cbits_intersect(&rc, &rb);
+        EXPECT_TRUE(equal(&c, &rc));
+
+        cbitmap_copy(&c, &a);
+        cbits_copy(&rc, &ra);
+        cbitmap_difference(&c, &b);
+        cbits_difference(&rc, &rb);
+        EXPECT_TRUE(equal(&c, &rc));
+
+        c_drop(cbitmap, &a, &b, &c);
+        c_drop(cbits, &ra, &rb, &rc);
+    }
+}
+
+TEST(cbitmap, serialize) {
+    cbitmap a = cbitmap_init(), b = cbitmap_init();
+    cbits ra = cbits_with_size(NBITS, false);
+    fill(&a, &ra, 4);
+    for (c_range(pass, 2)) {
+        if (pass == 1) EXPECT_TRUE(cbitmap_run_optimize(&a));
+        isize n = cbitmap_serialized_size(&a);
+        char* buf = (char*)malloc((size_t)n);
+        EXPECT_EQ(n, cbitmap_serialize(&a, buf));
+        EXPECT_TRUE(cbitmap_deserialize(&b, buf, n));
+        EXPECT_TRUE(equal(&b, &ra));
+        EXPECT_FALSE(cbitmap_deserialize(&b, buf, n/2));
+        free(buf);
+    }
+    c_drop(cbitmap, &a, &b);
+    cbits_drop(&ra);
+}
+
+TEST(cbitmap, deserialize_invalid) {
+    cbitmap a = cbitmap_init(), b = cbitmap_init();
+    cbitmap_add(&a, 1); cbitmap_add(&a, 5); cbitmap_add(&a, 9);
+    char buf[64];
+    isize n = cbitmap_serialize(&a, buf);
+    EXPECT_TRUE(cbitmap_deserialize(&b, buf, n));
+    char* vals = buf + n - 6; // one array chunk: three 16-bit little endian values
+    vals[2] = 9;              // duplicate: {1, 9, 9}
+    EXPECT_FALSE(cbitmap_deserialize(&b, buf, n));
+    vals[2] = 0;              // unsorted: {1, 0, 9}
+    EXPECT_FALSE(cbitmap_deserialize(&b, buf, n));
+    EXPECT_EQ(3, cbitmap_count(&b)); // b unchanged on failure
+
+    // run chunk without runs: cardinality 0
+    cbitmap_clear(&a);
+    cbitmap_add_range(&a, 100, 200);
+    EXPECT_TRUE(cbitmap_run_optimize(&a));
+    n = cbitmap_serialize(&a, buf);
+    EXPECT_TRUE(cbitmap_deserialize(&b, buf, n));
+    buf[n - 6] = buf[n - 5] = 0; // number of runs
+    EXPECT_FALSE(cbitmap_deserialize(&b, buf, n - 4));
+
+    // bitset chunk holding too few values for a bitset
+    static char big[16384];
+    cbitmap_clear(&a);
+    for (c_range(i, 5000)) cbitmap_add(&a, (uint32_t)i*2);
+    n = cbitmap_serialize(&a, big);
+    EXPECT_TRUE(cbitmap_deserialize(&b, big, n));
+    EXPECT_EQ(5000, cbitmap_count(&b));
+    memset(big + n - 8192, 0, 625); // clear values 0..4998: 2500 left
+    EXPECT_FALSE(cbitmap_deserialize(&b, big, n));
+    EXPECT_EQ(5000, cbitmap_count(&b));
+    c_drop(cbitmap, &a, &b);
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include "stc/cbits.h"
+#include "ctest.h"
+
+#define i_type Bits300, 300
+#include "stc/cbits.h"
+
+TEST(cbits, bulk_ops) {
+    enum {N = 1000 + 37}; // not a multiple of the word or vector size
+    cbits a = cbits_with_size(N, false), b = cbits_with_size(N, true);
+    for (c_range(i, N)) {
+        if (i % 3 == 0) cbits_set(&a, i);
+        if (i % 5 == 0) cbits_reset(&b, i);
+    }
+    isize n_and = 0, n_or = 0, n_xor = 0, n_andnot = 0;
+    for (c_range(i, N)) {
+        bool x = i % 3 == 0, y = i % 5 != 0;
+        n_and += x & y; n_or += x | y; n_xor += x ^ y; n_andnot += x & !y;
+    }
+    EXPECT_EQ((N + 2)/3, cbits_count(&a));
+    EXPECT_EQ(n_and, cbits_and_count(&a, &b));
+    EXPECT_EQ(n_or, cbits_or_count(&a, &b));
+    EXPECT_EQ(n_xor, cbits_xor_count(&a, &b));
+    EXPECT_EQ(n_andnot, cbits_andnot_count(&a, &b));
+
+    cbits c = cbits_clone(a);
+    cbits_intersect(&c, &b);
+    EXPECT_EQ(n_and, cbits_count(&c));
+    cbits_copy(&c, &a);
+    cbits_union(&c, &b);
+    EXPECT_EQ(n_or, cbits_count(&c));
+    cbits_copy(&c, &a);
+    cbits_xor(&c, &b);
+    EXPECT_EQ(n_xor, cbits_count(&c));
+    cbits_copy(&c, &a);
+    cbits_difference(&c, &b);
+    EXPECT_EQ(n_andnot, cbits_count(&c));
+    for (c_range(i, N))
+        EXPECT_EQ(i % 15 == 0, cbits_test(&c, i));
+
+    c_drop(cbits, &a, &b, &c);
+}
+
+TEST(cbits, each_set_bit) {
+    cbits s = cbits_with_size(777, false);
+    const isize idx[] = {0, 1, 63, 64, 200, 511, 512, 776};
+    for (c_range(i, c_arraylen(idx)))
+        cbits_set(&s, idx[i]);
+
+    int n = 0;
+    for (c_each_set_bit(i, s))
+        EXPECT_EQ(idx[n++], i.index);
+    EXPECT_EQ(c_arraylen(idx), n);
+    EXPECT_EQ(200, cbits_find_next(&s, 65));
+    EXPECT_EQ(c_NPOS, cbits_find_next(&s, 777));
+    EXPECT_EQ(0, cbits_find_next(&s, -100));
+
+    // bits beyond size in the last word are ignored
+    cbits_resize(&s, 700, false);
+    cbits_set_all(&s, false);
+    cbits_set(&s, 699);
+    EXPECT_EQ(699, cbits_find_next(&s, 0));
+    EXPECT_EQ(c_NPOS, cbits_find_next(&s, 700));
+    cbits_drop(&s);
+
+    Bits300 f = Bits300_with_size(300, true);
+    n = 0;
+    for (c_each_set_bit(i, Bits300, f)) ++n;
+    EXPECT_EQ(300, n);
+}
+
+TEST(cbits, rank_select) {
+    enum {N = 3*2048 + 700};
+    cbits s = cbits_with_size(N, false);
+    uint64_t seed = 7;
+    for (c_range(i, N)) { // dense first half, sparse second half
+        seed = seed*6364136223846793005u + 1442695040888963407u;
+        if ((seed >> 40) % (i < N/2 ? 2 : 37) == 0) cbits_set(&s, i);
+    }
+    cbits_set(&s, N - 1);
+    cbits_index ix = cbits_build_index(&s);
+    EXPECT_EQ(cbits_count(&s), ix.count);
+
+    isize rank = 0;
+    for (c_range(i, N + 1)) {
+        EXPECT_EQ(rank, cbits_index_rank(&ix, i));
+        if (i < N && cbits_test(&s, i)) {
+            EXPECT_EQ(i, cbits_index_select(&ix, rank));
+            ++rank;
+        }
+    }
+    EXPECT_EQ(c_NPOS, cbits_index_select(&ix, rank));
+    cbits_index_drop(&ix);
+
+    cbits_set_all(&s, true); // every bit set: many select samples
+    cbits_resize(&s, 20000, true);
+    ix = cbits_build_index(&s);
+    EXPECT_EQ(20000, ix.count);
+    EXPECT_EQ(19999, cbits_index_select(&ix, 19999));
+    EXPECT_EQ(12345, cbits_index_rank(&ix, 12345));
+    cbits_index_drop(&ix);
+    cbits_drop(&s);
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include "stc/ccsv.h"
+#include "stc/random.h"
+#include "ctest.h"
+
+TEST(ccsv, rfc4180) {
+    const char* text = "a,b,c\r\n"
+                       "\"x,y\",\"say \"\"hi\"\"\",\r\n"
+                       "\n"
+                       "\"multi\nline\",,\"\"\n"
+                       "\"ab\"cd,\"open";
+    ccsv rd = ccsv_init(c_sv(text, c_strlen(text)), ',');
+    csview f[4];
+    EXPECT_EQ(3, ccsv_read_row(&rd, f, 4));
+    EXPECT_TRUE(csview_equals(f[0], "a") && csview_equals(f[2], "c"));
+
+    EXPECT_EQ(3, ccsv_read_row(&rd, f, 4));
+    EXPECT_TRUE(csview_equals(f[0], "x,y"));
+    EXPECT_TRUE(csview_equals(f[1], "say \"hi\""));
+    EXPECT_TRUE(csview_is_empty(f[2]));
+    EXPECT_TRUE(f[0].buf > text && f[0].buf < text + c_strlen(text)); // zero-copy
+
+    EXPECT_EQ(0, ccsv_read_row(&rd, f, 4)); // empty line
+
+    EXPECT_EQ(3, ccsv_read_row(&rd, f, 2)); // only two stored
+    EXPECT_TRUE(csview_equals(f[0], "multi\nline"));
+    EXPECT_TRUE(csview_is_empty(f[1]));
+
+    EXPECT_EQ(2, ccsv_read_row(&rd, f, 4)); // lenient: text after a quote, unterminated quote
+    EXPECT_TRUE(csview_equals(f[0], "abcd"));
+    EXPECT_TRUE(csview_equals(f[1], "open"));
+    EXPECT_TRUE(ccsv_at_end(&rd));
+    EXPECT_EQ(-1, ccsv_read_row(&rd, f, 4));
+    ccsv_drop(&rd);
+
+    ccsv tsv = ccsv_init(c_sv("1\t\"2\"\t3\n"), '\t');
+    tsv.quote = 0;
+    EXPECT_EQ(3, ccsv_read_row(&tsv, f, 4));
+    EXPECT_TRUE(csview_equals(f[1], "\"2\""));
+    ccsv_drop(&tsv);
+}
+
+TEST(ccsv, roundtrip) {
+    enum {ROWS = 2000, COLS = 7};
+    static const char* parts[] = {"plain", "", "a,b", "q\"q", "line\nbreak", "\"\"", "a somewhat longer field value", "\r"};
+    crand64 rng = crand64_from(1234);
+    cstr text = cstr_init();
+    int idx[ROWS][COLS];
+    for (c_range(r, ROWS)) {
+        for (c_range(c, COLS)) {
+            const char* s = parts[idx[r][c] = (int)(crand64_uint_r(&rng, 1) % (uint64_t)c_arraylen(parts))];
+            if (c) cstr_append(&text, ",");
+            if (strpbrk(s, ",\"\r\n")) { // quote and escape
+                cstr_append(&text, "\"");
+                for (const char* p = s; *p; ++p)
+                    cstr_append(&text, *p == '"' ? "\"\"" : (char[]){*p, 0});
+                cstr_append(&text, "\"");
+            } else {
+                cstr_append(&text, s);
+            }
+        }
+        cstr_append(&text, r & 1 ? "\r\n" : "\n");
+    }
+    ccsv rd = ccsv_init(cstr_sv(&text), ',');
+    csview f[COLS];
+    isize n, rows = 0;
+    bool same = true;
+    while ((n = ccsv_read_row(&rd, f, COLS)) >= 0) {
+        same &= n == COLS;
+        for (c_range(c, COLS))
+            same &= csview_equals(f[c], parts[idx[rows][c]]);
+        ++rows;
+    }
+    EXPECT_TRUE(same);
+    EXPECT_EQ(ROWS, rows);
+    ccsv_drop(&rd);
+    cstr_drop(&text);
+}
+
+TEST(ccsv, token_any) {
+    const char* expect[] = {"one", "two", "", "three", "four", ""};
+    int n = 0;
+    for (c_token_any(i, " ,;", "one two,;three;four,")) {
+        EXPECT_TRUE(n < 6 && csview_equals(i.token, expect[n]));
+        ++n;
+    }
+    EXPECT_EQ(6, n);
+
+    csview_byteset ws = csview_byteset_from(" \t\n");
+    EXPECT_TRUE(csview_byteset_contains(&ws, '\t') && !csview_byteset_contains(&ws, ','));
+    csview sv = c_sv("\xC3\xA5\tb");
+    isize pos = 0;
+    EXPECT_TRUE(csview_equals(csview_token_any(sv, &ws, &pos), "\xC3\xA5"));
+    EXPECT_EQ(3, pos);
+}
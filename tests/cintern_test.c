@@ -0,0 +1,91 @@
+#include <stdio.h>
+#if defined __unix__ || defined __APPLE__
+  #include <pthread.h>
+#endif
+#include "stc/cintern.h"
+#include "ctest.h"
+
+TEST(cintern, intern) {
+    cintern pool = cintern_init();
+    EXPECT_EQ(0, cintern_size(&pool));
+    EXPECT_EQ(0, cintern_find(&pool, c_sv("alpha")));
+
+    catom a = cintern_intern(&pool, c_sv("alpha"));
+    catom b = cintern_intern(&pool, c_sv("beta"));
+    catom e = cintern_intern(&pool, c_sv(""));
+    EXPECT_TRUE(a != 0 && b != 0 && e != 0);
+    EXPECT_TRUE(a != b && b != e);
+    EXPECT_EQ(a, cintern_intern(&pool, c_sv("alpha")));
+    EXPECT_EQ(b, cintern_find(&pool, c_sv("betaX", 4)));
+    EXPECT_EQ(3, cintern_size(&pool));
+
+    EXPECT_STREQ("alpha", cintern_str(&pool, a));
+    EXPECT_STREQ("", cintern_str(&pool, e));
+    EXPECT_EQ(4, cintern_sv(&pool, b).size);
+    EXPECT_TRUE(cintern_hash(&pool, a) == c_hash_n("alpha", 5));
+    cintern_drop(&pool);
+}
+
+TEST(cintern, grow) {
+    cintern pool = cintern_init();
+    char buf[32];
+    const char* first = NULL;
+    for (c_range(n, 2)) // intern, then find again
+        for (c_range(i, 50000)) {
+            int len = snprintf(buf, sizeof buf, "metric.%d.count", (int)(i*7));
+            catom atom = cintern_intern(&pool, c_sv(buf, len));
+            EXPECT_EQ(i + 1, atom);
+            if (i == 0 && n == 0) first = cintern_str(&pool, atom);
+        }
+    EXPECT_EQ(50000, cintern_size(&pool));
+    EXPECT_STREQ("metric.0.count", first); // strings never move
+    EXPECT_STREQ("metric.349993.count", cintern_str(&pool, 50000));
+
+    // long strings get their own block
+    char big[5000];
+    c_memset(big, 'x', c_sizeof big);
+    catom atom = cintern_intern(&pool, c_sv(big, c_sizeof big));
+    EXPECT_EQ(atom, cintern_find(&pool, c_sv(big, c_sizeof big)));
+    EXPECT_EQ(5000, cintern_sv(&pool, atom).size);
+    cintern_drop(&pool);
+}
+
+#if defined __unix__ || defined __APPLE__
+enum { NTHREADS = 8, NKEYS = 20000 };
+
+struct intern_job { cintern* pool; int id; catom atom[NKEYS]; };
+
+static void* intern_keys(void* arg) {
+    struct intern_job* job = (struct intern_job*)arg;
+    char buf[32];
+    for (c_range(k, NKEYS)) { // each thread starts at a different key, so all keys overlap
+        const int i = (int)(k + job->id*NKEYS/NTHREADS) % NKEYS;
+        const int len = snprintf(buf, sizeof buf, "host-%d.example.com", i);
+        job->atom[i] = cintern_intern(job->pool, c_sv(buf, len));
+    }
+    return NULL;
+}
+
+TEST(cintern, threads) {
+    cintern pool = cintern_init();
+    static struct intern_job job[NTHREADS];
+    pthread_t tid[NTHREADS];
+    for (c_range(t, NTHREADS)) {
+        job[t].pool = &pool, job[t].id = (int)t;
+        ASSERT_TRUE(pthread_create(&tid[t], NULL, intern_keys, &job[t]) == 0);
+    }
+    for (c_range(t, NTHREADS))
+        pthread_join(tid[t], NULL);
+
+    EXPECT_EQ(NKEYS, cintern_size(&pool));
+    char buf[32];
+    int mismatch = 0;
+    for (c_range(i, NKEYS)) {
+        for (c_range(t, 1, NTHREADS)) mismatch += job[t].atom[i] != job[0].atom[i];
+        snprintf(buf, sizeof buf, "host-%d.example.com", (int)i);
+        mismatch += job[0].atom[i] == 0 || strcmp(buf, cintern_str(&pool, job[0].atom[i])) != 0;
+    }
+    EXPECT_EQ(0, mismatch); // every thread got the same atom for each key
+    cintern_drop(&pool);
+}
+#endif
@@ -0,0 +1,80 @@
+#if !defined _POSIX_C_SOURCE
+  #define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined __unix__ || defined __APPLE__
+  #include <unistd.h>
+#endif
+#include "stc/cmapfile.h"
+#include "stc/csview.h"
+#include "ctest.h"
+
+static const char* text = "first line\nsecond,line\n\nfourth line with\ttab\nlast";
+
+// Create a unique temporary file name; the caller removes the file.
+static bool make_tmp_path(char path[260]) {
+#if defined __unix__ || defined __APPLE__
+    strcpy(path, "/tmp/cmapfile_test_XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+#else
+    return tmpnam(path) != NULL;
+#endif
+}
+
+TEST(cmapfile, open) {
+    char path[260];
+    ASSERT_TRUE(make_tmp_path(path));
+    FILE* fp = fopen(path, "wb");
+    fputs(text, fp);
+    fclose(fp);
+
+    cmapfile file = cmapfile_open(path, cmapfile_SEQUENTIAL | cmapfile_POPULATE);
+    EXPECT_TRUE(cmapfile_is_open(&file));
+#if defined __unix__ || defined __APPLE__
+    EXPECT_TRUE(cmapfile_is_mapped(&file));
+#endif
+    EXPECT_TRUE(csview_equals(cmapfile_sv(&file), text));
+    cmapfile_drop(&file);
+    remove(path);
+
+    file = cmapfile_open(path, 0);
+    EXPECT_FALSE(cmapfile_is_open(&file));
+
+    fp = tmpfile();
+    for (c_range(i, 20000)) fprintf(fp, "%d\n", (int)i);
+    rewind(fp);
+    file = cmapfile_from_stream(fp);
+    fclose(fp);
+    EXPECT_FALSE(cmapfile_is_mapped(&file));
+    int n = 0;
+    for (c_each_line(i, file.sv))
+        n += atoi(i.line.buf) == n;
+    EXPECT_EQ(20000, n);
+    cmapfile_drop(&file);
+}
+
+TEST(cmapfile, each_line) {
+    const char* lines[] = {"first line", "second,line", "", "fourth line with\ttab", "last"};
+    int n = 0;
+    for (c_each_line(i, csview_from(text))) {
+        EXPECT_TRUE(csview_equals(i.line, lines[n]));
+        ++n;
+    }
+    EXPECT_EQ(5, n);
+
+    n = 0;
+    for (c_each_line(i, c_sv("a\nb\n"))) ++n; // no empty record after final delimiter
+    EXPECT_EQ(2, n);
+
+    n = 0;
+    for (c_each_record(i, ',', csview_from(text))) {
+        if (n == 1) EXPECT_TRUE(csview_starts_with(i.line, "line\n"));
+        ++n;
+    }
+    EXPECT_EQ(2, n);
+}
@@ -0,0 +1,53 @@
+#include "stc/cstr.h"
+#include "stc/cmultisearcher.h"
+#include "ctest.h"
+
+TEST(cmultisearcher, find_replace) {
+    csview terms[] = {c_sv("he"), c_sv("she"), c_sv("his"), c_sv("hers"), c_sv("")};
+    cmultisearcher ms = cmultisearcher_make(terms, c_arraylen(terms), 0);
+    EXPECT_EQ(5, cmultisearcher_size(&ms));
+
+    // leftmost wins first, then longest
+    csview in = c_sv("ushers and his sheep");
+    cmultisearcher_match m[8];
+    isize n = cmultisearcher_find_all(&ms, in, m, c_arraylen(m));
+    EXPECT_EQ(3, n);
+    EXPECT_EQ(1, m[0].pos); EXPECT_EQ(3, m[0].len); EXPECT_EQ(1, m[0].pattern);
+    EXPECT_EQ(11, m[1].pos); EXPECT_EQ(2, m[1].pattern);
+    EXPECT_EQ(15, m[2].pos); EXPECT_EQ(1, m[2].pattern);
+    EXPECT_FALSE(cmultisearcher_find(&ms, in, 18, m));
+
+    csview repl[] = {c_sv("HE"), c_sv("SHE"), c_sv("HIS"), c_sv("HERS"), c_sv("-")};
+    cstr out = cmultisearcher_replace_all(&ms, in, repl, c_arraylen(repl));
+    EXPECT_STREQ("uSHErs and HIS SHEep", cstr_str(&out));
+    cstr_drop(&out);
+    cmultisearcher_drop(&ms);
+
+    // longest at the same start, case-insensitive
+    csview words[] = {c_sv("pass"), c_sv("password"), c_sv("token")};
+    ms = cmultisearcher_make(words, c_arraylen(words), cmultisearcher_ICASE);
+    out = cmultisearcher_replace_all(&ms, c_sv("user=bob Password=x1 TOKEN=abc pass"), &c_sv("***"), 1);
+    EXPECT_STREQ("user=bob ***=x1 ***=abc ***", cstr_str(&out));
+    cstr_drop(&out);
+    cmultisearcher_drop(&ms);
+}
+
+TEST(cmultisearcher, stream) {
+    csview terms[] = {c_sv("abc"), c_sv("bc"), c_sv("cab")};
+    cmultisearcher ms = cmultisearcher_make(terms, c_arraylen(terms), 0);
+    const char* chunks[] = {"xa", "bcab", "c"};
+    cmultisearcher_stream st = cmultisearcher_stream_init(&ms);
+    cmultisearcher_match m;
+    isize pos[8], pat[8], n = 0;
+    for (c_range(i, c_arraylen(chunks))) {
+        csview chunk = c_sv(chunks[i], c_strlen(chunks[i]));
+        while (cmultisearcher_stream_next(&st, chunk, &m))
+            pos[n] = m.pos, pat[n++] = m.pattern;
+    }
+    // "xabcabc": abc@1, cab@3, abc@4 (overlapping, across chunk borders)
+    EXPECT_EQ(3, n);
+    EXPECT_EQ(1, pos[0]); EXPECT_EQ(0, pat[0]);
+    EXPECT_EQ(3, pos[1]); EXPECT_EQ(2, pat[1]);
+    EXPECT_EQ(4, pos[2]); EXPECT_EQ(0, pat[2]);
+    cmultisearcher_drop(&ms);
+}
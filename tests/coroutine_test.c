@@ -0,0 +1,67 @@
+// The profiled fiber runtime is compiled into this test, which is therefore built as a
+// separate program, not linked with the (unprofiled) stc library.
+#if !defined _POSIX_C_SOURCE
+  #define _POSIX_C_SOURCE 200809L // clock_gettime(CLOCK_MONOTONIC)
+#endif
+#define STC_CCO_PROFILE
+#define STC_CCO_PROFILE_MAX 8
+#define i_implement
+#include "stc/coroutine.h"
+#include "ctest.h"
+
+cco_task_struct (Counter) { Counter_state cco; int n; };
+
+static int Counter(struct Counter* self, cco_fiber* fb) {
+    (void)fb;
+    cco_routine (self) {
+        while (self->n > 0) {
+            --self->n;
+            cco_yield;
+        }
+    }
+    return 0;
+}
+
+#define DEF_TASK(Name) \
+    static int Name(struct Counter* self, cco_fiber* fb) { return Counter(self, fb); }
+DEF_TASK(Counter2)
+DEF_TASK(Dummy1) DEF_TASK(Dummy2) DEF_TASK(Dummy3) DEF_TASK(Dummy4)
+DEF_TASK(Dummy5) DEF_TASK(Dummy6) DEF_TASK(Dummy7) DEF_TASK(Dummy8)
+
+static const cco_profile_entry* find_entry(const char* name) {
+    int n;
+    const cco_profile_entry* tab = cco_profile_table(&n);
+    for (c_range(i, n))
+        if (tab[i].name && !strcmp(tab[i].name, name)) return &tab[i];
+    return NULL;
+}
+
+TEST(coroutine, profile) {
+    cco_profile_name(Counter, "Counter");
+    struct Counter c = {{Counter}, 5};
+    cco_run_task(&c) {}
+    const cco_profile_entry* e = find_entry("Counter");
+    EXPECT_TRUE(e != NULL);
+    if (e) {
+        EXPECT_EQ(6, e->resumes); // 5 yields and the final return
+        EXPECT_EQ(0, e->awaits);
+        EXPECT_TRUE(e->max_ns <= e->total_ns);
+    }
+
+    // fill the table: the remaining task functions are counted as "(other)"
+    cco_profile_name(Dummy1, "dummy1"); cco_profile_name(Dummy2, "dummy2");
+    cco_profile_name(Dummy3, "dummy3"); cco_profile_name(Dummy4, "dummy4");
+    cco_profile_name(Dummy5, "dummy5"); cco_profile_name(Dummy6, "dummy6");
+    cco_profile_name(Dummy7, "dummy7"); cco_profile_name(Dummy8, "dummy8");
+    cco_profile_reset();
+    struct Counter d = {{Counter}, 2}, d2 = {{Counter2}, 3};
+    cco_run_task(&d) {}
+    cco_run_task(&d2) {}
+    int n;
+    cco_profile_table(&n);
+    EXPECT_EQ(STC_CCO_PROFILE_MAX, n); // STC_CCO_PROFILE_MAX - 1 functions and "(other)"
+    e = find_entry("Counter");
+    EXPECT_TRUE(e != NULL && e->resumes == 3);
+    e = find_entry("(other)");
+    EXPECT_TRUE(e != NULL && e->resumes == 4);
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include "stc/crope.h"
+#include "ctest.h"
+
+TEST(crope, edit) {
+    crope r = crope_from("Hello world!");
+    crope_insert(&r, 5, ",");
+    crope_replace_sv(&r, 7, 5, c_sv("wørld"));
+    crope_push_sv(&r, c_sv(" Bye."));
+    EXPECT_EQ(19, crope_size(&r));
+    EXPECT_EQ(18, crope_u8_size(&r));
+    EXPECT_EQ('w', crope_at(&r, 7));
+
+    cstr s = crope_to_cstr(&r);
+    EXPECT_STREQ("Hello, wørld! Bye.", cstr_str(&s));
+    cstr_take(&s, crope_u8_substr(&r, 7, 5));
+    EXPECT_STREQ("wørld", cstr_str(&s));
+    cstr_take(&s, crope_u8_substr(&r, 14, 100)); // clamped at end
+    EXPECT_STREQ("Bye.", cstr_str(&s));
+    EXPECT_EQ(10, crope_u8_to_pos(&r, 9));
+
+    crope c = crope_clone(r);
+    crope_erase(&r, 0, 7);
+    crope_erase(&r, 6, 100);
+    cstr_take(&s, crope_to_cstr(&r));
+    EXPECT_STREQ("wørld", cstr_str(&s));
+    cstr_take(&s, crope_to_cstr(&c));
+    EXPECT_STREQ("Hello, wørld! Bye.", cstr_str(&s));
+
+    crope_clear(&r);
+    EXPECT_TRUE(crope_is_empty(&r));
+    EXPECT_EQ(0, crope_u8_size(&r));
+    cstr_drop(&s);
+    c_drop(crope, &r, &c);
+}
+
+TEST(crope, chunks) {
+    enum {N = 100000};
+    cstr s = cstr_init();
+    for (c_range(i, N))
+        cstr_append(&s, i % 7 ? "ab" : "€");
+    crope r = crope_from_sv(cstr_sv(&s));
+
+    // interleave edits on the rope and the reference string
+    for (c_range(i, 2000)) {
+        isize pos = (i*7919) % (cstr_size(&s) + 1);
+        while ((cstr_str(&s)[pos] & 0xC0) == 0x80) ++pos;
+        if (i % 3 == 0) {
+            isize len = (i*31) % 300;
+            len = len < cstr_size(&s) - pos ? len : cstr_size(&s) - pos;
+            while ((cstr_str(&s)[pos + len] & 0xC0) == 0x80) ++len;
+            crope_erase(&r, pos, len);
+            cstr_erase(&s, pos, len);
+        } else {
+            const char* ins = i % 5 ? "åx" : "a chunk sized insert: ..........................................";
+            crope_insert(&r, pos, ins);
+            cstr_insert(&s, pos, ins);
+        }
+    }
+    EXPECT_EQ(cstr_size(&s), crope_size(&r));
+    EXPECT_EQ(utf8_count(cstr_str(&s)), crope_u8_size(&r));
+
+    isize pos = 0, nchunks = 0;
+    bool same = true;
+    for (c_each(i, crope, r)) {
+        EXPECT_TRUE(i.ref->size > 0 && i.ref->size <= crope_CHUNK);
+        same &= c_memcmp(i.ref->buf, cstr_str(&s) + pos, i.ref->size) == 0;
+        pos += i.ref->size, ++nchunks;
+    }
+    EXPECT_TRUE(same);
+    EXPECT_EQ(cstr_size(&s), pos);
+    EXPECT_TRUE(nchunks < cstr_size(&s)/256);
+
+    isize offset;
+    crope_iter it = crope_find_chunk(&r, 12345, &offset);
+    EXPECT_EQ(cstr_str(&s)[12345], it.ref->buf[offset]);
+    cstr sub = crope_substr(&r, 5000, 3000);
+    EXPECT_TRUE(cstr_equals_sv(&sub, c_sv(cstr_str(&s) + 5000, 3000)));
+    for (c_range(u8pos, 0, crope_u8_size(&r), 997))
+        EXPECT_EQ(utf8_to_index(cstr_str(&s), u8pos), crope_u8_to_pos(&r, u8pos));
+
+    c_drop(cstr, &s, &sub);
+    crope_drop(&r);
+}
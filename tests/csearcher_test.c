@@ -0,0 +1,52 @@
+#include "stc/cstr.h"
+#include "stc/csearcher.h"
+#include "ctest.h"
+
+static const char* naive_find(csview hay, csview needle) {
+    for (isize i = 0; i + needle.size <= hay.size; ++i)
+        if (!c_memcmp(hay.buf + i, needle.buf, needle.size)) return hay.buf + i;
+    return NULL;
+}
+
+TEST(csearcher, find) {
+    const char* hay = "The quick brown fox jumps over the lazy dog. The quick brown fox.";
+    csview h = c_sv(hay, c_strlen(hay));
+    csearcher s = csearcher_from(c_sv("brown fox"));
+    EXPECT_EQ(10, csearcher_find(&s, h) - hay);
+    EXPECT_EQ(55, csearcher_find(&s, c_sv(hay + 11, h.size - 11)) - hay);
+    EXPECT_TRUE(csearcher_find(&s, c_sv(hay, 18)) == NULL);
+
+    s = csearcher_from(c_sv(""));
+    EXPECT_TRUE(csearcher_find(&s, h) == hay);
+    s = csearcher_from(c_sv("."));
+    EXPECT_EQ(43, csearcher_find(&s, h) - hay);
+    EXPECT_EQ(10, c_strsearch(hay, h.size, "brown", 5) - hay);
+
+    // compare with a naive search over small alphabets, with long and periodic needles
+    uint64_t seed = 12345;
+    char text[1200], pat[80];
+    for (c_range(n, 3000)) {
+        const int alpha = 1 + n % 3, tlen = (int)(n % 1100), plen = 1 + (n*7) % 79;
+        for (c_range(i, tlen)) text[i] = (char)('a' + (seed = seed*6364136223846793005u + 1) % (uint64_t)alpha);
+        for (c_range(i, plen)) pat[i] = (char)('a' + (seed = seed*6364136223846793005u + 1) % (uint64_t)alpha);
+        if (n % 2 && tlen > plen) c_memcpy(pat, text + (seed >> 40) % (uint64_t)(tlen - plen), plen);
+        csview t = c_sv(text, tlen), p = c_sv(pat, plen);
+        s = csearcher_from(p);
+        EXPECT_TRUE(csearcher_find(&s, t) == naive_find(t, p));
+        EXPECT_TRUE(c_strnstrn(text, tlen, pat, plen) == naive_find(t, p));
+    }
+}
+
+TEST(csearcher, cstr_replace) {
+    cstr s = cstr_from("one fish, two fish, red fish, blue fish");
+    EXPECT_EQ(4, cstr_find_sv(&s, c_sv("fish,")));
+    EXPECT_EQ(c_NPOS, cstr_find_sv(&s, c_sv("green")));
+    cstr_replace(&s, "fish", "bird");
+    EXPECT_STREQ("one bird, two bird, red bird, blue bird", cstr_str(&s));
+    cstr_take(&s, cstr_from_replace(cstr_sv(&s), c_sv("bird"), c_sv("cat"), 2));
+    EXPECT_STREQ("one cat, two cat, red bird, blue bird", cstr_str(&s));
+    // needle long enough for the searcher
+    cstr_take(&s, cstr_from_replace(cstr_sv(&s), c_sv("red bird, blue bird"), c_sv("..."), 0));
+    EXPECT_STREQ("one cat, two cat, ...", cstr_str(&s));
+    cstr_drop(&s);
+}
@@ -1,4 +1,11 @@
+#if !defined _POSIX_C_SOURCE
+  #define _POSIX_C_SOURCE 200809L
+#endif
 #include <stdio.h>
+#include <string.h>
+#if defined __unix__ || defined __APPLE__
+  #include <unistd.h>
+#endif
 #include "stc/cspan.h"
 #include "ctest.h"
 
@@ -108,6 +115,205 @@ TEST(cspan, equality) {
 }
 
 
+TEST(cspan, elementwise) {
+    int array[4*5*6] = {0}, out[4*5*6] = {0};
+    Span3 m = cspan_md(array, 4, 5, 6);
+    int nblocks = 0;
+
+    for (cspan_each_block(b, Span3, m)) {
+        EXPECT_EQ(4*5*6, b.size);
+        EXPECT_EQ(1, b.stride);
+        ++nblocks;
+    }
+    EXPECT_EQ(1, nblocks);
+
+    for (c_each(i, Span3, m))
+        *i.ref = (int)(i.ref - array);
+
+    // sliced in outer dims: trailing contiguous dims are merged
+    Span3 s = cspan_slice(&m, Span3, {1,3}, {1,4}, {c_ALL});
+    nblocks = 0;
+    for (cspan_each_block(b, Span3, s)) {
+        EXPECT_EQ(3*6, b.size);
+        EXPECT_EQ(*cspan_at(&s, nblocks, 0, 0), *b.ref);
+        ++nblocks;
+    }
+    EXPECT_EQ(2, nblocks);
+
+    // sliced in inner dim: strided runs
+    Span3 s2 = cspan_slice(&m, Span3, {c_ALL}, {c_ALL}, {1,5,2});
+    nblocks = 0;
+    for (cspan_each_block(b, Span3, s2)) {
+        EXPECT_EQ(2, b.size);
+        EXPECT_EQ(2, b.stride);
+        ++nblocks;
+    }
+    EXPECT_EQ(4*5, nblocks);
+
+    // copy transposed (strided) view to a row-major span
+    Span3 t = cspan_md(out, 6, 5, 4);
+    Span3 mt = m;
+    cspan_transpose(&mt);
+    cspan_copy(Span3, &t, &mt);
+    EXPECT_TRUE(Span3_equals(t, mt));
+
+    cspan_apply(Span3, &s2, *value = -*value);
+    for (c_each(i, Span3, m))
+        EXPECT_EQ((int)(i.ref - array)*(i.pos[2] == 1 || i.pos[2] == 3 ? -1 : 1), *i.ref);
+
+    cspan_fill(Span3, &s, 7);
+    for (c_each(i, Span3, s)) EXPECT_EQ(7, *i.ref);
+    EXPECT_EQ(0, *cspan_at(&m, 0, 0, 0));
+    EXPECT_EQ(119, *cspan_at(&m, 3, 4, 5));
+}
+
+
+using_cspan(Matd, double, 2);
+
+TEST(cspan, matmul) {
+    enum {M = 37, K = 300, N = 45};
+    static double a[M*K], b[K*N], c[M*N], ref[M*N];
+    for (c_range(i, M*K)) a[i] = (double)(i % 7) - 3.0;
+    for (c_range(i, K*N)) b[i] = (double)(i % 5)*0.5;
+
+    Matd A = cspan_md(a, M, K), Bt = cspan_md_layout(c_COLMAJOR, b, K, N);
+    Matd C = cspan_md(c, M, N), R = cspan_md(ref, M, N);
+    for (c_range(i, M)) for (c_range(j, N)) {
+        double sum = 0;
+        for (c_range(k, K)) sum += *cspan_at(&A, i, k) * *cspan_at(&Bt, k, j);
+        *cspan_at(&R, i, j) = sum;
+    }
+    cspan_matmul(&A, &Bt, &C);
+    for (c_range(i, M*N)) EXPECT_DOUBLE_EQ(ref[i], c[i]);
+
+    // strided output view: C^T += (A*B)^T
+    Matd Ct = cspan_md(c, N, M);
+    cspan_transpose(&Ct);
+    cspan_matmul_add(&A, &Bt, &Ct);
+    for (c_range(i, M)) for (c_range(j, N))
+        EXPECT_DOUBLE_EQ(ref[i*N + j] + ref[j*M + i], *cspan_at(&Ct, i, j));
+}
+
+
+TEST(cspan, reduce) {
+    enum {D0 = 3, D1 = 4, D2 = 21};
+    int data[D0*D1*D2], sc[D0*D1*D2];
+    int o01[D0*D1], o02[D0*D2], o12[D1*D2];
+    for (c_range(i, D0*D1*D2)) data[i] = (int)((i*7919) % 101) - 50;
+
+    Span3 m = cspan_md(data, D0, D1, D2);
+    Span2 s2 = cspan_md(o01, D0, D1), s1 = cspan_md(o02, D0, D2), s0 = cspan_md(o12, D1, D2);
+
+    cspan_reduce(Span3, &m, 2, &s2, cspan_op_sum);
+    cspan_reduce(Span3, &m, 1, &s1, cspan_op_max);
+    cspan_reduce(Span3, &m, 0, &s0, cspan_op_min);
+    for (c_range(i, D0)) for (c_range(j, D1)) {
+        int sum = 0;
+        for (c_range(k, D2)) sum += *cspan_at(&m, i, j, k);
+        EXPECT_EQ(sum, *cspan_at(&s2, i, j));
+    }
+    for (c_range(i, D0)) for (c_range(k, D2)) {
+        int mx = *cspan_at(&m, i, 0, k);
+        for (c_range(j, D1)) mx = cspan_op_max(mx, *cspan_at(&m, i, j, k));
+        EXPECT_EQ(mx, *cspan_at(&s1, i, k));
+    }
+    for (c_range(j, D1)) for (c_range(k, D2)) {
+        int mn = *cspan_at(&m, 0, j, k);
+        for (c_range(i, D0)) mn = cspan_op_min(mn, *cspan_at(&m, i, j, k));
+        EXPECT_EQ(mn, *cspan_at(&s0, j, k));
+    }
+
+    cspan_argmax(Span3, &m, 1, &s1);
+    for (c_range(i, D0)) for (c_range(k, D2)) {
+        int best = *cspan_at(&m, i, 0, k);
+        for (c_range(j, D1)) if (*cspan_at(&m, i, j, k) > best) best = *cspan_at(&m, i, j, k);
+        EXPECT_EQ(best, *cspan_at(&m, i, *cspan_at(&s1, i, k), k));
+    }
+
+    Span3 s = cspan_md(sc, D0, D1, D2);
+    for (c_range(ax, 3)) {
+        cspan_scan(Span3, &m, (int)ax, &s, cspan_op_sum);
+        EXPECT_EQ(*cspan_at(&m, 0, 0, 0), sc[0]);
+        for (c_range(i, D0)) for (c_range(j, D1)) for (c_range(k, D2)) {
+            int prev = ax == 0 ? (i ? *cspan_at(&s, i - 1, j, k) : 0)
+                     : ax == 1 ? (j ? *cspan_at(&s, i, j - 1, k) : 0)
+                               : (k ? *cspan_at(&s, i, j, k - 1) : 0);
+            EXPECT_EQ(prev + *cspan_at(&m, i, j, k), *cspan_at(&s, i, j, k));
+        }
+    }
+
+    // empty reduction axis: output is left unchanged
+    Span3 e = cspan_md(data, D0, 0, D2);
+    for (c_range(i, D0*D2)) o02[i] = 12345;
+    cspan_reduce(Span3, &e, 1, &s1, cspan_op_sum);
+    cspan_argmax(Span3, &e, 1, &s1);
+    for (c_range(i, D0*D2)) EXPECT_EQ(12345, o02[i]);
+}
+
+
+
+// Create a unique temporary file name; the caller removes the file.
+static bool make_tmp_path(char path[260]) {
+#if defined __unix__ || defined __APPLE__
+    strcpy(path, "/tmp/cspan_test_XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+#else
+    return tmpnam(path) != NULL;
+#endif
+}
+
+TEST(cspan, npy) {
+    enum {D0 = 3, D1 = 4, D2 = 5};
+    int data[D0*D1*D2];
+    char path[260];
+    ASSERT_TRUE(make_tmp_path(path));
+    for (c_range(i, D0*D1*D2)) data[i] = (int)i*3 - 7;
+    Span3 m = cspan_md(data, D0, D1, D2);
+
+    // strided view is written in C order
+    Span3 t = m;
+    cspan_transpose(&t);
+    EXPECT_TRUE(cspan_npy_save(path, &t));
+    cspan_npy npy;
+    EXPECT_TRUE(cspan_npy_load(&npy, path));
+    EXPECT_EQ(3, npy.rank);
+    EXPECT_EQ(D0*D1*D2, npy.size);
+    Span3 u;
+    Matd wrong;
+    EXPECT_TRUE(!cspan_npy_get(&npy, &wrong));
+    EXPECT_TRUE(cspan_npy_get(&npy, &u));
+    EXPECT_TRUE(Span3_equals(t, u));
+    cspan_npy_drop(&npy);
+
+    // streaming writer, read back through mmap
+    cspan_npy_writer w;
+    EXPECT_TRUE(cspan_npy_writer_open(&w, path, int, D0, D1, D2));
+    for (c_range(i, D0)) {
+        Span2 sub = cspan_submd3(&m, i);
+        EXPECT_TRUE(cspan_npy_write(&w, &sub));
+    }
+    EXPECT_TRUE(cspan_npy_writer_close(&w));
+    EXPECT_TRUE(cspan_npy_mmap(&npy, path));
+    EXPECT_TRUE(cspan_npy_get(&npy, &u));
+    EXPECT_TRUE(Span3_equals(m, u));
+    cspan_npy_drop(&npy);
+
+    // hostile header: element count overflows
+    static const char dict[] = "{'descr': '<i4', 'fortran_order': False, "
+                               "'shape': (2147483647, 2147483647, 2147483647), }\n";
+    FILE* fp = fopen(path, "wb");
+    fwrite("\x93NUMPY\x01\x00", 1, 8, fp);
+    fputc((int)sizeof dict - 1, fp); fputc(0, fp);
+    fwrite(dict, 1, sizeof dict - 1, fp);
+    fclose(fp);
+    EXPECT_TRUE(!cspan_npy_load(&npy, path));
+    EXPECT_TRUE(!cspan_npy_mmap(&npy, path));
+    remove(path);
+}
+
 #define i_type Tiles, Span3
 #include "stc/stack.h"
 
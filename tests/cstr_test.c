@@ -0,0 +1,168 @@
+#include "stc/cstr.h"
+#include "stc/csview.h"
+#include "stc/zsview.h"
+#include "ctest.h"
+
+// every 10th line ends with '\0' instead of '\n'
+static FILE* make_file(int nlines, isize longlen) {
+    FILE* fp = tmpfile();
+    for (c_range(i, nlines)) {
+        if (i == nlines/2)
+            for (c_range(longlen)) fputc('#', fp); // spans several read blocks
+        else
+            fprintf(fp, "line %d", (int)i);
+        fputc(i % 10 == 5 ? '\0' : '\n', fp);
+    }
+    fputs("last", fp); // no final newline
+    rewind(fp);
+    return fp;
+}
+
+TEST(cstr, getline) {
+    FILE* fp = make_file(1000, 3*cstr_lines_BLOCK);
+    cstr line = cstr_init();
+    int n = 0;
+    while (cstr_getline(&line, fp)) {
+        if (n == 450) EXPECT_EQ(3*cstr_lines_BLOCK, cstr_size(&line));
+        else if (n == 5) EXPECT_EQ(13, cstr_size(&line)); // "line 5\0line 6"
+        else if (n == 900) EXPECT_STREQ("last", cstr_str(&line));
+        ++n;
+    }
+    EXPECT_EQ(1000 - 100 + 1, n);
+
+    rewind(fp);
+    EXPECT_TRUE(cstr_getdelim(&line, ' ', fp));
+    EXPECT_STREQ("line", cstr_str(&line));
+    cstr_drop(&line);
+    fclose(fp);
+}
+
+TEST(cstr, lines) {
+    FILE* fp = make_file(1000, 3*cstr_lines_BLOCK);
+    cstr_lines rd = cstr_lines_from(fp, '\n');
+    cstr ref = cstr_init();
+    csview line;
+    int n = 0;
+    while (cstr_lines_next(&rd, &line)) {
+        if (n == 450) EXPECT_EQ(3*cstr_lines_BLOCK, line.size);
+        ++n;
+    }
+    EXPECT_EQ(1000 - 100 + 1, n);
+    EXPECT_TRUE(csview_equals(line, "last"));
+    cstr_lines_drop(&rd);
+
+    // compare with cstr_getdelim using another delimiter
+    rewind(fp);
+    rd = cstr_lines_from(fp, 'e');
+    FILE* fp2 = make_file(1000, 3*cstr_lines_BLOCK);
+    n = 0;
+    while (cstr_lines_next(&rd, &line)) {
+        EXPECT_TRUE(cstr_getdelim(&ref, 'e', fp2));
+        EXPECT_TRUE(csview_equals_sv(line, cstr_sv(&ref)));
+        ++n;
+    }
+    EXPECT_FALSE(cstr_getdelim(&ref, 'e', fp2));
+    EXPECT_EQ(1000, n);
+    cstr_lines_drop(&rd);
+    cstr_drop(&ref);
+    fclose(fp2);
+    fclose(fp);
+}
+
+TEST(cstr, numbers) {
+    cstr s = cstr_init();
+    const double vals[] = {0.0, -0.0, 0.1, 1.0/3, 100, 1e16, 1e17, -2.5e-7, 0.0001, 5e-324, 1.7976931348623157e308};
+    const char* strs[] = {"0", "-0", "0.1", "0.3333333333333333", "100", "10000000000000000", "1e+17",
+                          "-2.5e-07", "0.0001", "5e-324", "1.7976931348623157e+308"};
+    for (c_range(i, c_arraylen(vals))) {
+        cstr_clear(&s);
+        EXPECT_EQ(c_strlen(strs[i]), cstr_append_double(&s, vals[i]));
+        EXPECT_STREQ(strs[i], cstr_str(&s));
+    }
+    cstr_clear(&s);
+    cstr_append_int(&s, INT64_MIN); cstr_push(&s, " ");
+    cstr_append_int(&s, 0); cstr_push(&s, " ");
+    cstr_append_uint(&s, UINT64_MAX);
+    EXPECT_STREQ("-9223372036854775808 0 18446744073709551615", cstr_str(&s));
+
+    // round-trip
+    uint64_t seed = 12345, bits;
+    bool same = true;
+    for (c_range(i, 100000)) {
+        double d, e = 0;
+        bits = (seed = seed*6364136223846793005u + 1442695040888963407u) >> (i % 3)*20;
+        c_memcpy(&d, &bits, 8);
+        if (d != d) continue; // nan
+        cstr_clear(&s);
+        cstr_append_double(&s, d);
+        csview_parse_result r = csview_parse_double(cstr_sv(&s), &e);
+        same &= r.ec == 0 && r.size == cstr_size(&s) && c_memcmp(&d, &e, 8) == 0;
+    }
+    EXPECT_TRUE(same);
+    cstr_drop(&s);
+}
+
+TEST(cstr, parse_numbers) {
+    double d = -1;
+    csview_parse_result r = csview_parse_double(c_sv("3.25e2ms"), &d);
+    EXPECT_EQ(6, r.size); EXPECT_EQ(0, r.ec); EXPECT_EQ(325.0, d);
+    r = csview_parse_double(c_sv("-.5e"), &d); // exponent without digits is not parsed
+    EXPECT_EQ(3, r.size); EXPECT_EQ(-0.5, d);
+    r = csview_parse_double(c_sv("0.1000000000000000055511151231257827"), &d);
+    EXPECT_EQ(0, r.ec); EXPECT_EQ(0.1, d);
+    r = csview_parse_double(c_sv("-Infinity"), &d);
+    EXPECT_EQ(9, r.size); EXPECT_TRUE(d < -1e308);
+    r = csview_parse_double(c_sv("1e999"), &d);
+    EXPECT_EQ(5, r.size); EXPECT_EQ(ERANGE, r.ec); EXPECT_TRUE(d < -1e308); // unchanged
+    r = csview_parse_double(c_sv(" 1"), &d);
+    EXPECT_EQ(0, r.size); EXPECT_EQ(EINVAL, r.ec);
+
+    int64_t i = 0;
+    uint64_t u = 0;
+    r = csview_parse_i64(c_sv("-9223372036854775808,"), &i);
+    EXPECT_EQ(20, r.size); EXPECT_EQ(0, r.ec); EXPECT_TRUE(i == INT64_MIN);
+    r = csview_parse_i64(c_sv("9223372036854775808"), &i);
+    EXPECT_EQ(19, r.size); EXPECT_EQ(ERANGE, r.ec); EXPECT_TRUE(i == INT64_MIN);
+    r = csview_parse_u64(c_sv("18446744073709551615"), &u);
+    EXPECT_EQ(0, r.ec); EXPECT_TRUE(u == UINT64_MAX);
+    r = csview_parse_u64(c_sv("-1"), &u);
+    EXPECT_EQ(EINVAL, r.ec);
+}
+
+TEST(cstr, icase) {
+    // ASCII runs longer than a block, with non-ASCII and differing bytes at every position
+    const char* base = "Content-Type: Text/HTML; charset=UTF-8; q=0.9 ";
+    cstr s = cstr_init();
+    for (c_range(i, 40)) cstr_append(&s, base);
+    cstr up = cstr_toupper_sv(cstr_sv(&s)), lo = cstr_tolower_sv(cstr_sv(&s));
+    EXPECT_TRUE(cstr_ieq(&s, &up) && cstr_ieq(&up, &lo));
+    EXPECT_STREQ("CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8; Q=0.9 ", cstr_str(&up) + cstr_size(&up) - c_strlen(base));
+    EXPECT_TRUE(cstr_istarts_with(&s, "content-type: text/html; CHARSET") && cstr_iends_with(&s, "UTF-8; Q=0.9 "));
+
+    bool ok = true;
+    for (c_range(i, 100)) {
+        cstr t = cstr_clone(lo);
+        cstr_data(&t)[i] = '~';
+        ok &= cstr_icmp(&t, &up) > 0 && cstr_icmp(&up, &t) < 0 && !cstr_ieq(&t, &s);
+        cstr_replace_at(&t, i, 1, "Ø");
+        ok &= cstr_icmp(&t, &up) > 0; // 'ø' > 'c'
+        cstr_take(&t, cstr_tolower_sv(cstr_sv(&t)));
+        ok &= cstr_u8_valid(&t) && strstr(cstr_str(&t), "ø") == cstr_str(&t) + i;
+        cstr_drop(&t);
+    }
+    EXPECT_TRUE(ok);
+
+    // case mapping changes the byte length of some codepoints
+    EXPECT_TRUE(csview_iequals(c_sv("ſtraße ſtraße ſtraße"), "STRASSE") == false);
+    EXPECT_TRUE(utf8_icompare(c_sv("Sx"), c_sv("ſ")) > 0); // same size, but "ſ" is a prefix
+    EXPECT_EQ(0, utf8_icompare(c_sv("ſTRASSE-ſTRASSE-X"), c_sv("strasse-STRASSE-x")));
+    EXPECT_TRUE(zsview_istarts_with(zsview_from("Accept-Encoding: gzip"), "ACCEPT-ENCODING"));
+
+    // prefix tests compare only the prefix length of the string
+    cstr h = cstr_lit("Hello World");
+    EXPECT_TRUE(cstr_istarts_with(&h, "hELLO") && csview_istarts_with(cstr_sv(&h), "HELLO w"));
+    EXPECT_FALSE(cstr_istarts_with(&h, "hello world!") || csview_istarts_with(cstr_sv(&h), "world"));
+    EXPECT_TRUE(zsview_istarts_with(cstr_zv(&h), "") && !zsview_istarts_with(cstr_zv(&h), "HELP"));
+    cstr_drop(&h);
+    c_drop(cstr, &s, &up, &lo);
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include "stc/cstrvec.h"
+#include "ctest.h"
+
+TEST(cstrvec, push_sort) {
+    cstrvec v = cstrvec_init();
+    const char* words[] = {"pear", "apple", "fig", "", "banana", "apple pie", "applesauce"};
+    for (c_range(i, c_arraylen(words)))
+        cstrvec_emplace(&v, words[i]);
+    char big[300];
+    c_memset(big, 'z', c_sizeof big);
+    csview sv = cstrvec_push(&v, c_sv(big, c_sizeof big)); // two byte length prefix
+    EXPECT_EQ(300, sv.size);
+    EXPECT_EQ(8, cstrvec_size(&v));
+    EXPECT_STREQ("fig", cstrvec_str(&v, 2));
+    EXPECT_EQ(0, cstrvec_at(&v, 3).size);
+
+    cstrvec_sort(&v);
+    const char* sorted[] = {"", "apple", "apple pie", "applesauce", "banana", "fig", "pear"};
+    for (c_range(i, c_arraylen(sorted)))
+        EXPECT_STREQ(sorted[i], cstrvec_str(&v, i));
+    EXPECT_TRUE(cstrvec_eq_at(&v, 7, c_sv(big, c_sizeof big)));
+    for (c_range(i, cstrvec_size(&v) - 1))
+        EXPECT_TRUE(cstrvec_cmp_at(&v, i, i + 1) < 0);
+
+    EXPECT_EQ(5, cstrvec_binary_search(&v, c_sv("fig")));
+    EXPECT_EQ(c_NPOS, cstrvec_binary_search(&v, c_sv("grape")));
+    EXPECT_EQ(6, cstrvec_lower_bound(&v, c_sv("grape")));
+    EXPECT_EQ(7, cstrvec_lower_bound(&v, c_sv("zzz")));
+    EXPECT_EQ(c_NPOS, cstrvec_lower_bound(&v, c_sv("zzz~")));
+
+    cstr s = cstrvec_cstr_at(&v, 4);
+    EXPECT_STREQ("banana", cstr_str(&s));
+    cstrvec_push_cstr(&v, &s);
+    cstrvec_push(&v, cstrvec_at(&v, 1)); // element of itself
+    EXPECT_STREQ("apple", cstrvec_str(&v, 9));
+    cstr_drop(&s);
+
+    cstrvec_erase_n(&v, 0, 2);
+    cstrvec_pop(&v);
+    EXPECT_EQ(7, cstrvec_size(&v));
+    EXPECT_STREQ("banana", cstrvec_str(&v, 6));
+    isize used = v.chars_size;
+    cstrvec_compact(&v);
+    EXPECT_TRUE(v.chars_size < used);
+    EXPECT_STREQ("apple pie", cstrvec_str(&v, 0));
+    EXPECT_STREQ("banana", cstrvec_str(&v, 6));
+
+    cstrvec w = cstrvec_clone(v);
+    EXPECT_EQ(cstrvec_size(&v), cstrvec_size(&w));
+    EXPECT_TRUE(cstrvec_eq_at(&w, 2, cstrvec_at(&v, 2)));
+    c_drop(cstrvec, &v, &w);
+}
+
+TEST(cstrvec, files) {
+    cstrvec v = cstrvec_init(), w = cstrvec_init();
+    char buf[32];
+    for (c_range(i, 10000)) {
+        int n = snprintf(buf, sizeof buf, "row %d", (int)((i*7919) % 10000));
+        cstrvec_push(&v, c_sv(buf, n));
+    }
+    cstrvec_sort(&v); // save writes in element order
+
+    FILE* fp = tmpfile();
+    EXPECT_TRUE(cstrvec_save(&v, fp));
+    rewind(fp);
+    EXPECT_TRUE(cstrvec_load(&w, fp));
+    EXPECT_EQ(10000, cstrvec_size(&w));
+    for (c_range(i, cstrvec_size(&v)))
+        if (!cstrvec_eq_at(&w, i, cstrvec_at(&v, i))) { EXPECT_TRUE(false); break; }
+    fclose(fp);
+
+    fp = tmpfile();
+    EXPECT_TRUE(cstrvec_write_lines(&v, fp, '\n'));
+    rewind(fp);
+    cstrvec_clear(&w);
+    EXPECT_EQ(10000, cstrvec_append_lines(&w, fp, '\n'));
+    EXPECT_STREQ("row 0", cstrvec_str(&w, 0));
+    EXPECT_STREQ("row 9999", cstrvec_str(&w, 9999));
+    rewind(fp);
+    EXPECT_FALSE(cstrvec_load(&w, fp)); // not a saved cstrvec
+    EXPECT_EQ(10000, cstrvec_size(&w));  // unchanged
+    fclose(fp);
+
+    // corrupt headers: counts that overflow or exceed the file
+    const int64_t heads[][2] = {{((int64_t)1 << 61) + 4, INT64_MAX}, {4, 1 << 20}, {-1, 8}};
+    for (c_range(i, c_arraylen(heads))) {
+        fp = tmpfile();
+        fwrite("STCSVEC1", 1, 8, fp);
+        fwrite(heads[i], sizeof heads[i][0], 2, fp);
+        fwrite("\3abc\0\3def\0", 1, 10, fp);
+        rewind(fp);
+        EXPECT_FALSE(cstrvec_load(&w, fp));
+        EXPECT_EQ(10000, cstrvec_size(&w));
+        fclose(fp);
+    }
+    c_drop(cstrvec, &v, &w);
+}
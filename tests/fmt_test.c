@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include "stc/cstr.h"
+#include "c11/fmt.h"
+#include "ctest.h"
+
+static void write_cstr(void* ctx, const char* s, intptr_t n)
+    { cstr_append_n((cstr*)ctx, s, n); }
+
+TEST(fmt, buffer) {
+    cstr out = cstr_init(), ref = cstr_init();
+    char buf[64];
+    fmt_buffer fb = fmt_buffer_sink(write_cstr, &out, buf, c_sizeof buf);
+    for (c_range(i, 1000)) {
+        fmt_printd(&fb, "{:>6}|{:<8}|{:<5}|{:x}|{:.2f}|{:.3}|{}\n", (int)i, "left", (char)'c', (unsigned)i*977, i/7.0, "string", -(long long)i);
+        cstr_append_fmt(&ref, "%6d|%-8s|%-5c|%x|%.2f|%.3s|%lld\n", (int)i, "left", 'c', (unsigned)i*977, i/7.0, "string", -(long long)i);
+    }
+    EXPECT_TRUE(cstr_size(&out) < cstr_size(&ref)); // not flushed yet
+    fmt_flush(&fb);
+    EXPECT_TRUE(cstr_eq(&out, &ref));
+
+    // records larger than the buffer
+    cstr big = cstr_with_size(500, 'x');
+    cstr_clear(&out);
+    fmt_printd(&fb, "<{}>{:>70}\n", cstr_str(&big), 1);
+    fmt_close(&fb);
+    EXPECT_EQ(500 + 2 + 70 + 1, cstr_size(&out));
+    EXPECT_TRUE(cstr_starts_with(&out, "<xxx"));
+    EXPECT_EQ(501, cstr_find(&out, "> "));
+    EXPECT_TRUE(cstr_ends_with(&out, "   1\n"));
+    c_drop(cstr, &out, &ref, &big);
+}
+
+TEST(fmt, cached) {
+    cstr out = cstr_init();
+    fmt_buffer fb = fmt_buffer_sink(write_cstr, &out, NULL, 0);
+    for (c_range(i, 3))
+        fmt_cprintd(&fb, "{{{}}} {} {}%,", (int)i, "two", 3.5);
+    fmt_close(&fb);
+    EXPECT_STREQ("{0} two 3.5%,{1} two 3.5%,{2} two 3.5%,", cstr_str(&out));
+
+    fmt_stream ss[1] = {0};
+    for (c_range(i, 100))
+        fmt_cprintd(ss, "{},", (int)i);
+    EXPECT_EQ(290, ss->len);
+    EXPECT_TRUE(ss->cap < 2*ss->len);
+    fmt_close(ss);
+    cstr_drop(&out);
+}
+
+TEST(fmt, repeated_flags) {
+    cstr out = cstr_init();
+    char buf[16];
+    fmt_buffer fb = fmt_buffer_sink(write_cstr, &out, buf, c_sizeof buf);
+    fmt_printd(&fb, "[{:+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++5}]", 42);
+    fmt_printd(&fb, "[{:<+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#+#6.2f}]", 1.5);
+    fmt_close(&fb);
+    EXPECT_STREQ("[  +42][+1.50 ]", cstr_str(&out));
+    cstr_drop(&out);
+}
+
+TEST(fmt, fallback) { // conversions formatted by snprintf()
+    cstr out = cstr_init();
+    char buf[16], ref[64];
+    void* ptr = &out;
+    fmt_buffer fb = fmt_buffer_sink(write_cstr, &out, buf, c_sizeof buf);
+    fmt_printd(&fb, "{}|{:+}|{:e}", ptr, 5, 0.5);
+    fmt_close(&fb);
+    snprintf(ref, sizeof ref, "%p|%+d|%e", ptr, 5, 0.5);
+    EXPECT_STREQ(ref, cstr_str(&out));
+    cstr_drop(&out);
+}
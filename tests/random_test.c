@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include "stc/random.h"
+#include "ctest.h"
+
+TEST(random, fill) {
+    enum {N = 1000 + 5}; // not a multiple of the lane count
+    static uint64_t out[N];
+    static double real[N];
+    static uint32_t out32[N];
+    crand64 rng = crand64_from(12345), ref = rng, lane[_crand_LANES];
+    crand32 rng32 = crand32_from(12345), ref32 = rng32, lane32[_crand_LANES];
+
+    crand64_fill_r(&rng, 3, out, N);
+    crand32_fill_r(&rng32, 3, out32, N);
+    for (c_range(j, _crand_LANES)) {
+        lane[j] = crand64_from(crand64_uint_r(&ref, 3));
+        lane32[j] = crand32_from(crand32_uint_r(&ref32, 3));
+    }
+    for (c_range(i, N)) {
+        EXPECT_EQ(crand64_uint_r(&lane[i % _crand_LANES], 3), out[i]);
+        EXPECT_EQ(crand32_uint_r(&lane32[i % _crand_LANES], 3), out32[i]);
+    }
+    EXPECT_EQ(crand64_uint_r(&ref, 3), crand64_uint_r(&rng, 3));
+
+    rng = crand64_from(12345);
+    crand64_fill_real_r(&rng, 3, real, N);
+    for (c_range(i, N)) {
+        EXPECT_DOUBLE_EQ((double)(out[i] >> 11) * 0x1.0p-53, real[i]);
+    }
+    // short buffers use the scalar generator directly
+    rng = crand64_from(12345), ref = rng;
+    crand64_fill_r(&rng, 3, out, 7);
+    for (c_range(i, 7))
+        EXPECT_EQ(crand64_uint_r(&ref, 3), out[i]);
+}
+
+TEST(random, split) {
+    enum {T = 4, N = 64};
+    uint64_t a[T][N], b[N];
+    for (c_range(t, T)) {
+        crand64 rng = crand64_split(42, (uint64_t)t);
+        crand64_fill_r(&rng, crand64_stream((uint64_t)t), a[t], N);
+    }
+    crand64 rng = crand64_split(42, 2);
+    crand64_fill_r(&rng, crand64_stream(2), b, N);
+    EXPECT_TRUE(memcmp(a[2], b, sizeof b) == 0);
+    for (c_range(t, 1, T))
+        EXPECT_TRUE(memcmp(a[0], a[t], sizeof b) != 0);
+    EXPECT_EQ(1, crand64_stream(0));
+    EXPECT_EQ(7, crand64_stream(3));
+}
+
+TEST(random, ziggurat) {
+    enum {N = 400000};
+    crand64 rng = crand64_from(1234);
+    crand64_normal_dist nd = {.mean=2.0, .stddev=3.0};
+    crand64_exponential_dist ed = {.lambda=0.5};
+    double s1 = 0, s2 = 0, e1 = 0, e2 = 0;
+    isize below = 0, tail = 0;
+    for (c_range(N)) {
+        double x = crand64_normal_r(&rng, 1, &nd);
+        s1 += x, s2 += x*x, below += x < 2.0 - 3.0; // P(z < -1) = 0.158655
+        double y = crand64_exponential_r(&rng, 1, &ed);
+        e1 += y, e2 += y*y, tail += y > 16.0; // P(y > 8/lambda) = exp(-8) = 0.000335
+        EXPECT_TRUE(y >= 0.0);
+    }
+    EXPECT_NEAR(2.0, s1/N, 0.02);
+    EXPECT_NEAR(9.0, s2/N - (s1/N)*(s1/N), 0.1);
+    EXPECT_NEAR(0.158655, (double)below/N, 0.002);
+    EXPECT_NEAR(2.0, e1/N, 0.02);
+    EXPECT_NEAR(4.0, e2/N - (e1/N)*(e1/N), 0.1);
+    EXPECT_NEAR(0.000335, (double)tail/N, 0.0001);
+}
+
+TEST(random, discrete) {
+    enum {N = 400000};
+    const double weights[] = {1.0, 0.0, 3.0, 0.5, 10.0, 2.5};
+    isize hist[c_arraylen(weights)] = {0};
+    crand64 rng = crand64_from(1234);
+    crand64_discrete_dist d = crand64_make_discrete(weights, c_arraylen(weights));
+    EXPECT_EQ(c_arraylen(weights), d.size);
+
+    for (c_range(N))
+        ++hist[crand64_discrete_r(&rng, 1, &d)];
+    EXPECT_EQ(0, hist[1]);
+    for (c_range(i, c_arraylen(weights)))
+        EXPECT_NEAR(weights[i]/17.0, (double)hist[i]/N, 0.003);
+    crand64_discrete_drop(&d);
+
+    d = crand64_make_discrete(weights + 1, 1); // all zero weights
+    EXPECT_EQ(0, d.size);
+    crand64_discrete_drop(&d);
+}
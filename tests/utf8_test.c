@@ -0,0 +1,111 @@
+#include "stc/cstr.h"
+#include "stc/csview.h"
+#include "stc/cregex.h"
+#include "ctest.h"
+
+TEST(utf8, casemap) {
+    const uint32_t upper[] = {'A', 'Z', 0xC0, 0x100, 0x178, 0x391, 0x3A3, 0x410, 0x1E9E, 0x2C00, 0xFF21};
+    const uint32_t lower[] = {'a', 'z', 0xE0, 0x101, 0xFF,  0x3B1, 0x3C3, 0x430, 0xDF,   0x2C30, 0xFF41};
+    for (c_range(i, c_arraylen(upper))) {
+        EXPECT_EQ(lower[i], utf8_tolower(upper[i]));
+        EXPECT_EQ(lower[i], utf8_casefold(upper[i]));
+        EXPECT_TRUE(utf8_isupper(upper[i]));
+    }
+    for (c_range(i, c_arraylen(lower)))
+        if (lower[i] != 0xDF) EXPECT_EQ(upper[i], utf8_toupper(lower[i]));
+
+    EXPECT_EQ(0x3C3, utf8_casefold(0x3C2)); // final sigma folds, but is not uppercase
+    EXPECT_EQ(0x3C2, utf8_tolower(0x3C2));
+    EXPECT_EQ('s', utf8_casefold(0x17F));   // long s
+    EXPECT_EQ('@', utf8_tolower('@'));
+    EXPECT_EQ('[', utf8_toupper('['));
+    EXPECT_EQ(0x10400, utf8_tolower(0x10400)); // BMP only
+
+    cstr s = cstr_toupper("hello ÆØÅ σας world");
+    EXPECT_STREQ("HELLO ÆØÅ ΣΑΣ WORLD", cstr_str(&s));
+    cstr_take(&s, cstr_tolower(cstr_str(&s)));
+    EXPECT_STREQ("hello æøå σασ world", cstr_str(&s));
+    cstr_drop(&s);
+
+    EXPECT_EQ(0, utf8_icmp("Hello ÆØÅ", "hELLO æøå"));
+    EXPECT_TRUE(utf8_icmp("abc", "ABD") < 0);
+    EXPECT_TRUE(utf8_icmp("Ab", "a") > 0);
+    EXPECT_TRUE(csview_iequals(c_sv("ΣΑΣ"), "σας"));
+
+    csview m[1];
+    EXPECT_EQ(CREG_OK, cregex_match_aio("(?i)straße [α-ω]+", "STRAẞE ΣΑΣ", m));
+    EXPECT_EQ(CREG_NOMATCH, cregex_match_aio("(?i)strasse", "STRAẞE", m));
+}
+
+TEST(utf8, groups) {
+    csview m[2];
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Greek}+", "abc αβγ def", m));
+    EXPECT_TRUE(csview_equals(m[0], "αβγ"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Han}+", "日本語テキスト", m));
+    EXPECT_TRUE(csview_equals(m[0], "日本語"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Katakana}+", "日本語テキスト", m));
+    EXPECT_TRUE(csview_equals(m[0], "テキスト"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Sc}", "price: 20€", m));
+    EXPECT_TRUE(csview_equals(m[0], "€"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Nd}+", "x١٢٣y", m)); // arabic-indic digits
+    EXPECT_EQ(6, m[0].size);
+
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Alpha}+", "123 Ωmega 456", m));
+    EXPECT_TRUE(csview_equals(m[0], "Ωmega"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\b(\\w+)\\b", "-- Über_ñ1 --", m));
+    EXPECT_TRUE(csview_equals(m[1], "Über_ñ1"));
+    EXPECT_EQ(CREG_OK, cregex_match_aio("\\p{Zs}", "a　b", m)); // ideographic space
+    EXPECT_EQ(3, m[0].size);
+    EXPECT_EQ(CREG_NOMATCH, cregex_match_aio("\\p{Greek}", "\U00010140", m)); // only BMP ranges
+}
+
+TEST(utf8, valid_count) {
+    cstr s = cstr_init();
+    for (c_range(i, 100)) cstr_append(&s, "aé€😀"); // 10 bytes, 4 runes, spans many vector blocks
+    const char* str = cstr_str(&s);
+    EXPECT_TRUE(utf8_valid(str));
+    EXPECT_EQ(400, utf8_count(str));
+    EXPECT_EQ(400, csview_u8_size(cstr_sv(&s)));
+    EXPECT_EQ(4*55 + 2, utf8_count_n(str, 552));
+    EXPECT_EQ(10*77 + 1, utf8_at(str, 4*77 + 1) - str);
+    EXPECT_EQ(1000, utf8_at(str, 1000) - str); // stops at end
+    EXPECT_EQ(3, utf8_offset(str + 10*50, -2) - (str + 10*49));
+
+    char* p = (char*)cstr_data(&s);
+    EXPECT_FALSE(utf8_valid_n(str, 999));  // truncated 4-byte rune
+    p[781] = (char)0xC0;                   // overlong 2-byte lead
+    EXPECT_FALSE(utf8_valid(str));
+    p[780] = (char)0xED, p[781] = (char)0xA0; // surrogate
+    EXPECT_FALSE(utf8_valid(str));
+    EXPECT_TRUE(utf8_valid_n(str, 780));
+    cstr_drop(&s);
+
+    EXPECT_TRUE(utf8_valid("\xF4\x8F\xBF\xBF"));  // U+10FFFF
+    EXPECT_FALSE(utf8_valid("\xF4\x90\x80\x80")); // > U+10FFFF
+    EXPECT_FALSE(utf8_valid("\xE0\x9F\xBF"));     // overlong 3-byte
+    EXPECT_FALSE(utf8_valid("a\x80"));
+}
+
+TEST(utf8, index) {
+    cstr s = cstr_init();
+    for (c_range(i, 1000)) cstr_append(&s, i % 3 ? "æ€x" : "😀"); // runes 7*k: 😀
+    csview sv = cstr_sv(&s);
+    utf8_index ix = utf8_index_from(sv);
+    EXPECT_EQ(cstr_u8_size(&s), ix.u8size);
+
+    for (c_range(i, 0, ix.u8size + 3, 7)) {
+        EXPECT_TRUE(utf8_index_at(&ix, sv.buf, i) == utf8_at(sv.buf, i));
+        csview a = csview_u8_subview(sv, i, 300), b = csview_u8_subview_ix(sv, &ix, i, 300);
+        EXPECT_TRUE(a.buf == b.buf && a.size == b.size);
+    }
+    EXPECT_TRUE(csview_equals(cstr_u8_at_ix(&s, &ix, 1995).chr, "😀"));
+    EXPECT_TRUE(csview_equals(csview_u8_at_ix(sv, &ix, 1996).chr, "æ"));
+    EXPECT_TRUE(csview_equals(cstr_u8_subview_ix(&s, &ix, 1995, 3), "😀æ€"));
+    utf8_index_drop(&ix);
+
+    ix = utf8_index_from(c_sv(""));
+    EXPECT_EQ(0, ix.u8size);
+    EXPECT_EQ(0, csview_u8_subview_ix(c_sv(""), &ix, 5, 2).size);
+    utf8_index_drop(&ix);
+    cstr_drop(&s);
+}